@@ -130,7 +130,7 @@ int main(int argc, char** argv) {
         if(interrupt)
             break;
 
-        tree.Tree->GetEntry(entry);
+        tree.GetEntry(entry);
 
         // Fill hists
         TH3* h = nullptr;
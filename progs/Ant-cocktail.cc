@@ -2,10 +2,12 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <random>
 
 
 #include "mc/pluto/PlutoGenerator.h"
 #include "mc/pluto/utils/PlutoTID.h"
+#include "mc/pluto/utils/PlutoShards.h"
 
 #include "expconfig/ExpConfig.h"
 
@@ -16,6 +18,8 @@
 
 #include "detail/McAction.h"
 
+#include "TRandom.h"
+
 using namespace std;
 using namespace ant;
 using namespace ant::mc::pluto;
@@ -45,6 +49,8 @@ int main( int argc, char** argv )
 
     auto cmd_noTID      = cmd.add<TCLAP::SwitchArg>        ("",  "noTID",   "Don't add TID tree for the events",   false);
     auto cmd_verbose    = cmd.add<TCLAP::ValueArg<int>>    ("v", "verbose", "Verbosity level (0..9)",              false, 0, "int");
+    auto cmd_shards     = cmd.add<TCLAP::ValueArg<unsigned>>("", "shards", "Generate in parallel worker processes, merged afterwards", false, 1, "unsigned int");
+    auto cmd_seed       = cmd.add<TCLAP::ValueArg<unsigned long>>("", "seed", "Master seed for reproducible generation", false, 0, "unsigned int");
 
     cmd.parse(argc, argv);
 
@@ -87,27 +93,57 @@ int main( int argc, char** argv )
         return 1;
     }
 
-    // scope that the Cocktail output file is properly closed before adding TID tree
-    {
+    const unsigned nShards = cmd_shards->getValue();
+    const uint64_t masterSeed = cmd_seed->isSet() ? cmd_seed->getValue() : random_device()();
+    if(nShards > 1 || cmd_seed->isSet())
+        LOG(INFO) << "Using master seed " << masterSeed;
+
+    // the Cocktail output file is properly closed when sample returns, before adding TID tree
+    // gRandom and the Cocktail's own engine get independent seeds, zero means random
+    auto sample = [&] (const string& filename, unsigned long nEvents, unsigned seed, unsigned seed_gRandom) {
+        if(seed_gRandom != 0)
+            gRandom->SetSeed(seed_gRandom);
         auto selector = mc::data::Query::GetSelector(allowedTargets.at(cmd_target->getValue()));
-        Cocktail cocktail(outfile,
+        Cocktail cocktail(filename,
                           energies,
                           !cmd_noUnstable->isSet(),
                           !cmd_noBulk->isSet(),
                           cmd_verbose->getValue(),
                           "1.0 / x",
-                          selector);
+                          selector,
+                          seed);
 
-        auto nErrors = cocktail.Sample(cmd_numEvents->getValue());
+        auto nErrors = cocktail.Sample(nEvents);
 
         if(nErrors>0)
             LOG(WARNING) << "Events with error: " <<  nErrors;
+    };
+
+    using mc::pluto::utils::PlutoShards;
+    if(nShards > 1) {
+        try {
+            const auto shards = PlutoShards::MakeShards(nShards, masterSeed, cmd_numEvents->getValue(), outfile);
+            PlutoShards::Run(shards, [&sample, masterSeed] (const PlutoShards::shard_t& shard) {
+                sample(shard.Filename, shard.nEvents, shard.Seed, PlutoShards::GetSeed(masterSeed, shard.Index, 1));
+            });
+            PlutoShards::Merge(shards, outfile);
+        }
+        catch(const PlutoShards::Exception& e) {
+            LOG(ERROR) << "Sharded generation failed: " << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+    else {
+        const bool seeded = cmd_seed->isSet();
+        sample(outfile, cmd_numEvents->getValue(),
+               seeded ? PlutoShards::GetSeed(masterSeed, 0)    : 0,
+               seeded ? PlutoShards::GetSeed(masterSeed, 0, 1) : 0);
     }
 
     // add TID tree for the generated events
     if(!cmd_noTID->isSet()) {
         LOG(INFO) << "Add TID tree to the output file";
-        mc::pluto::utils::PlutoTID::AddTID(outfile);
+        mc::pluto::utils::PlutoTID::AddTID(outfile, cmd_seed->isSet() ? PlutoShards::GetSeed(masterSeed, nShards) : 0);
     }
 
     return EXIT_SUCCESS;
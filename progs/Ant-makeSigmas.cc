@@ -16,6 +16,7 @@
 #include "base/TH_ext.h"
 
 #include "TTree.h"
+#include "TROOT.h"
 #include "TRint.h"
 #include "TH3D.h"
 #include "TH2D.h"
@@ -23,11 +24,16 @@
 #include "TFitResult.h"
 #include "TCanvas.h"
 
+#include <atomic>
+#include <exception>
+#include <list>
+#include <thread>
+
 using namespace ant;
 using namespace std;
 using namespace ant::analysis;
 using namespace ant::std_ext;
-static volatile bool interrupt = false;
+static atomic<bool> interrupt{false};
 
 
 bool IsBinValid(const TH2D* hist, const int x, const int y) {
@@ -289,8 +295,80 @@ NewSigmas_t makeNewSigmas(const TH3D* pulls, const TH3D* sigmas,
     return result;
 }
 
+using pulltree_t = utils::PullsWriter<>::PullTree_t;
+
+/// \todo remove hardcoded number of parameters,
+/// use stuff from utils/Fitter.h instead?
+constexpr auto nParameters = 4;
+constexpr auto nParamShowerDepth = 3;
+
+/**
+ * @brief The PullHists_t struct bins all quantities of the pull tree in (cos #theta, E)
+ *
+ * All of them are filled in one pass over the tree. A pass may be split
+ * into several ranges of entries, each filling its own shard, which are added up afterwards.
+ */
+struct PullHists_t {
+    std::vector<TH3D*> Pulls;
+    std::vector<TH3D*> Sigmas;
+    TH3D* CB_R_TAPS_L    = nullptr;
+    TH3D* OldShowerDepth = nullptr;
+
+    void Fill(const pulltree_t& pulltree) const {
+        const auto cosTheta = cos(pulltree.Theta);
+        const double E = pulltree.E;
+        const double w = pulltree.TaggW;
+
+        for(auto n=0u;n<pulltree.Pulls().size();n++)
+            Pulls.at(n)->Fill(cosTheta, E, pulltree.Pulls().at(n), w);
 
+        for(auto n=0u;n<pulltree.Sigmas().size();n++)
+            Sigmas.at(n)->Fill(cosTheta, E, pulltree.Sigmas().at(n), w);
 
+        CB_R_TAPS_L->Fill(cosTheta, E, pulltree.Values().at(nParamShowerDepth), w);
+        OldShowerDepth->Fill(cosTheta, E, pulltree.ShowerDepth, w);
+    }
+
+    std::vector<TH3D*> All() const {
+        auto all = Pulls;
+        all.insert(all.end(), Sigmas.begin(), Sigmas.end());
+        all.push_back(CB_R_TAPS_L);
+        all.push_back(OldShowerDepth);
+        return all;
+    }
+};
+
+/**
+ * @brief The PullHistsShard_t struct reads the pull tree from its own file into empty copies of the histograms
+ */
+struct PullHistsShard_t {
+    WrapTFileInput Input;
+    pulltree_t PullTree;
+    PullHists_t Hists;
+    std::vector<std::unique_ptr<TH3D>> Owned;
+
+    PullHistsShard_t(const string& filename, const string& treename, const PullHists_t& hists) :
+        Input(filename)
+    {
+        if(!Input.GetObject(treename, PullTree.Tree))
+            throw std::runtime_error("Cannot find tree "+treename+" in "+filename);
+        PullTree.LinkBranches();
+
+        auto copy = [this] (const TH3D* h) {
+            auto c = static_cast<TH3D*>(h->Clone());
+            c->SetDirectory(nullptr);
+            c->Reset();
+            Owned.emplace_back(c);
+            return c;
+        };
+        for(auto h : hists.Pulls)
+            Hists.Pulls.push_back(copy(h));
+        for(auto h : hists.Sigmas)
+            Hists.Sigmas.push_back(copy(h));
+        Hists.CB_R_TAPS_L    = copy(hists.CB_R_TAPS_L);
+        Hists.OldShowerDepth = copy(hists.OldShowerDepth);
+    }
+};
 
 int main( int argc, char** argv )
 {
@@ -311,6 +389,7 @@ int main( int argc, char** argv )
     auto cmd_fitprob_cut  = cmd.add<TCLAP::ValueArg<double>>("", "fitprob_cut" ,"Min. required Fit Probability",                 false, 0.01,"probability");
     auto cmd_integral_cut = cmd.add<TCLAP::ValueArg<double>>("", "integral_cut","Min. required integral in Bins",                false, 100.0,"integral");
     auto cmd_show_plots   = cmd.add<TCLAP::MultiSwitchArg>  ("", "show_plots"  ,"Show detail plots for each parameter",          false);
+    auto cmd_threads      = cmd.add<TCLAP::ValueArg<unsigned>>("", "threads",  "Split reading the tree into ranges processed by this many threads", false, 1, "n");
 
     cmd.parse(argc, argv);
 
@@ -318,6 +397,9 @@ int main( int argc, char** argv )
     const auto integral_cut = cmd_integral_cut->getValue();
     const auto treename = cmd_tree->getValue();
     const auto show_plots = cmd_show_plots->isSet();
+    const unsigned nThreads = max(cmd_threads->getValue(), 1u);
+    if(nThreads > 1)
+        ROOT::EnableThreadSafety();
 
     WrapTFileInput input(cmd_input->getValue());
 
@@ -403,15 +485,10 @@ int main( int argc, char** argv )
     }
     HistogramFactory HistFac(hist_settings.name);
 
-    /// \todo remove hardcoded number of parameters,
-    /// use stuff from utils/Fitter.h instead?
-    constexpr auto nParameters = 4;
-    constexpr auto nParamShowerDepth = 3;
-
-
     // create 3D hists for pulls/sigmas
-    std::vector<TH3D*> h_pulls;
-    std::vector<TH3D*> h_sigmas;
+    PullHists_t hists;
+    auto& h_pulls  = hists.Pulls;
+    auto& h_sigmas = hists.Sigmas;
 
     for(auto n=0;n<nParameters;n++) {
         auto& label = hist_settings.labels.at(n);
@@ -432,12 +509,12 @@ int main( int argc, char** argv )
                                ));
     }
 
-    auto h_CB_R_TAPS_L = HistFac.makeTH3D("CB_R_TAPS_L","cos #theta","Ek","R_{CB}, L_{TAPS} / cm",
+    auto h_CB_R_TAPS_L = hists.CB_R_TAPS_L = HistFac.makeTH3D("CB_R_TAPS_L","cos #theta","Ek","R_{CB}, L_{TAPS} / cm",
                                           hist_settings.bins_cosTheta,
                                           hist_settings.bins_E,
                                           hist_settings.bins_CB_R_TAPS_L,
                                           "h_CB_R_TAPS_L");
-    auto h_OldShowerDepth = HistFac.makeTH3D("Old ShowerDepth","cos #theta","Ek","ShowerDepth / cm",
+    auto h_OldShowerDepth = hists.OldShowerDepth = HistFac.makeTH3D("Old ShowerDepth","cos #theta","Ek","ShowerDepth / cm",
                                              hist_settings.bins_cosTheta,
                                              hist_settings.bins_E,
                                              hist_settings.bins_ShowerDepth,
@@ -452,38 +529,69 @@ int main( int argc, char** argv )
         LOG(INFO) << "Running until " << max_entries;
     }
 
-    long long entry = 0;
+    atomic<long long> entry{0};
     ProgressCounter::Interval = 3;
     ProgressCounter progress(
                 [&entry, entries] (std::chrono::duration<double>) {
         LOG(INFO) << "Processed " << 100.0*entry/entries << " %";
     });
 
-    for(entry=0;entry<max_entries;entry++) {
-        if(interrupt)
-            break;
-
-        progress.Tick();
-        pulltree.Tree->GetEntry(entry);
-
-        if(pulltree.FitProb > fitprob_cut ) {
+    const auto process = [&entry, fitprob_cut] (pulltree_t& pulltree, const PullHists_t& hists,
+            long long begin, long long end, bool tick) {
+        for(auto e=begin;e<end;e++) {
+            if(interrupt)
+                break;
+            if(tick)
+                ProgressCounter::Tick();
+            pulltree.GetEntry(e);
+            if(pulltree.FitProb > fitprob_cut)
+                hists.Fill(pulltree);
+            ++entry;
+        }
+    };
 
-            for(auto n=0u;n<pulltree.Pulls().size();n++) {
-                h_pulls.at(n)->Fill(cos(pulltree.Theta), pulltree.E,
-                                    pulltree.Pulls().at(n), pulltree.TaggW);
+    // the main thread processes the first range, the shards the others,
+    // logging is not thread-safe, so errors are reported after joining
+    std::list<PullHistsShard_t> shards;
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(nThreads);
+    for(auto i=1u;i<nThreads;i++) {
+        shards.emplace_back(cmd_input->getValue(), cmd_tree->getValue(), hists);
+        auto& shard = shards.back();
+        threads.emplace_back([&shard, &errors, &process, i, nThreads, max_entries] () {
+            try {
+                process(shard.PullTree, shard.Hists, max_entries*i/nThreads, max_entries*(i+1)/nThreads, false);
             }
-
-            for(auto n=0u;n<pulltree.Sigmas().size();n++) {
-                h_sigmas.at(n)->Fill(cos(pulltree.Theta), pulltree.E,
-                                     pulltree.Sigmas().at(n), pulltree.TaggW);
+            catch(...) {
+                errors[i] = current_exception();
             }
+        });
+    }
+
+    process(pulltree, hists, 0, max_entries/nThreads, true);
 
-            h_CB_R_TAPS_L->Fill(cos(pulltree.Theta), pulltree.E,
-                                pulltree.Values().at(nParamShowerDepth), pulltree.TaggW);
-            h_OldShowerDepth->Fill(cos(pulltree.Theta), pulltree.E,
-                                   pulltree.ShowerDepth, pulltree.TaggW);
+    for(auto& t : threads)
+        t.join();
+    for(auto& error : errors) {
+        if(!error)
+            continue;
+        try {
+            rethrow_exception(error);
         }
+        catch(const exception& e) {
+            LOG(ERROR) << "Error while reading pull tree: " << e.what();
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    // the binned data is kept in memory for all following steps
+    for(const auto& shard : shards) {
+        const auto all = hists.All();
+        const auto shard_all = shard.Hists.All();
+        for(size_t i=0;i<all.size();i++)
+            all[i]->Add(shard_all[i]);
     }
+    shards.clear();
 
     argc=1; // prevent TRint to parse any cmdline except prog name
     auto app = cmd_batchmode->isSet() || !std_ext::system::isInteractive()
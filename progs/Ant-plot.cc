@@ -2,6 +2,7 @@
 #include "tclap/CmdLine.h"
 #include "tclap/ValuesConstraintExtra.h"
 #include "base/WrapTFile.h"
+#include "base/WrapTTree.h"
 #include "base/std_ext/string.h"
 #include "base/std_ext/system.h"
 #include "base/ProgressCounter.h"
@@ -10,19 +11,32 @@
 #include "tree/TAntHeader.h"
 #include "expconfig/ExpConfig.h"
 
+#include "TDirectory.h"
+#include "TROOT.h"
 #include "TSystem.h"
 #include "TRint.h"
 
+#include <atomic>
 #include <list>
+#include <thread>
 
 using namespace ant;
 using namespace ant::analysis;
 using namespace std;
 
 
+// a shard processes a range of entries in its own thread,
+// reading from its own input file into its own directory
+struct Plotter_shard {
+    unique_ptr<WrapTFileInput> input;
+    TDirectory* dir;
+    unique_ptr<Plotter> plotter;
+};
+
 struct Plotter_list_entry {
     unique_ptr<Plotter> plotter;
     long long entries;
+    vector<Plotter_shard> shards;
     Plotter_list_entry(unique_ptr<Plotter> p): plotter(std::move(p)), entries(plotter->GetNumEntries()) {}
 
     bool operator<(const Plotter_list_entry& other) const noexcept {
@@ -32,7 +46,7 @@ struct Plotter_list_entry {
 using plotter_list_t = std::list<Plotter_list_entry>;
 
 
-volatile static bool interrupt = false;
+static atomic<bool> interrupt{false};
 
 int main(int argc, char** argv) {
     SetupLogger();
@@ -57,11 +71,23 @@ int main(int argc, char** argv) {
 
     auto cmd_options = cmd.add<TCLAP::MultiArg<string>>("O","options","Options for all physics classes, key=value",false,"");
 
+    auto cmd_prune       = cmd.add<TCLAP::SwitchArg>("","prune","Stop reading branches the plotters never used in the first entries, each tree must be read by one plotter only",false);
+    auto cmd_unzipthread = cmd.add<TCLAP::SwitchArg>("","unzip_thread","Unzip the following baskets of the trees in a background thread",false);
+    auto cmd_threads     = cmd.add<TCLAP::ValueArg<unsigned>>("","threads","Split the entries of parallel plotters into ranges processed by this many threads",false,1,"n");
+
     cmd.parse(argc, argv);
     if(cmd_verbose->isSet()) {
         el::Loggers::setVerboseLevel(cmd_verbose->getValue());
     }
 
+    if(cmd_prune->isSet())
+        WrapTTree::PruningWarmup = 1000;
+    WrapTTree::ParallelUnzip = cmd_unzipthread->isSet();
+
+    const unsigned nThreads = max(cmd_threads->getValue(), 1u);
+    if(nThreads > 1)
+        ROOT::EnableThreadSafety();
+
     WrapTFileInput inputfile(cmd_input->getValue());
 
     // check if there's a previous AntHeader present,
@@ -90,6 +116,7 @@ int main(int argc, char** argv) {
     }
 
     plotter_list_t plotters;
+    plotter_list_t parallel_plotters;
     long long maxEntries = 0;
     {
         auto popts = make_shared<OptionsList>();
@@ -102,8 +129,24 @@ int main(int argc, char** argv) {
 
         for(const auto& plotter_name : cmd_plotters->getValue()) {
             try {
-                plotters.emplace_back(PlotterRegistry::Create(plotter_name, inputfile, popts));
-                maxEntries = max(maxEntries, plotters.back().entries);
+                Plotter_list_entry entry(PlotterRegistry::Create(plotter_name, inputfile, popts));
+                if(nThreads == 1 || !entry.plotter->IsParallel()) {
+                    maxEntries = max(maxEntries, entry.entries);
+                    plotters.emplace_back(move(entry));
+                    continue;
+                }
+
+                LOG(INFO) << "Running plotter " << plotter_name << " in " << nThreads << " threads";
+                for(unsigned i=0;i<nThreads;i++) {
+                    Plotter_shard shard;
+                    shard.input = std_ext::make_unique<WrapTFileInput>(cmd_input->getValue());
+                    shard.dir = gROOT->mkdir(string(std_ext::formatter() << "Ant-plot_shard_" << plotter_name << "_" << i).c_str());
+                    TDirectory::TContext context(shard.dir);
+                    shard.plotter = PlotterRegistry::Create(plotter_name, *shard.input, popts);
+                    shard.plotter->MakeShard();
+                    entry.shards.emplace_back(move(shard));
+                }
+                parallel_plotters.emplace_back(move(entry));
             } catch(const exception& e) {
                 LOG(ERROR) << "Could not create plotter \"" << plotter_name << "\": " << e.what();
                 return EXIT_FAILURE;
@@ -123,13 +166,21 @@ int main(int argc, char** argv) {
         maxEntries = min(maxEntries, static_cast<long long>(cmd_maxevents->getValue()));
     }
 
-    long long entry;
+    long long parallelEntries = 0;
+    for(auto& plotter : parallel_plotters) {
+        if(cmd_maxevents->isSet())
+            plotter.entries = min(plotter.entries, static_cast<long long>(cmd_maxevents->getValue()));
+        parallelEntries += plotter.entries;
+    }
+
+    long long entry = 0;
+    atomic<long long> parallelEntry{0};
 
     ProgressCounter progress(
-                [&entry, maxEntries]
+                [&entry, &parallelEntry, maxEntries, parallelEntries]
                 (std::chrono::duration<double> elapsed)
     {
-        const double percent = double(entry)/maxEntries;
+        const double percent = double(entry+parallelEntry)/(maxEntries+parallelEntries);
 
         static double last_PercentDone = 0;
         const double speed = (percent - last_PercentDone)/elapsed.count();
@@ -142,17 +193,39 @@ int main(int argc, char** argv) {
     if(std_ext::system::isInteractive())
         ProgressCounter::Interval = 3;
 
+    // each thread processes its range of entries of all parallel plotters with its shards,
+    // logging is not thread-safe, so errors are reported after joining
+    vector<thread> threads;
+    vector<exception_ptr> errors(nThreads);
+    atomic<unsigned> finishedThreads{0};
+    for(unsigned i=0;i<nThreads && !parallel_plotters.empty();i++) {
+        threads.emplace_back([i, nThreads, &parallel_plotters, &parallelEntry, &errors, &finishedThreads] () {
+            try {
+                for(auto& plotter : parallel_plotters) {
+                    const auto begin = plotter.entries*i/nThreads;
+                    const auto end   = plotter.entries*(i+1)/nThreads;
+                    auto& shard = *plotter.shards[i].plotter;
+                    for(auto e = begin; e < end && !interrupt; ++e) {
+                        shard.ProcessEntry(e);
+                        ++parallelEntry;
+                    }
+                }
+            }
+            catch(...) {
+                errors[i] = current_exception();
+            }
+            ++finishedThreads;
+        });
+    }
+
     plotters.sort(); // sort by max entries
 
     auto p = plotters.begin();
 
     const auto advp = [&p,&plotters] (const long long& i) {
-        while(i>=p->entries) {
+        while(p!=plotters.end() && i>=p->entries)
             ++p;
-            if(p==plotters.end())
-                return false;
-        }
-        return true;
+        return p!=plotters.end();
     };
 
     for(entry = 0; !interrupt && advp(entry) && entry < maxEntries; ++entry) {
@@ -167,9 +240,39 @@ int main(int argc, char** argv) {
             break;
     }
 
+    while(finishedThreads < threads.size()) {
+        this_thread::sleep_for(chrono::milliseconds(100));
+        ProgressCounter::Tick();
+    }
+    for(auto& t : threads)
+        t.join();
+
+    for(auto& error : errors) {
+        if(!error)
+            continue;
+        try {
+            rethrow_exception(error);
+        }
+        catch(const exception& e) {
+            LOG(ERROR) << "Error while running parallel plotter: " << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+
+    // the shards are merged into the plotter instance which has read the input file first
+    for(auto& plotter : parallel_plotters) {
+        for(auto& shard : plotter.shards) {
+            plotter.plotter->MergeShard(*shard.plotter);
+            shard.plotter = nullptr;
+            delete shard.dir;
+        }
+        plotter.shards.clear();
+    }
+
+    LOG(INFO) << "Analyzed " << entry+parallelEntry << " records"
+              << ", speed " << (entry+parallelEntry)/progress.GetTotalSecs() << " event/s";
 
-    LOG(INFO) << "Analyzed " << entry << " records"
-              << ", speed " << entry/progress.GetTotalSecs() << " event/s";
+    plotters.splice(plotters.end(), parallel_plotters);
 
     for(auto& plotter : plotters) {
         plotter.plotter->Finish();
@@ -16,6 +16,10 @@
   *
   *  To further decay the particles use --enableBulk. Then all instable particles
   *  decay according to the database.
+  *
+  * Parallel generation:
+  *  Run with --shards N to generate in N worker processes, which are merged afterwards.
+  *  Use --seed to make the generation reproducible.
   **/
 
 #include "tclap/CmdLine.h"
@@ -28,6 +32,7 @@
 #include "base/vec/vec3.h"
 #include "mc/pluto/PlutoExtensions.h"
 #include "mc/pluto/utils/PlutoTID.h"
+#include "mc/pluto/utils/PlutoShards.h"
 
 
 // pluto++
@@ -48,6 +53,7 @@
 
 #include <string>
 #include <memory>
+#include <random>
 
 using namespace std;
 using namespace ant;
@@ -91,6 +97,8 @@ int main( int argc, char** argv ) {
     auto cmd_Emax      = cmd.add<TCLAP::ValueArg<double>>    ("",  "Emax", "Maximal incident energy [MeV]", false, 1.6*GeV, "double [MeV]");
     auto cmd_noTID     = cmd.add<TCLAP::SwitchArg>           ("",  "noTID", "Don't add TID tree for the events", false);
     auto cmd_verbose   = cmd.add<TCLAP::ValueArg<int>>       ("v", "verbose","Verbosity level (0..9)", false, 0,"int");
+    auto cmd_shards    = cmd.add<TCLAP::ValueArg<unsigned>>  ("",  "shards", "Generate in parallel worker processes, merged afterwards", false, 1, "unsigned int");
+    auto cmd_seed      = cmd.add<TCLAP::ValueArg<unsigned long>>("", "seed", "Master seed for reproducible generation", false, 0, "unsigned int");
 
     // reaction simulation options
     auto cmd_reaction = cmd.add<TCLAP::ValueArg<string>> ("", "reaction", "Pseudo Beam - decay string (reaction string), e.g. 'p pi0 [g g]' for pion photoproduction", true, "", "g p decay string");
@@ -125,25 +133,55 @@ int main( int argc, char** argv ) {
     action.Emin    = cmd_Emin->getValue();
     action.Emax    = cmd_Emax->getValue();
 
+    string outfile = action.outfile;
+    if(!string_ends_with(outfile, ".root"))
+        outfile += ".root";
+
+    using mc::pluto::utils::PlutoShards;
+    const unsigned nShards = cmd_shards->getValue();
+    const uint64_t masterSeed = cmd_seed->isSet() ? cmd_seed->getValue() : random_device()();
+    if(nShards > 1 || cmd_seed->isSet())
+        LOG(INFO) << "Using master seed " << masterSeed;
+
     VLOG(2) << "gRandom is a " << gRandom->ClassName();
-    gRandom->SetSeed();
-    VLOG(2) << "gRandom initialized";
 
-    action.Run();
+    if(nShards > 1) {
+        try {
+            const auto shards = PlutoShards::MakeShards(nShards, masterSeed, action.nEvents, outfile);
+            PlutoShards::Run(shards, [&action] (const PlutoShards::shard_t& shard) {
+                gRandom->SetSeed(shard.Seed);
+                PlutoAction shard_action(action);
+                shard_action.nEvents = shard.nEvents;
+                shard_action.outfile = shard.Filename;
+                shard_action.Run();
+            });
+            PlutoShards::Merge(shards, outfile);
+        }
+        catch(const PlutoShards::Exception& e) {
+            LOG(ERROR) << "Sharded generation failed: " << e.what();
+            return EXIT_FAILURE;
+        }
+    }
+    else {
+        if(cmd_seed->isSet())
+            gRandom->SetSeed(PlutoShards::GetSeed(masterSeed, 0));
+        else
+            gRandom->SetSeed();
+        VLOG(2) << "gRandom initialized";
+
+        action.Run();
+    }
 
     LOG(INFO) << "Simulation finished.";
 
     // Do not delete the reaction, otherwise: infinite loop somewhere in ROOT...
     //delete reactrion;
 
-    // add TID tree for the generated events
+    // add TID tree for the generated events,
+    // done after merging to have consistent TIDs over all shards
     if(!cmd_noTID->isSet()) {
         LOG(INFO) << "Add TID tree to the output file";
-        string outfile = action.outfile;
-        if(!string_ends_with(outfile, ".root"))
-            outfile += ".root";
-
-        mc::pluto::utils::PlutoTID::AddTID(outfile);
+        mc::pluto::utils::PlutoTID::AddTID(outfile, cmd_seed->isSet() ? PlutoShards::GetSeed(masterSeed, nShards) : 0);
     }
 
     return EXIT_SUCCESS;
@@ -18,6 +18,7 @@
 #include "calibration/DataBase.h"
 
 #include "unpacker/Unpacker.h"
+#include "unpacker/UnpackerAcqu.h"
 #include "unpacker/RawFileReader.h"
 
 #include "reconstruct/Reconstruct.h"
@@ -32,12 +33,18 @@
 #include "base/std_ext/system.h"
 #include "base/std_ext/container.h"
 #include "base/GitInfo.h"
+#include "base/Instrumentation.h"
+
+#include "detail/RunQueue.h"
+#include "detail/RunCache.h"
 
 #include "TRint.h"
 #include "TSystem.h"
+#include "TROOT.h"
 
 #include <sstream>
 #include <string>
+#include <set>
 #include <csignal>
 
 using namespace std;
@@ -64,7 +71,7 @@ int main(int argc, char** argv) {
     TCLAP::CmdLine cmd("Ant", ' ', "0.1");
 
     auto cmd_verbose = cmd.add<TCLAP::ValueArg<int>>("v","verbose","Verbosity level (0..9)", false, 0,"int");
-    auto cmd_input  = cmd.add<TCLAP::MultiArg<string>>("i","input","Input files",true,"filename");
+    auto cmd_input  = cmd.add<TCLAP::MultiArg<string>>("i","input","Input files",false,"filename");
 
     TCLAP::ValuesConstraintExtra<decltype(ExpConfig::Setup::GetNames())> allowedsetupnames(ExpConfig::Setup::GetNames());
     auto cmd_setup  = cmd.add<TCLAP::ValueArg<string>>("s","setup","Choose setup manually by name",false,"", &allowedsetupnames);
@@ -85,13 +92,29 @@ int main(int argc, char** argv) {
     auto cmd_calibrations  = cmd.add<TCLAP::MultiArg<string>>("c","calibration","Calibration to run",false,"calibration");
 
     auto cmd_u_disablerecon  = cmd.add<TCLAP::SwitchArg>("","u_disablereconstruct","Unpacker: Disable Reconstruct (disables also all analysis)",false);
+    auto cmd_selection = cmd.add<TCLAP::ValueArg<string>>("","selection","Read only treeEvents matching expression on treeEventsIndex, e.g. 'nCandidates==3 && nNeutral==3'",false,"","expression");
+    auto cmd_lazy = cmd.add<TCLAP::ValueArg<string>>("","lazy","Keep the given treeEvents collections undecoded unless a physics class reads them, e.g. 'DetectorReadHits,SlowControls'",false,"","collections");
+    auto cmd_u_threads = cmd.add<TCLAP::ValueArg<unsigned>>("","u_threads","Unpacker: Number of threads decoding Acqu buffers in parallel, 0 unpacks sequentially",false,0,"n");
+    auto cmd_u_readhitscache = cmd.add<TCLAP::ValueArg<string>>("","u_readhitscache","Unpacker: Write read hits before/after calibration to file, use as input for fast recalibration",false,"","filename");
+
+    auto cmd_compression = cmd.add<TCLAP::ValueArg<string>>("","compression","Compression of output file as algorithm[:level], e.g. 'lz4:4' for intermediate files or 'lzma:8' for archives",false,"","spec");
+    auto cmd_writer_threads = cmd.add<TCLAP::ValueArg<unsigned>>("","writer_threads","Number of threads writing treeEvents and compressing output trees in background, 0 writes synchronously",false,0,"n");
 
     auto cmd_p_disableParticleID  = cmd.add<TCLAP::SwitchArg>("","p_disableParticleID","Physics: Disable ParticleID",false);
     auto cmd_p_simpleParticleID  = cmd.add<TCLAP::SwitchArg>("","p_simpleParticleID","Physics: Use simple ParticleID (just protons/photons)",false);
 
+    auto cmd_noInstrumentation  = cmd.add<TCLAP::SwitchArg>("","noInstrumentation","Disable timing and counting of processing stages",false);
+
+    auto cmd_runlist = cmd.add<TCLAP::ValueArg<string>>("","runlist","Process the runs listed in file in parallel workers and merge into output, one run per line (input files separated by spaces)",false,"","filename");
+    auto cmd_workers = cmd.add<TCLAP::ValueArg<unsigned>>("","workers","Number of worker processes for --runlist, default is number of CPUs",false,0,"n");
+    auto cmd_cache = cmd.add<TCLAP::ValueArg<string>>("","cache","Folder to keep the output of each run of --runlist, reused if inputs, arguments and calibration data did not change",false,"","folder");
+
 
 
     cmd.parse(argc, argv);
+    Instrumentation::Enabled = !cmd_noInstrumentation->isSet();
+    UnpackerAcqu::DecoderThreads = cmd_u_threads->getValue();
+    analysis::PhysicsManager::WriterThreads = cmd_writer_threads->getValue();
     if(cmd_verbose->isSet()) {
         el::Loggers::setVerboseLevel(cmd_verbose->getValue());
     }
@@ -103,8 +126,79 @@ int main(int argc, char** argv) {
     // enable caching of the calibration database
     ant::calibration::DataBase::OnDiskLayout::EnableCaching = true;
 
+    auto inputfiles = cmd_input->getValue();
+    auto outputfile = cmd_output->getValue();
+    bool batchmode  = cmd_batchmode->isSet();
+
+    // in driver mode, only the forked workers continue with their run
+    unique_ptr<progs::RunCache> runcache;
+    if(cmd_runlist->isSet()) {
+        if(cmd_input->isSet() || !cmd_output->isSet()) {
+            LOG(ERROR) << "Driver mode " << cmd_runlist->longID() << " needs " << cmd_output->longID()
+                       << " and takes the input files from the runlist only";
+            return EXIT_FAILURE;
+        }
+        unique_ptr<progs::RunQueue::run_t> run;
+        try {
+            progs::RunQueue queue(progs::RunQueue::ReadRunList(cmd_runlist->getValue()),
+                                  cmd_workers->getValue(), outputfile, addressof(interrupt));
+            run = queue.Process();
+            if(!run)
+                return queue.GetNFailed()==0 && !interrupt ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        catch(const progs::RunQueue::Exception& e) {
+            LOG(ERROR) << e.what();
+            return EXIT_FAILURE;
+        }
+        inputfiles = run->Inputs;
+        outputfile = run->Output;
+        batchmode  = true;
+        ProgressCounter::Interval = 0; // the driver reports the progress
+
+        if(cmd_cache->isSet()) {
+            // the arguments which do not change the output of a run
+            const set<string> ignored_values{"--runlist", "--workers", "--cache", "-o", "--output", "-v", "--verbose"};
+            const set<string> ignored_switches{"-b", "--batch"};
+            vector<string> args;
+            for(int i=1;i<argc;i++) {
+                const string arg(argv[i]);
+                if(ignored_values.count(arg)) {
+                    i++;
+                    continue;
+                }
+                // TCLAP also accepts the value given as --output=<file>
+                if(ignored_values.count(arg.substr(0, arg.find('='))))
+                    continue;
+                if(!ignored_switches.count(arg))
+                    args.emplace_back(arg);
+            }
+            try {
+                runcache = std_ext::make_unique<progs::RunCache>(cmd_cache->getValue(), inputfiles, args);
+            }
+            catch(const progs::RunCache::Exception& e) {
+                LOG(ERROR) << e.what();
+                return EXIT_FAILURE;
+            }
+        }
+    }
+    else if(cmd_cache->isSet()) {
+        LOG(ERROR) << cmd_cache->longID() << " can only be used with " << cmd_runlist->longID();
+        return EXIT_FAILURE;
+    }
+    else if(inputfiles.empty()) {
+        LOG(ERROR) << "Please specify input files with " << cmd_input->longID();
+        return EXIT_FAILURE;
+    }
+
+#ifdef R__USE_IMT
+    // further writer threads compress the baskets of the output trees in parallel,
+    // ROOT's implicit multi-threading is process-wide, so enable it only after forking the workers
+    if(cmd_writer_threads->getValue()>1)
+        ROOT::EnableImplicitMT(cmd_writer_threads->getValue()-1);
+#endif
+
     // check if input files are readable
-    for(const auto& inputfile : cmd_input->getValue()) {
+    for(const auto& inputfile : inputfiles) {
         string errmsg;
         if(!std_ext::system::testopen(inputfile, errmsg)) {
             LOG(ERROR) << "Cannot open inputfile '" << inputfile << "': " << errmsg;
@@ -124,7 +218,7 @@ int main(int argc, char** argv) {
 
     // build the list of ROOT files first
     auto rootfiles = make_shared<WrapTFileInput>();
-    for(const auto& inputfile : cmd_input->getValue()) {
+    for(const auto& inputfile : inputfiles) {
         VLOG(5) << "ROOT File Manager: Looking at file " << inputfile;
         try {
             rootfiles->OpenFile(inputfile);
@@ -156,7 +250,7 @@ int main(int argc, char** argv) {
 
     // now we can try to open the files with an unpacker
     std::unique_ptr<Unpacker::Module> unpacker = nullptr;
-    for(const auto& inputfile : cmd_input->getValue()) {
+    for(const auto& inputfile : inputfiles) {
         VLOG(5) << "Unpacker: Looking at file " << inputfile;
         try {
             auto unpacker_ = Unpacker::Get(inputfile);
@@ -197,12 +291,32 @@ int main(int argc, char** argv) {
                 LOG(WARNING) << "Cannot activate reconstruct without setup";
             }
         }
-        readers.push_back(std_ext::make_unique<analysis::input::AntReader>(
-                              rootfiles,
-                              move(unpacker),
-                              move(reconstruct)
-                              )
-                          );
+        auto antreader = std_ext::make_unique<analysis::input::AntReader>(
+                             rootfiles,
+                             move(unpacker),
+                             move(reconstruct)
+                             );
+        if(cmd_u_readhitscache->isSet())
+            antreader->WriteReadHitsCache(cmd_u_readhitscache->getValue());
+        if(cmd_selection->isSet()) {
+            try {
+                antreader->SetSelection(cmd_selection->getValue());
+            }
+            catch(analysis::input::AntReader::Exception e) {
+                LOG(ERROR) << "Cannot apply selection: " << e.what();
+                return EXIT_FAILURE;
+            }
+        }
+        if(cmd_lazy->isSet()) {
+            try {
+                antreader->SetLazyCollections(TEventData::GetCollections(cmd_lazy->getValue()));
+            }
+            catch(const exception& e) {
+                LOG(ERROR) << "Cannot set lazy collections: " << e.what();
+                return EXIT_FAILURE;
+            }
+        }
+        readers.push_back(move(antreader));
     }
     readers.push_back(std_ext::make_unique<analysis::input::PlutoReader>(rootfiles));
     readers.push_back(std_ext::make_unique<analysis::input::GoatReader>(rootfiles));
@@ -242,12 +356,33 @@ int main(int argc, char** argv) {
         return EXIT_FAILURE;
     }
 
+    // the setup is known now, so a cached output of this run can be checked
+    if(runcache) {
+        try {
+            if(runcache->Restore(outputfile))
+                return EXIT_SUCCESS;
+        }
+        catch(const progs::RunCache::Exception& e) {
+            LOG(WARNING) << "Cannot restore cached output, processing run: " << e.what();
+        }
+    }
+
     // the real output file, create it here to get all
     // further ROOT objects into this output file
     unique_ptr<WrapTFileOutput> masterFile;
-    if(cmd_output->isSet()) {
+    if(!outputfile.empty()) {
         // cd into masterFile upon creation
-        masterFile = std_ext::make_unique<WrapTFileOutput>(cmd_output->getValue(), true);
+        masterFile = std_ext::make_unique<WrapTFileOutput>(outputfile, true);
+        // before any physics class creates its trees
+        if(cmd_compression->isSet()) {
+            try {
+                masterFile->SetCompression(cmd_compression->getValue());
+            }
+            catch(const exception& e) {
+                LOG(ERROR) << "Cannot set compression: " << e.what();
+                return EXIT_FAILURE;
+            }
+        }
     }
 
     // add the physics/calibrationphysics modules
@@ -370,6 +505,14 @@ int main(int argc, char** argv) {
     pm.ReadFrom(move(readers), maxevents);
     rootfiles = nullptr; // cleanup opened ROOT files for reading
 
+    if(Instrumentation::Enabled) {
+        stringstream ss;
+        Instrumentation::PrintTable(ss);
+        LOG(INFO) << "Processing stages:\n" << ss.str();
+        if(masterFile)
+            Instrumentation::WriteHistograms(gDirectory);
+    }
+
     TAntHeader* header = new TAntHeader();
     gDirectory->Add(header);
     {
@@ -401,7 +544,17 @@ int main(int argc, char** argv) {
     if(terminated)
         return EXIT_FAILURE+1;
 
-    if(!cmd_batchmode->isSet()) {
+    if(runcache && !interrupt) {
+        masterFile = nullptr; // writes the output
+        try {
+            runcache->Store(outputfile, pm.GetProcessedTIDRange());
+        }
+        catch(const progs::RunCache::Exception& e) {
+            LOG(WARNING) << "Cannot store output in cache: " << e.what();
+        }
+    }
+
+    if(!batchmode) {
         if(!std_ext::system::isInteractive()) {
             LOG(INFO) << "No TTY attached. Not starting ROOT shell.";
         }
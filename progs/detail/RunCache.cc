@@ -0,0 +1,152 @@
+#include "RunCache.h"
+
+#include "calibration/DataManager.h"
+#include "expconfig/ExpConfig.h"
+#include "tree/TAntHeader.h"
+
+#include "base/GitInfo.h"
+#include "base/Logger.h"
+#include "base/WrapTFile.h"
+#include "base/std_ext/string.h"
+#include "base/std_ext/system.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+using namespace ant;
+using namespace ant::progs;
+
+RunCache::RunCache(const string& folder_, const vector<string>& inputs, const vector<string>& args) :
+    folder(folder_)
+{
+    calibration::Fingerprint hash;
+    for(const auto& input : inputs) {
+        struct stat st;
+        if(stat(input.c_str(), addressof(st)) != 0)
+            throw Exception("Cannot find input file "+input);
+        hash.add(std_ext::system::absolutePath(input));
+        hash.add(static_cast<std::uint64_t>(st.st_size));
+        hash.add(static_cast<std::int64_t>(st.st_mtime));
+    }
+    hash.add(args.size());
+    for(const auto& arg : args)
+        hash.add(arg);
+
+    GitInfo gitinfo;
+    if(gitinfo.IsDirty()) {
+        LOG(WARNING) << "Working copy of Ant has uncommitted changes, result cache disabled";
+        enabled = false;
+    }
+    hash.add(gitinfo.GetDescription());
+
+    key = hash.Value;
+}
+
+bool RunCache::Restore(const string& output) const
+{
+    if(!enabled)
+        return false;
+
+    const auto cached = GetFilename(".root");
+    ifstream fingerprintfile(GetFilename(".fingerprint"));
+    key_t fingerprint = 0;
+    if(!fingerprintfile || !(fingerprintfile >> hex >> fingerprint))
+        return false;
+
+    string setupname;
+    try {
+        setupname = ExpConfig::Setup::Get().GetName();
+    }
+    catch(ExpConfig::ExceptionNoSetup) {}
+
+    interval<TID> tidRange{TID(), TID()};
+    try {
+        WrapTFileInput cachedfile(cached);
+        TAntHeader* header = nullptr;
+        if(!cachedfile.GetObject("AntHeader", header))
+            return false;
+        if(header->SetupName != setupname) {
+            VLOG(3) << "Cached output " << cached << " was made with setup " << header->SetupName;
+            return false;
+        }
+        tidRange = {header->FirstID, header->LastID};
+    }
+    catch(const WrapTFile::Exception& e) {
+        LOG(WARNING) << "Cannot read cached output: " << e.what();
+        return false;
+    }
+
+    if(GetCalibrationFingerprint(tidRange) != fingerprint) {
+        VLOG(3) << "Calibration data changed since " << cached << " was made";
+        return false;
+    }
+
+    CopyFile(cached, output);
+    LOG(INFO) << "Restored output from " << cached;
+    return true;
+}
+
+void RunCache::Store(const string& output, const interval<TID>& tidRange) const
+{
+    if(!enabled)
+        return;
+
+    if(!std_ext::system::makeDirectories(folder))
+        throw Exception("Cannot create cache folder "+folder);
+
+    // workers of other Ant processes might use the same cache,
+    // so the files are only renamed when complete
+    const string tmpsuffix = std_ext::formatter() << ".tmp" << getpid();
+    const auto cached = GetFilename(".root");
+    CopyFile(output, cached+tmpsuffix);
+    if(rename((cached+tmpsuffix).c_str(), cached.c_str()) != 0)
+        throw Exception("Cannot move output to "+cached);
+
+    const auto fingerprintname = GetFilename(".fingerprint");
+    {
+        ofstream fingerprintfile(fingerprintname+tmpsuffix);
+        fingerprintfile << hex << GetCalibrationFingerprint(tidRange) << endl;
+        if(!fingerprintfile)
+            throw Exception("Cannot write "+fingerprintname+tmpsuffix);
+    }
+    if(rename((fingerprintname+tmpsuffix).c_str(), fingerprintname.c_str()) != 0)
+        throw Exception("Cannot move fingerprint to "+fingerprintname);
+
+    VLOG(3) << "Stored output in " << cached;
+}
+
+string RunCache::GetFilename(const string& extension) const
+{
+    return std_ext::formatter() << folder << "/" << hex << setw(16) << setfill('0') << key << extension;
+}
+
+RunCache::key_t RunCache::GetCalibrationFingerprint(const interval<TID>& tidRange)
+{
+    calibration::Fingerprint hash;
+    shared_ptr<calibration::DataManager> calmgr;
+    try {
+        calmgr = ExpConfig::Setup::Get().GetCalibrationDataManager();
+    }
+    catch(ExpConfig::ExceptionNoSetup) {}
+    if(!calmgr)
+        return hash.Value;
+
+    hash.add(calmgr->GetOverrideToDefault());
+    for(const auto& calibrationID : calmgr->GetCalibrationIDs())
+        hash.add(*calmgr, calibrationID, tidRange.Start(), tidRange.Stop());
+    return hash.Value;
+}
+
+void RunCache::CopyFile(const string& from, const string& to)
+{
+    ifstream src(from, ios::binary);
+    ofstream dst(to, ios::binary);
+    if(!src || !dst || !(dst << src.rdbuf()))
+        throw Exception("Cannot copy "+from+" to "+to);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "calibration/Fingerprint.h"
+#include "base/interval.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ant {
+namespace progs {
+
+/**
+ * @brief The RunCache class keeps the partial outputs of runs for incremental reprocessing
+ *
+ * A run is looked up by its key, built from the identity of the input files (path, size and
+ * modification time), the command line arguments determining the output and the git
+ * description of Ant. Along with the output, the fingerprint of all calibration data within
+ * the processed range of TIDs is stored, see calibration::Fingerprint. A cached output is
+ * only reused if this fingerprint did not change, so changing some calibration ranges only
+ * recomputes the runs they cover.
+ *
+ * Changes in uncommitted code are NOT detected, the cache is disabled for a dirty working copy.
+ */
+class RunCache {
+public:
+    using key_t = calibration::Fingerprint::value_t;
+
+    /**
+     * @param folder where the outputs are stored, created if needed
+     * @param inputs of the run
+     * @param args command line arguments determining the output, as name=value
+     */
+    RunCache(const std::string& folder, const std::vector<std::string>& inputs, const std::vector<std::string>& args);
+
+    /**
+     * @brief IsEnabled false if the key cannot be trusted
+     */
+    bool IsEnabled() const { return enabled; }
+
+    /**
+     * @brief Restore copies the cached output, if it was made with the current setup and calibration data
+     * @return true if output was restored, false if the run needs to be processed
+     */
+    bool Restore(const std::string& output) const;
+
+    /**
+     * @brief Store the output of the processed run in the cache
+     * @param tidRange the processed range of TIDs
+     */
+    void Store(const std::string& output, const interval<TID>& tidRange) const;
+
+    class Exception : public std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+
+protected:
+    const std::string folder;
+    bool enabled = true;
+    key_t key = 0;
+
+    std::string GetFilename(const std::string& extension) const;
+
+    static key_t GetCalibrationFingerprint(const interval<TID>& tidRange);
+    static void CopyFile(const std::string& from, const std::string& to);
+};
+
+}} // namespace ant::progs
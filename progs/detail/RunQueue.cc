@@ -0,0 +1,212 @@
+#include "RunQueue.h"
+
+#include "base/Logger.h"
+#include "base/std_ext/memory.h"
+#include "base/std_ext/string.h"
+
+#include "TFile.h"
+#include "TFileMerger.h"
+#include "TROOT.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+using namespace std;
+using namespace ant;
+using namespace ant::progs;
+
+namespace {
+
+using workers_t = map<pid_t, const RunQueue::run_t*>;
+
+// leaving Process() by an exception must not leave workers behind,
+// they are asked to stop early, as the final output is incomplete anyway
+struct workers_joiner_t {
+    workers_t& workers;
+    ~workers_joiner_t() {
+        if(workers.empty())
+            return;
+        LOG(WARNING) << "Stopping " << workers.size() << " running workers";
+        for(const auto& worker : workers)
+            kill(worker.first, SIGTERM);
+        for(const auto& worker : workers) {
+            while(waitpid(worker.first, nullptr, 0) < 0 && errno == EINTR) {}
+            remove(worker.second->Output.c_str());
+        }
+    }
+};
+
+}
+
+vector<RunQueue::run_t> RunQueue::ReadRunList(const string& filename)
+{
+    ifstream file(filename);
+    if(!file)
+        throw Exception("Cannot open runlist "+filename);
+
+    vector<run_t> runs;
+    string line;
+    while(getline(file, line)) {
+        stringstream ss(line);
+        run_t run;
+        string input;
+        while(ss >> input) {
+            if(run.Inputs.empty() && std_ext::string_starts_with(input, "#"))
+                break;
+            struct stat st;
+            if(stat(input.c_str(), addressof(st)) != 0)
+                throw Exception("Cannot find input file "+input+" listed in "+filename);
+            run.Inputs.emplace_back(input);
+            run.Size += st.st_size;
+        }
+        if(!run.Inputs.empty())
+            runs.emplace_back(move(run));
+    }
+    if(runs.empty())
+        throw Exception("No runs found in runlist "+filename);
+    return runs;
+}
+
+RunQueue::~RunQueue() = default;
+
+RunQueue::RunQueue(vector<run_t> runs_, unsigned nWorkers_, const string& output_, volatile bool* interrupt_) :
+    runs(move(runs_)),
+    nWorkers(nWorkers_ > 0 ? nWorkers_ : max(1l, sysconf(_SC_NPROCESSORS_ONLN))),
+    output(output_),
+    interrupt(interrupt_)
+{
+    string basename(output);
+    if(std_ext::string_ends_with(basename, ".root"))
+        basename = basename.substr(0, basename.size()-5);
+
+    for(size_t i=0;i<runs.size();i++) {
+        stringstream filename;
+        filename << basename << ".run" << setw(4) << setfill('0') << i << ".root";
+        runs[i].Output = filename.str();
+    }
+
+    // largest runs first, the small ones fill the gaps at the end
+    stable_sort(runs.begin(), runs.end(), [] (const run_t& a, const run_t& b) {
+        return a.Size > b.Size;
+    });
+}
+
+unique_ptr<RunQueue::run_t> RunQueue::Process()
+{
+    LOG(INFO) << "Processing " << runs.size() << " runs with " << nWorkers << " workers";
+
+    auto it_run = runs.begin();
+    workers_t workers;
+    workers_joiner_t joiner{workers};
+    string finished; // partial output to be merged
+
+    auto interrupted = [this] () {
+        return interrupt != nullptr && *interrupt;
+    };
+
+    while(true) {
+        // fill the free worker slots
+        while(it_run != runs.end() && workers.size() < nWorkers && !interrupted()) {
+            // avoid duplicate output of buffered streams in the workers
+            fflush(nullptr);
+            const pid_t pid = fork();
+            if(pid < 0)
+                throw Exception("Cannot fork worker process");
+            if(pid == 0) {
+                // the other workers belong to the driver process
+                workers.clear();
+                // so does the output kept open by the merger, which must neither be
+                // closed by the merger's destructor nor by ROOT at exit, as both write to it
+                if(merger) {
+                    gROOT->GetListOfFiles()->Remove(merger->GetOutputFile());
+                    merger.release();
+                }
+                return std_ext::make_unique<run_t>(*it_run);
+            }
+            VLOG(3) << "Started worker " << pid << " for " << it_run->Output;
+            workers.emplace(pid, addressof(*it_run));
+            ++it_run;
+        }
+
+        // merge while the workers are busy
+        if(!finished.empty()) {
+            Merge(finished);
+            finished.clear();
+            LOG(INFO) << nMerged << " of " << runs.size() << " runs finished";
+        }
+
+        if(workers.empty())
+            break;
+
+        int status = 0;
+        const pid_t pid = waitpid(-1, addressof(status), 0);
+        if(pid < 0) {
+            if(errno == EINTR)
+                continue; // interrupted, the workers get the signal as well
+            throw Exception("Waiting for worker processes failed");
+        }
+        auto it_worker = workers.find(pid);
+        if(it_worker == workers.end())
+            continue;
+        const auto& run = *it_worker->second;
+        workers.erase(it_worker);
+
+        if(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS) {
+            finished = run.Output;
+        }
+        else {
+            LOG(ERROR) << "Run with input " << run.Inputs.front() << " failed, see log above";
+            nFailed++;
+            remove(run.Output.c_str());
+        }
+    }
+
+    // closes the output
+    merger = nullptr;
+
+    if(it_run != runs.end())
+        LOG(WARNING) << "Interrupted, " << distance(it_run, runs.end()) << " runs not processed";
+    if(nFailed>0)
+        LOG(ERROR) << nFailed << " of " << runs.size() << " runs failed";
+    LOG(INFO) << "Merged " << nMerged << " runs into " << output;
+    return nullptr;
+}
+
+void RunQueue::Merge(const string& partial)
+{
+    if(nMerged == 0) {
+        // first finished run simply becomes the output
+        if(rename(partial.c_str(), output.c_str()) != 0)
+            throw Exception("Cannot move "+partial+" to "+output);
+        nMerged++;
+        return;
+    }
+
+    if(!merger) {
+        merger = std_ext::make_unique<TFileMerger>(kFALSE, kFALSE);
+        merger->SetMsgPrefix("RunQueue");
+        merger->SetPrintLevel(0);
+        if(!merger->OutputFile(output.c_str(), "UPDATE"))
+            throw Exception("Cannot open output file "+output);
+    }
+
+    // the added file is merged into the already open output, and dropped from the merger afterwards
+    if(!merger->AddFile(partial.c_str(), kFALSE))
+        throw Exception("Cannot add partial output "+partial);
+    if(!merger->PartialMerge(TFileMerger::kIncremental | TFileMerger::kAll))
+        throw Exception("Merging "+partial+" into "+output+" failed");
+    remove(partial.c_str());
+    nMerged++;
+}
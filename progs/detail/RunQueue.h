@@ -0,0 +1,68 @@
+#pragma once
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class TFileMerger;
+
+namespace ant {
+namespace progs {
+
+/**
+ * @brief The RunQueue class processes a list of runs in parallel worker processes
+ *
+ * Each run is processed in its own forked process, writing a partial output file.
+ * Whenever a worker finishes, the next run is taken from the queue, which is sorted by size
+ * with the largest runs first, so that a few huge runs do not dominate the tail.
+ * The partial outputs are merged incrementally into the final output as soon as the workers finish.
+ */
+class RunQueue {
+public:
+    struct run_t {
+        std::vector<std::string> Inputs;
+        std::string              Output; // partial output, set by RunQueue
+        unsigned long long       Size = 0;
+    };
+
+    /**
+     * @brief ReadRunList parses one run per line, several input files of one run are separated by spaces
+     * @note empty lines and lines starting with # are ignored
+     */
+    static std::vector<run_t> ReadRunList(const std::string& filename);
+
+    RunQueue(std::vector<run_t> runs_, unsigned nWorkers_, const std::string& output_,
+             volatile bool* interrupt_ = nullptr);
+    ~RunQueue();
+
+    /**
+     * @brief Process forks the workers and waits for them to finish
+     * @return in a worker process, the run to be processed, nullptr in the driver process when all runs are done
+     * @throws Exception if forking or merging fails, the running workers are stopped and waited for then
+     */
+    std::unique_ptr<run_t> Process();
+
+    unsigned GetNFailed() const { return nFailed; }
+
+    class Exception : public std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+
+protected:
+    std::vector<run_t> runs;
+    const unsigned nWorkers;
+    const std::string output;
+    volatile bool* interrupt;
+
+    unsigned nFailed = 0;
+    unsigned nMerged = 0;
+
+    // keeps the output open in UPDATE mode, each partial output is added to it,
+    // forked workers drop it without closing
+    std::unique_ptr<TFileMerger> merger;
+
+    void Merge(const std::string& partial);
+};
+
+}} // namespace ant::progs
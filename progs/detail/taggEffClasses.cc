@@ -74,7 +74,7 @@ treeLoader_t::treeLoader_t(const string& filename):
     ExpConfig::Setup::SetByName(setupName);
     nchannels = ExpConfig::Setup::GetDetector<TaggerDetector_t>()->GetNChannels();
 
-    wrapTree.Tree->GetEntry(0);
+    wrapTree.GetEntry(0);
     startTime = wrapTree.EvID().Timestamp;
 }
 
@@ -95,7 +95,7 @@ treeLoader_t::means_t treeLoader_t::getMeans() const
 
     for (auto entry = 0 ; entry < nentries ; ++entry)
     {
-        wrapTree.Tree->GetEntry(entry);
+        wrapTree.GetEntry(entry);
         for ( auto channel = 0u ; channel < nchannels; ++channel)
         {
             rms_scalers.at(channel).Add(1.0 * wrapTree.TaggRates().at(channel));
@@ -242,7 +242,7 @@ const taggEff_t taggEffTriple_t::GetTaggEffSubtracted() const
 
     for (auto entry = 0 ; entry < nentries ; ++entry)
     {
-        Run.wrapTree.Tree->GetEntry(entry);
+        Run.wrapTree.GetEntry(entry);
         time += Run.wrapTree.Clock() / 1.0e6;
 
         std_ext::RMS graphScaler;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "event_t.h"
+#include "Prefilter.h"
 
 namespace ant {
 namespace analysis {
@@ -28,6 +29,12 @@ public:
     virtual bool IsSource() =0;
     virtual bool ReadNextEvent(event_t& event) =0;
 
+    /**
+     * @brief SetPrefilter installs a filter which is evaluated before an event is reconstructed
+     * @note readers not running the reconstruction ignore it
+     */
+    virtual void SetPrefilter(prefilter_t) {}
+
     virtual double PercentDone() const =0;
 };
 
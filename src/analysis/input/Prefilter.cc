@@ -0,0 +1,29 @@
+#include "Prefilter.h"
+
+#include "base/std_ext/memory.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+unsigned PrefilterEvent::GetMultiplicity(const Detector_t::Any_t& detectors,
+                                         Channel_t::Type_t channelType) const
+{
+    if(!multiplicities) {
+        multiplicities = std_ext::make_unique<multiplicities_t>();
+        multiplicities->fill(0);
+        for(const TDetectorReadHit& readhit : recon.DetectorReadHits) {
+            const auto i = static_cast<unsigned>(readhit.DetectorType)*Channel_t::NTypes
+                           + static_cast<unsigned>(readhit.ChannelType);
+            (*multiplicities)[i]++;
+        }
+    }
+
+    unsigned n = 0;
+    for(unsigned d=0;d<Detector_t::NTypes;d++) {
+        if(!detectors.test(static_cast<Detector_t::Type_t>(d)))
+            continue;
+        n += (*multiplicities)[d*Channel_t::NTypes + static_cast<unsigned>(channelType)];
+    }
+    return n;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "tree/TEventData.h"
+#include "base/Detector_t.h"
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ant {
+namespace analysis {
+namespace input {
+
+/**
+ * @brief The PrefilterEvent class gives cheap access to an event before it is reconstructed
+ *
+ * Only the unpacked information is available: the ID, the trigger info and the detector
+ * read hits. For data, the read hits are not calibrated yet, so decisions should be based
+ * on multiplicities or raw values. The multiplicities are counted on first request.
+ */
+class PrefilterEvent {
+public:
+    explicit PrefilterEvent(const TEventData& recon_) :
+        recon(recon_)
+    {}
+
+    const TID& GetID() const { return recon.ID; }
+    const TTrigger& GetTrigger() const { return recon.Trigger; }
+    const std::vector<TDetectorReadHit>& GetReadHits() const { return recon.DetectorReadHits; }
+
+    bool IsMC() const { return recon.ID.isSet(TID::Flags_t::MC); }
+
+    /**
+     * @brief GetMultiplicity counts the read hits of given detectors and channel type
+     * @return the number of read hits, which is an upper limit for the number of hit elements
+     */
+    unsigned GetMultiplicity(const Detector_t::Any_t& detectors, Channel_t::Type_t channelType) const;
+
+protected:
+    const TEventData& recon;
+
+    using multiplicities_t = std::array<unsigned, Detector_t::NTypes*Channel_t::NTypes>;
+    mutable std::unique_ptr<multiplicities_t> multiplicities;
+};
+
+/**
+ * @brief prefilter_t returns false if an event can be rejected before reconstruction
+ */
+using prefilter_t = std::function<bool(const PrefilterEvent&)>;
+
+}}} // namespace ant::analysis::input
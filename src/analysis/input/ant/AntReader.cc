@@ -2,14 +2,22 @@
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
+#include "reconstruct/ReconstructReplay.h"
+#include "calibration/Calibration.h"
+#include "EventIndex.h"
 
 #include "base/Logger.h"
 #include "base/WrapTTree.h"
+#include "base/Instrumentation.h"
+#include "base/std_ext/string.h"
 
 #include "TTree.h"
+#include "TTreeFormula.h"
+#include "TBranch.h"
 
 #include <memory>
 #include <stdexcept>
+#include <typeinfo>
 
 using namespace std;
 using namespace ant;
@@ -29,7 +37,8 @@ struct AntReaderInternal {
 
 struct UnpackerReader : AntReaderInternal {
     UnpackerReader(unique_ptr<Unpacker::Module> unpacker_) :
-        unpacker(move(unpacker_))
+        unpacker(move(unpacker_)),
+        stage(Instrumentation::GetStage("Input/Unpacker"))
     {
         LOG(INFO) << "Reading events from unpacker";
     }
@@ -37,51 +46,160 @@ struct UnpackerReader : AntReaderInternal {
         return unpacker->PercentDone();
     }
     virtual event_t NextEvent() override {
+        Instrumentation::ScopedTimer t(stage);
         return event_t{unpacker->NextEvent()};
     }
 private:
     unique_ptr<Unpacker::Module> unpacker;
+    const Instrumentation::stage_t stage;
 }; // UnpackerReader
 
 
 struct TreeReader : AntReaderInternal {
-    TreeReader(const std::shared_ptr<WrapTFileInput>& rootfiles)
+    TreeReader(const std::shared_ptr<WrapTFileInput>& rootfiles) :
+        stage(Instrumentation::GetStage("Input/TreeEvents"))
     {
         if(!rootfiles->GetObject("treeEvents", tree.Tree))
             return;
 
         VLOG(5) << "Found Ant Events Tree";
         tree.LinkBranches();
+
+        rootfiles->GetObject(EventIndex::TreeName, index);
     }
 
     virtual ~TreeReader() = default;
 
     virtual double PercentDone() const override {
-        if(tree)
-            return double(current_entry)/double(tree.Tree->GetEntries());
-        return numeric_limits<double>::quiet_NaN();
+        if(!tree)
+            return numeric_limits<double>::quiet_NaN();
+        if(selected)
+            return selected->empty() ? 1.0 : double(current_selected)/double(selected->size());
+        return double(current_entry)/double(tree.Tree->GetEntries());
     }
 
     virtual event_t NextEvent() override {
         if(!tree)
             return {};
 
-        if(current_entry==tree.Tree->GetEntries())
+        if(selected) {
+            if(current_selected == selected->size())
+                return {};
+            current_entry = (*selected)[current_selected++];
+        }
+        else if(current_entry==tree.Tree->GetEntries())
             return {};
 
-        tree.Tree->GetEntry(current_entry);
+        Instrumentation::ScopedTimer t(stage);
+        const auto prevLazy = TEventData::LazyCollections;
+        TEventData::LazyCollections = lazy;
+        const auto nBytes = tree.GetEntry(current_entry);
+        TEventData::LazyCollections = prevLazy;
+        if(nBytes>0)
+            Instrumentation::Count(stage, nBytes);
         current_entry++;
-        return event_t{move(tree.data())};
+
+        event_t event{move(tree.data())};
+        // slow control processors need the full event
+        if(event.SavedForSlowControls && lazy) {
+            if(event.HasReconstructed())
+                event.Reconstructed().Decode();
+            if(event.HasMCTrue())
+                event.MCTrue().Decode();
+        }
+        return event;
     }
 
+    void Select(const string& expression) {
+        if(!tree)
+            throw AntReader::Exception("No treeEvents found to apply selection to");
+        if(index == nullptr)
+            throw AntReader::Exception(std_ext::formatter() << "No " << EventIndex::TreeName << " found, cannot apply selection");
+        if(index->GetEntries() != tree.Tree->GetEntries())
+            throw AntReader::Exception(std_ext::formatter() << EventIndex::TreeName << " does not match treeEvents");
+
+        // only the branches used in the expression are read
+        TTreeFormula formula("selection", expression.c_str(), index);
+        if(formula.GetNdim() == 0)
+            throw AntReader::Exception("Cannot parse selection '"+expression+"'");
+        auto isSavedForSlowControls = index->GetBranch("SavedForSlowControls");
+        bool savedForSlowControls = false;
+        isSavedForSlowControls->SetAddress(addressof(savedForSlowControls));
+
+        selected = std_ext::make_unique<vector<Long64_t>>();
+        for(Long64_t entry=0;entry<index->GetEntries();entry++) {
+            const auto local = index->LoadTree(entry);
+            isSavedForSlowControls->GetEntry(local);
+            formula.GetNdata();
+            // events for slow controls are needed to process the others correctly
+            if(savedForSlowControls || formula.EvalInstance() != 0)
+                selected->push_back(entry);
+        }
+        isSavedForSlowControls->ResetAddress();
+
+        LOG(INFO) << "Selected " << selected->size() << " of " << index->GetEntries()
+                  << " treeEvents with '" << expression << "'";
+    }
+
+    TEventData::collections_t lazy;
+
 private:
     Long64_t current_entry = 0;
+    const Instrumentation::stage_t stage;
     struct EventTree_t : WrapTTree {
         ADD_BRANCH_T(TEvent, data)
     };
     EventTree_t tree;
+
+    TTree* index = nullptr;
+    std::unique_ptr<std::vector<Long64_t>> selected; // all entries if null
+    size_t current_selected = 0;
 }; // TreeReader
 
+
+struct CacheReader : AntReaderInternal {
+    CacheReader(const std::shared_ptr<WrapTFileInput>& rootfiles) :
+        cache(*rootfiles),
+        stage(Instrumentation::GetStage("Input/ReadHitsCache"))
+    {}
+
+    virtual double PercentDone() const override {
+        return cache.PercentDone();
+    }
+
+    virtual event_t NextEvent() override {
+        Instrumentation::ScopedTimer t(stage);
+        if(replay)
+            return event_t{cache.NextEvent([this] (Detector_t::Type_t d, Channel_t::Type_t c) {
+                return replay->IsDirty(d, c);
+            })};
+        return event_t{cache.NextEvent({})};
+    }
+
+    // replaces the given reconstruct, if any, keeping its setup, clustering and candidate builder
+    void MakeReplay(std::unique_ptr<Reconstruct_traits>& reconstruct) {
+        if(!reconstruct)
+            return;
+        // derived classes may change the reconstruction in ways the replay does not know about
+        auto base = dynamic_cast<Reconstruct*>(reconstruct.get());
+        if(base == nullptr || typeid(*base) != typeid(Reconstruct))
+            throw AntReader::Exception("Read hits cache can only be replayed with a plain ant::Reconstruct");
+        auto replay_ = std_ext::make_unique<reconstruct::ReconstructReplay>(
+                           [this] (const ReconstructHook::DetectorReadHits& hook) {
+            auto module = dynamic_cast<const Calibration::BaseModule*>(addressof(hook));
+            return module != nullptr && cache.IsChanged(module->GetName());
+        }, move(*base));
+        LOG(INFO) << "Replaying " << replay_->GetNRerunHooks() << " read hit hooks from cache";
+        replay = replay_.get();
+        reconstruct = move(replay_);
+    }
+
+    ReadHitsCache::Reader cache;
+private:
+    const reconstruct::ReconstructReplay* replay = nullptr;
+    const Instrumentation::stage_t stage;
+}; // CacheReader
+
 }}}} // namespace ant::analysis::input::detail
 
 
@@ -98,6 +216,13 @@ AntReader::AntReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
             LOG(WARNING) << "Reconstruct disabled although reading from unpacker. Producing DetectorReadHits only.";
     }
     else {
+        // try read hits cache first, which needs a special reconstruct
+        auto cachereader = std_ext::make_unique<detail::CacheReader>(rootfiles);
+        if(cachereader->cache) {
+            cachereader->MakeReplay(reconstruct);
+            reader = move(cachereader);
+            return;
+        }
         // try root files
         auto treereader = std_ext::make_unique<detail::TreeReader>(rootfiles);
         if(isfinite(treereader->PercentDone()))
@@ -108,6 +233,36 @@ AntReader::AntReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
 
 AntReader::~AntReader() {}
 
+void AntReader::WriteReadHitsCache(const string& filename)
+{
+    if(!dynamic_cast<detail::UnpackerReader*>(reader.get()) || !reconstruct) {
+        LOG(WARNING) << "Read hits cache can only be written when reconstructing from unpacker";
+        return;
+    }
+    cachewriter = std_ext::make_unique<ReadHitsCache::Writer>(filename);
+}
+
+void AntReader::SetSelection(const string& expression)
+{
+    auto treereader = dynamic_cast<detail::TreeReader*>(reader.get());
+    if(!treereader)
+        throw Exception("Selection only possible when reading treeEvents");
+    treereader->Select(expression);
+}
+
+void AntReader::SetLazyCollections(const TEventData::collections_t& collections)
+{
+    auto treereader = dynamic_cast<detail::TreeReader*>(reader.get());
+    if(!treereader)
+        throw Exception("Lazy collections only possible when reading treeEvents");
+    treereader->lazy = collections;
+}
+
+void AntReader::SetPrefilter(prefilter_t prefilter_)
+{
+    prefilter = move(prefilter_);
+}
+
 bool AntReader::IsSource() {
     return reader != nullptr;
 }
@@ -132,8 +287,29 @@ bool AntReader::ReadNextEvent(event_t& event)
             TEventData& recon = nextevent.Reconstructed();
             /// \todo improve check if TEvent was run through reconstructed
             /// you may also introduce some flag to force application?
-            if(recon.Clusters.empty())
-                reconstruct->DoReconstruct(recon);
+            if(recon.IsDecoded(TEventData::Collection_t::Candidates) && recon.Clusters.empty()) {
+                // reconstruction starts from the read hits
+                recon.Decode(TEventData::Collection_t::DetectorReadHits);
+                // the cache must contain all events, so don't prefilter when writing it
+                if(prefilter && !cachewriter) {
+                    static const auto stage = Instrumentation::GetStage("Prefilter");
+                    Instrumentation::ScopedTimer t(stage);
+                    nextevent.Prefiltered = !prefilter(PrefilterEvent(recon));
+                    if(nextevent.Prefiltered)
+                        Instrumentation::Count(stage, 1);
+                }
+                if(!nextevent.Prefiltered) {
+                    if(cachewriter)
+                        cachewriter->Prepare(nextevent);
+                    {
+                        static const auto stage = Instrumentation::GetStage("Reconstruct");
+                        Instrumentation::ScopedTimer t(stage);
+                        reconstruct->DoReconstruct(recon);
+                    }
+                    if(cachewriter)
+                        cachewriter->Fill(recon);
+                }
+            }
         }
 
         // pay attention that Geant unpacker might also set MCTrue branch partly
@@ -143,6 +319,10 @@ bool AntReader::ReadNextEvent(event_t& event)
     }
 
     reader = nullptr;
+    if(cachewriter) {
+        cachewriter->Finish();
+        cachewriter = nullptr;
+    }
     return false;
 }
 
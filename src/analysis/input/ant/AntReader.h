@@ -1,13 +1,16 @@
 #pragma once
 
 #include "analysis/input/DataReader.h"
+#include "ReadHitsCache.h"
 
 #include "unpacker/Unpacker.h"
 #include "reconstruct/Reconstruct_traits.h"
+#include "tree/TEventData.h"
 #include "base/WrapTFile.h"
 
 #include <memory>
 #include <string>
+#include <stdexcept>
 
 namespace ant {
 namespace analysis {
@@ -22,6 +25,8 @@ class AntReader : public DataReader {
 protected:
     std::unique_ptr<detail::AntReaderInternal> reader;
     std::unique_ptr<Reconstruct_traits>        reconstruct;
+    std::unique_ptr<ReadHitsCache::Writer>     cachewriter;
+    prefilter_t                                prefilter;
 
 public:
     AntReader(const std::shared_ptr<WrapTFileInput>& rootfiles,
@@ -31,9 +36,35 @@ public:
     AntReader(const AntReader&) = delete;
     AntReader& operator= (const AntReader&) = delete;
 
+    /**
+     * @brief WriteReadHitsCache stores the events before and after calibration of the read hits
+     * @param filename the cache file, which can be used as input later on
+     * @note only effective when reading from unpacker with reconstruct enabled
+     */
+    void WriteReadHitsCache(const std::string& filename);
+
+    /**
+     * @brief SetSelection reads only the treeEvents matching the expression
+     * @param expression in TTree::Draw syntax, evaluated on the branches of EventIndex
+     * @note events saved for slow controls are always read
+     */
+    void SetSelection(const std::string& expression);
+
+    /**
+     * @brief SetLazyCollections keeps the given collections of treeEvents undecoded
+     * @param collections only decoded if a physics class declares to read them, see Physics::GetCollections
+     * @note events saved for slow controls are always fully decoded
+     */
+    void SetLazyCollections(const TEventData::collections_t& collections);
+
+    class Exception : public std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+
     // DataReader interface
     virtual bool IsSource() override;
     virtual bool ReadNextEvent(event_t& event) override;
+    virtual void SetPrefilter(prefilter_t prefilter_) override;
 
     double PercentDone() const override;
 };
@@ -0,0 +1,59 @@
+#include "EventIndex.h"
+
+#include "analysis/input/event_t.h"
+#include "analysis/utils/ParticleTools.h"
+
+#include "tree/TEventData.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+constexpr const char* EventIndex::TreeName;
+
+void EventIndex::Set(const event_t& event)
+{
+    SavedForSlowControls = event.SavedForSlowControls;
+
+    MCChannel = -1;
+    if(event.HasMCTrue()) {
+        const auto& ptree = event.MCTrue().ParticleTree;
+        ParticleTypeTreeDatabase::Channel channel;
+        if(ptree && utils::ParticleTools::TryFindParticleDatabaseChannel(ptree, channel))
+            MCChannel = static_cast<int>(channel);
+    }
+
+    if(!event.HasReconstructed()) {
+        EventID = 0;
+        IsMC = event.HasMCTrue();
+        nCandidates = 0;
+        nNeutral = 0;
+        nTaggerHits = 0;
+        CBEnergySum = 0;
+        ClusterMultiplicity = 0;
+        nDAQErrors = 0;
+        return;
+    }
+
+    const auto& recon = event.Reconstructed();
+
+    EventID = recon.ID.Value();
+    IsMC = recon.ID.isSet(TID::Flags_t::MC);
+
+    nCandidates = recon.Candidates.size();
+    nNeutral = count_if(recon.Candidates.begin(), recon.Candidates.end(),
+                        [] (const TCandidate& c) { return c.VetoEnergy == 0; });
+    nTaggerHits = recon.TaggerHits.size();
+
+    double esum = 0;
+    for(const TCluster& cluster : recon.Clusters) {
+        if(cluster.DetectorType == Detector_t::Type_t::CB)
+            esum += cluster.Energy;
+    }
+    CBEnergySum = esum;
+
+    ClusterMultiplicity = recon.Trigger.ClusterMultiplicity;
+    nDAQErrors = recon.Trigger.DAQErrors.size();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "base/WrapTTree.h"
+
+namespace ant {
+namespace analysis {
+namespace input {
+
+struct event_t;
+
+/**
+ * @brief The EventIndex struct is a companion tree of treeEvents with cheap per-event summaries
+ *
+ * It has the same entries as treeEvents, so selections can be evaluated on the index
+ * without deserializing the events, see AntReader::SetSelection.
+ */
+struct EventIndex : WrapTTree {
+
+    static constexpr const char* TreeName = "treeEventsIndex";
+
+    ADD_BRANCH_T(ULong64_t, EventID)              // TID::Value() of reconstructed
+    ADD_BRANCH_T(bool,      IsMC)
+    ADD_BRANCH_T(bool,      SavedForSlowControls) // always selected
+    ADD_BRANCH_T(unsigned,  nCandidates)
+    ADD_BRANCH_T(unsigned,  nNeutral)             // candidates without veto energy, cheap photon estimate
+    ADD_BRANCH_T(unsigned,  nTaggerHits)
+    ADD_BRANCH_T(double,    CBEnergySum)          // sum over all CB clusters
+    ADD_BRANCH_T(unsigned,  ClusterMultiplicity)  // from TTrigger
+    ADD_BRANCH_T(unsigned,  nDAQErrors)
+    ADD_BRANCH_T(int,       MCChannel)            // ParticleTypeTreeDatabase::Channel, -1 if unknown or no MC
+
+    /**
+     * @brief Set the branches from the event, but does not fill the tree
+     */
+    void Set(const event_t& event);
+};
+
+}}} // namespace ant::analysis::input
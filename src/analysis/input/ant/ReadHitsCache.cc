@@ -0,0 +1,263 @@
+#include "ReadHitsCache.h"
+
+#include "calibration/Calibration.h"
+#include "calibration/DataManager.h"
+#include "calibration/Fingerprint.h"
+#include "expconfig/ExpConfig.h"
+#include "reconstruct/Reconstruct_traits.h"
+#include "tree/TEventData.h"
+#include "tree/TCalibrationData.h"
+#include "tree/TAntHeader.h"
+
+#include "base/WrapTFile.h"
+#include "base/WrapTTree.h"
+#include "base/Logger.h"
+#include "base/std_ext/memory.h"
+#include "base/std_ext/string.h"
+
+#include <cstring>
+#include <limits>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+constexpr const char* ReadHitsCache::TreeName;
+constexpr const char* ReadHitsCache::TreeNameModules;
+
+struct ReadHitsCache::tree_t : WrapTTree {
+    ADD_BRANCH_T(TEvent,                 Event)         // before calibration of read hits
+    ADD_BRANCH_T(std::vector<unsigned>,  NValues)       // one item per read hit
+    ADD_BRANCH_T(std::vector<double>,    Uncalibrated)  // concatenated values of all read hits
+    ADD_BRANCH_T(std::vector<double>,    Calibrated)
+};
+
+struct ReadHitsCache::tree_modules_t : WrapTTree {
+    ADD_BRANCH_T(std::string, Name)
+    ADD_BRANCH_T(ULong64_t,   Fingerprint)
+    ADD_BRANCH_T(TID,         FirstID)
+    ADD_BRANCH_T(TID,         LastID)
+};
+
+ReadHitsCache::fingerprints_t ReadHitsCache::GetFingerprints(const TID& firstID, const TID& lastID)
+{
+    auto& setup = ExpConfig::Setup::Get();
+    auto calmgr = setup.GetCalibrationDataManager();
+    const auto calibrationIDs = calmgr ? calmgr->GetCalibrationIDs() : list<string>{};
+
+    fingerprints_t fingerprints;
+    for(const auto& hook : setup.GetReconstructHooks()) {
+        if(!dynamic_pointer_cast<ReconstructHook::DetectorReadHits>(hook))
+            continue;
+        auto module = dynamic_pointer_cast<Calibration::BaseModule>(hook);
+        if(!module)
+            continue;
+
+        const auto& name = module->GetName();
+        calibration::Fingerprint hash;
+        hash.add(name);
+        hash.add(calmgr && calmgr->GetOverrideToDefault());
+
+        // the IDs of a module are prefixed with its name
+        for(const auto& calibrationID : calibrationIDs) {
+            if(calibrationID != name && !std_ext::string_starts_with(calibrationID, name+"_"))
+                continue;
+            hash.add(*calmgr, calibrationID, firstID, lastID);
+        }
+        fingerprints[name] = hash.Value;
+    }
+    return fingerprints;
+}
+
+ReadHitsCache::Writer::Writer(const string& filename) :
+    file(std_ext::make_unique<WrapTFileOutput>(filename)),
+    tree(std_ext::make_unique<tree_t>())
+{
+    tree->CreateBranches(file->CreateInside<TTree>(TreeName, "Events before and after calibration of read hits"));
+    LOG(INFO) << "Writing read hits cache to " << filename;
+}
+
+ReadHitsCache::Writer::~Writer()
+{
+    if(finished)
+        return;
+    // destructors must not throw, call Finish explicitly to see the errors
+    try {
+        Finish();
+    }
+    catch(const std::exception& e) {
+        LOG(ERROR) << "Could not finish read hits cache: " << e.what();
+    }
+}
+
+void ReadHitsCache::Writer::Finish()
+{
+    if(finished)
+        return;
+    finished = true;
+
+    // the range is only known at the end
+    tree_modules_t tree_modules;
+    tree_modules.CreateBranches(file->CreateInside<TTree>(TreeNameModules, "Fingerprints of calibration modules"));
+    try {
+        for(const auto& it : GetFingerprints(firstID, lastID)) {
+            tree_modules.Name = it.first;
+            tree_modules.Fingerprint = it.second;
+            tree_modules.FirstID = firstID;
+            tree_modules.LastID = lastID;
+            tree_modules.Tree->Fill();
+        }
+    }
+    catch(ExpConfig::ExceptionNoSetup) {
+        LOG(WARNING) << "No setup found, read hits cache can only be used without reconstruct";
+    }
+
+    // the header makes the setup known when reading the cache
+    TAntHeader header;
+    header.FirstID = firstID;
+    header.LastID = lastID;
+    try {
+        header.SetupName = ExpConfig::Setup::Get().GetName();
+    }
+    catch(ExpConfig::ExceptionNoSetup) {}
+    file->WriteObject(addressof(header), "AntHeader");
+
+    LOG(INFO) << "Wrote " << tree->Tree->GetEntries() << " events to read hits cache";
+}
+
+namespace {
+// clusters and candidates refer to each other and cannot be copied,
+// but they are only made by the reconstruction anyway
+void copy_unreconstructed(const TEventData& from, TEventData& to) {
+    to.DetectorReadHits = from.DetectorReadHits;
+    to.SlowControls     = from.SlowControls;
+    to.UnpackerMessages = from.UnpackerMessages;
+    to.TaggerHits       = from.TaggerHits;
+    to.Trigger          = from.Trigger;
+    to.Target           = from.Target;
+    to.ParticleTree     = from.ParticleTree;
+}
+}
+
+void ReadHitsCache::Writer::Prepare(const event_t& event)
+{
+    auto& cached = tree->Event();
+    if(event.HasMCTrue()) {
+        cached = TEvent(event.Reconstructed().ID, event.MCTrue().ID);
+        copy_unreconstructed(event.MCTrue(), cached.MCTrue());
+    }
+    else {
+        cached = TEvent(event.Reconstructed().ID);
+    }
+    copy_unreconstructed(event.Reconstructed(), cached.Reconstructed());
+    cached.SavedForSlowControls = event.SavedForSlowControls;
+}
+
+void ReadHitsCache::Writer::Fill(const TEventData& reconstructed)
+{
+    auto& nValues = tree->NValues();
+    auto& uncalibrated = tree->Uncalibrated();
+    auto& calibrated = tree->Calibrated();
+    nValues.resize(0);
+    uncalibrated.resize(0);
+    calibrated.resize(0);
+
+    for(const TDetectorReadHit& readhit : reconstructed.DetectorReadHits) {
+        nValues.push_back(readhit.Values.size());
+        for(const auto& v : readhit.Values) {
+            uncalibrated.push_back(v.Uncalibrated);
+            calibrated.push_back(v.Calibrated);
+        }
+    }
+
+    // reconstruct does not add or remove read hits, but be safe
+    if(reconstructed.DetectorReadHits.size() != tree->Event().Reconstructed().DetectorReadHits.size())
+        throw runtime_error("Read hits changed during reconstruction, cannot cache them");
+
+    const auto& id = reconstructed.ID;
+    if(firstID.IsInvalid() || id < firstID)
+        firstID = id;
+    if(lastID.IsInvalid() || lastID < id)
+        lastID = id;
+
+    tree->Tree->Fill();
+}
+
+ReadHitsCache::Reader::Reader(const WrapTFileInput& rootfiles) :
+    tree(std_ext::make_unique<tree_t>())
+{
+    if(!rootfiles.GetObject(TreeName, tree->Tree))
+        return;
+    tree->LinkBranches();
+
+    tree_modules_t tree_modules;
+    if(!rootfiles.GetObject(TreeNameModules, tree_modules.Tree))
+        return;
+    tree_modules.LinkBranches();
+    for(Long64_t entry=0;entry<tree_modules.Tree->GetEntries();entry++) {
+        tree_modules.GetEntry(entry);
+        cached[tree_modules.Name] = tree_modules.Fingerprint;
+        firstID = tree_modules.FirstID;
+        lastID = tree_modules.LastID;
+    }
+    LOG(INFO) << "Found read hits cache with " << tree->Tree->GetEntries() << " events and "
+              << cached.size() << " calibration modules";
+}
+
+ReadHitsCache::Reader::~Reader() {}
+
+ReadHitsCache::Reader::operator bool() const
+{
+    return tree->Tree != nullptr;
+}
+
+bool ReadHitsCache::Reader::IsChanged(const string& moduleName) const
+{
+    auto it_cached = cached.find(moduleName);
+    if(it_cached == cached.end())
+        return true;
+    if(current.empty())
+        current = GetFingerprints(firstID, lastID);
+    auto it_current = current.find(moduleName);
+    return it_current == current.end() || it_current->second != it_cached->second;
+}
+
+TEvent ReadHitsCache::Reader::NextEvent(const isdirty_t& isDirty)
+{
+    if(!tree->Tree || current_entry == tree->Tree->GetEntries())
+        return {};
+
+    tree->GetEntry(current_entry++);
+    TEvent event(move(tree->Event()));
+
+    // restore the calibrated values of the clean read hits,
+    // the dirty ones keep their state before calibration
+    auto& readhits = event.Reconstructed().DetectorReadHits;
+    const auto& nValues = tree->NValues();
+    const auto& uncalibrated = tree->Uncalibrated();
+    const auto& calibrated = tree->Calibrated();
+    if(nValues.size() != readhits.size())
+        throw runtime_error("Read hits cache is inconsistent");
+
+    size_t offset = 0;
+    for(size_t i=0;i<readhits.size();i++) {
+        auto& readhit = readhits[i];
+        const auto n = nValues[i];
+        if(!isDirty || !isDirty(readhit.DetectorType, readhit.ChannelType)) {
+            readhit.Values.resize(0);
+            for(size_t j=offset;j<offset+n;j++) {
+                readhit.Values.emplace_back(uncalibrated[j]);
+                readhit.Values.back().Calibrated = calibrated[j];
+            }
+        }
+        offset += n;
+    }
+    return event;
+}
+
+double ReadHitsCache::Reader::PercentDone() const
+{
+    if(tree->Tree)
+        return double(current_entry)/double(tree->Tree->GetEntries());
+    return numeric_limits<double>::quiet_NaN();
+}
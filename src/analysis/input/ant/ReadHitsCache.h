@@ -0,0 +1,122 @@
+#pragma once
+
+#include "analysis/input/event_t.h"
+#include "tree/TID.h"
+#include "base/Detector_t.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace ant {
+
+struct TEventData;
+class WrapTFileInput;
+class WrapTFileOutput;
+
+namespace analysis {
+namespace input {
+
+/**
+ * @brief The ReadHitsCache stores events before and after calibration of the read hits
+ *
+ * Writing the cache while unpacking raw data (see Writer) allows a later replay, which
+ * only re-applies the calibration modules which have changed since then (see Reader and
+ * reconstruct::ReconstructReplay). This avoids unpacking the raw file again and running
+ * the full calibration for every iteration of a calibration loop.
+ *
+ * A module is considered changed if its fingerprint differs, which is built from
+ * all calibration data the module may load within the processed range of TIDs.
+ * Changes in code or in setup options are NOT detected, the cache must be rebuilt then.
+ */
+struct ReadHitsCache {
+
+    static constexpr const char* TreeName        = "treeReadHitsCache";
+    static constexpr const char* TreeNameModules = "treeReadHitsCacheModules";
+
+    using fingerprint_t = std::uint64_t;
+
+    // indexed by module name
+    using fingerprints_t = std::map<std::string, fingerprint_t>;
+
+    /**
+     * @brief GetFingerprints of all calibration modules of the current setup acting on read hits
+     * @return fingerprints of the calibration data within the given range of TIDs
+     */
+    static fingerprints_t GetFingerprints(const TID& firstID, const TID& lastID);
+
+    struct tree_t;
+    struct tree_modules_t;
+
+    class Writer {
+    public:
+        explicit Writer(const std::string& filename);
+        ~Writer();
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        /**
+         * @brief Prepare copies the uncalibrated state of the event, call before reconstruction
+         */
+        void Prepare(const event_t& event);
+
+        /**
+         * @brief Fill stores the prepared event along with the calibrated values of its read hits
+         * @param reconstructed the data given to Prepare, after reconstruction
+         */
+        void Fill(const TEventData& reconstructed);
+
+        /**
+         * @brief Finish writes the fingerprints and the header, may throw on errors
+         * @note called by the destructor if not done before, which only logs the errors
+         */
+        void Finish();
+
+    protected:
+        std::unique_ptr<WrapTFileOutput> file;
+        std::unique_ptr<tree_t> tree;
+        TID firstID;
+        TID lastID;
+        bool finished = false;
+    };
+
+    class Reader {
+    public:
+        explicit Reader(const WrapTFileInput& rootfiles);
+        ~Reader();
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        explicit operator bool() const;
+
+        /**
+         * @brief IsChanged tells if the calibration data of the module changed since the cache was written
+         * @param moduleName as given by Calibration::BaseModule::GetName()
+         * @note modules not found in the cache are always changed
+         */
+        bool IsChanged(const std::string& moduleName) const;
+
+        using isdirty_t = std::function<bool(Detector_t::Type_t, Channel_t::Type_t)>;
+
+        /**
+         * @brief NextEvent reads the next cached event
+         * @param isDirty decides which read hits are provided uncalibrated, if empty all are calibrated
+         * @return the event, evaluates to false if no more events are available
+         */
+        TEvent NextEvent(const isdirty_t& isDirty);
+
+        double PercentDone() const;
+
+    protected:
+        std::unique_ptr<tree_t> tree;
+        long long current_entry = 0;
+        fingerprints_t cached;
+        mutable fingerprints_t current; // lazily built by IsChanged
+        TID firstID;
+        TID lastID;
+    };
+};
+
+}}} // namespace ant::analysis::input
@@ -17,6 +17,9 @@ struct event_t : TEvent {
     bool empty_reconstructed = false;
     bool empty_mctrue = false;
 
+    // rejected by the prefilter, thus not reconstructed and not to be processed by physics classes
+    bool Prefiltered = false;
+
     bool HasReconstructed() const { return reconstructed!=nullptr; }
     bool HasMCTrue() const { return mctrue!=nullptr; }
 
@@ -321,12 +321,12 @@ bool PlutoReader::ReadNextEvent(event_t& event)
     if(current_entry >= plutoTree.Tree->GetEntries())
         return false;
 
-    plutoTree.Tree->GetEntry(current_entry);
+    plutoTree.GetEntry(current_entry);
 
     // use eventID from file if available
     // also check if it matches with reconstructed TID
     if(tidTree) {
-        tidTree.Tree->GetEntry(current_entry);
+        tidTree.GetEntry(current_entry);
         if(event.HasReconstructed() &&
            event.Reconstructed().ID != tidTree.tid) {
             throw Exception(std_ext::formatter()
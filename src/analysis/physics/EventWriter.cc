@@ -0,0 +1,126 @@
+#include "EventWriter.h"
+
+#include "base/std_ext/string.h"
+
+#include "TDirectory.h"
+#include "TFile.h"
+#include "TROOT.h"
+#include "TSystem.h"
+#include "TTree.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+namespace {
+string make_tmpfilename(TDirectory* outputDir, const string& treename) {
+    if(!outputDir || !outputDir->GetFile())
+        throw EventWriter::Exception("EventWriter needs an output file");
+    return std_ext::formatter() << outputDir->GetFile()->GetName() << "." << treename
+                                << "." << gSystem->GetPid() << ".tmp";
+}
+}
+
+EventWriter::EventWriter(TDirectory* outputDir_,
+                         const string& treename_, const string& title_,
+                         size_t maxQueued_) :
+    outputDir(outputDir_),
+    treename(treename_),
+    title(title_),
+    tmpfilename(make_tmpfilename(outputDir_, treename_)),
+    compression(outputDir_->GetFile()->GetCompressionSettings()),
+    maxQueued(maxQueued_)
+{
+    // the writer thread uses its own TFile and gDirectory
+    ROOT::EnableThreadSafety();
+    thread = std::thread(&EventWriter::Run, this);
+}
+
+EventWriter::~EventWriter()
+{
+    StopThread();
+    gSystem->Unlink(tmpfilename.c_str());
+}
+
+void EventWriter::Fill(input::event_t event)
+{
+    unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] () { return queue.size() < maxQueued || error; });
+    if(error)
+        rethrow_exception(error);
+    queue.emplace_back(move(event));
+    changed.notify_all();
+}
+
+TTree* EventWriter::Finish()
+{
+    StopThread();
+    if(error)
+        rethrow_exception(error);
+
+    unique_ptr<TFile> tmpfile(TFile::Open(tmpfilename.c_str(), "READ"));
+    TTree* tmptree = nullptr;
+    if(tmpfile)
+        tmpfile->GetObject(treename.c_str(), tmptree);
+    if(!tmptree)
+        throw Exception(std_ext::formatter() << "Cannot read back " << treename << " from " << tmpfilename);
+
+    // fast cloning copies the compressed baskets without unzipping them
+    TTree* tree = nullptr;
+    {
+        TDirectory::TContext context(outputDir);
+        tree = tmptree->CloneTree(-1, "fast");
+    }
+    tmpfile = nullptr;
+    gSystem->Unlink(tmpfilename.c_str());
+    return tree;
+}
+
+void EventWriter::Run()
+{
+    try {
+        TFile tmpfile(tmpfilename.c_str(), "RECREATE");
+        if(tmpfile.IsZombie())
+            throw Exception(std_ext::formatter() << "Cannot create " << tmpfilename);
+        tmpfile.SetCompressionSettings(compression);
+
+        auto tree = new TTree(treename.c_str(), title.c_str());
+        TEvent* eventPtr = nullptr;
+        tree->Branch("data", addressof(eventPtr));
+
+        input::event_t event;
+        for(;;) {
+            {
+                unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [this] () { return !queue.empty() || stop; });
+                if(queue.empty())
+                    break;
+                event = move(queue.front());
+                queue.pop_front();
+                changed.notify_all();
+            }
+            eventPtr = addressof(event);
+            tree->Fill();
+        }
+
+        tree->Write();
+        tmpfile.Close();
+    }
+    catch(...) {
+        lock_guard<std::mutex> lock(mutex);
+        error = current_exception();
+        changed.notify_all();
+    }
+}
+
+void EventWriter::StopThread()
+{
+    if(!thread.joinable())
+        return;
+    {
+        lock_guard<std::mutex> lock(mutex);
+        stop = true;
+    }
+    changed.notify_all();
+    thread.join();
+}
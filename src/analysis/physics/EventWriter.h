@@ -0,0 +1,69 @@
+#pragma once
+
+#include "input/event_t.h"
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+class TDirectory;
+class TTree;
+
+namespace ant {
+namespace analysis {
+
+/**
+ * @brief The EventWriter class fills TEvents into a TTree in a background thread
+ *
+ * Serializing and compressing the events then overlaps with processing the following ones.
+ * As the physics classes keep filling their trees into the output file, the events
+ * are written to a temporary file next to it, which is copied into the output directory
+ * by fast cloning on Finish. The compressed baskets are copied as they are, so the
+ * temporary file uses the compression settings of the output file.
+ *
+ * At most MaxQueued events are waiting for the writer, Fill blocks if more are pending.
+ */
+class EventWriter {
+public:
+    EventWriter(TDirectory* outputDir,
+                const std::string& treename, const std::string& title,
+                std::size_t maxQueued = 256);
+    ~EventWriter();
+
+    void Fill(input::event_t event);
+
+    /**
+     * @brief Finish waits until all events are written and copies the tree into the output directory
+     * @return the tree in the output directory, owned by it
+     */
+    TTree* Finish();
+
+    class Exception : public std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+
+protected:
+    TDirectory* const outputDir;
+    const std::string treename;
+    const std::string title;
+    const std::string tmpfilename;
+    const int compression;
+    const std::size_t maxQueued;
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<input::event_t> queue;
+    bool stop = false;
+    std::exception_ptr error;
+
+    std::thread thread;
+
+    void Run();
+    void StopThread();
+};
+
+}} // namespace ant::analysis
@@ -27,6 +27,10 @@ namespace ant {
 
 namespace analysis {
 
+namespace input {
+class PrefilterEvent;
+}
+
 class Physics {
 private:
     std::string name_;
@@ -39,6 +43,22 @@ public:
     virtual ~Physics() {}
 
     virtual void ProcessEvent(const TEvent& event, physics::manager_t& manager) =0;
+    /**
+     * @brief GetCollections tells which collections of TEventData ProcessEvent reads
+     * @return all by default, override it to let collections be kept undecoded with Ant --lazy
+     * @note the collections any physics class reads are decoded before ProcessEvent
+     */
+    virtual TEventData::collections_t GetCollections() const { return ~TEventData::collections_t(); }
+    /**
+     * @brief Prefilter tells before reconstruction if an event might be interesting at all
+     * @return false if ProcessEvent does not need to see the event, it's then not reconstructed
+     * @note an event is only rejected if all physics classes reject it
+     */
+    virtual bool Prefilter(const input::PrefilterEvent&) { return true; }
+    /**
+     * @brief MaterializeHistograms fills the fast histograms into the ROOT histograms, called before Finish()
+     */
+    void MaterializeHistograms() { HistFac.MaterializeFastHistograms(); }
     virtual void Finish() {}
     virtual void ShowResult() {}
     std::string GetName() const { return name_; }
@@ -1,7 +1,9 @@
 #include "PhysicsManager.h"
+#include "EventWriter.h"
 
 #include "utils/ParticleID.h"
 #include "input/DataReader.h"
+#include "input/ant/EventIndex.h"
 
 #include "tree/TSlowControl.h"
 #include "base/Logger.h"
@@ -19,6 +21,8 @@ using namespace std;
 using namespace ant;
 using namespace ant::analysis;
 
+unsigned PhysicsManager::WriterThreads = 0;
+
 PhysicsManager::PhysicsManager(volatile bool* interrupt_) :
     physics(),
     interrupt(interrupt_),
@@ -64,20 +68,51 @@ void PhysicsManager::ReadFrom(
     if(physics.empty())
         throw Exception("No analysis instances activated. Cannot not analyse anything.");
 
+    collections = {};
+    for(auto& p : physics)
+        collections |= p->GetCollections();
+
+    // events are only rejected before reconstruction if no physics class is interested
+    if(source) {
+        source->SetPrefilter([this] (const input::PrefilterEvent& event) {
+            for(auto& p : physics) {
+                if(p->Prefilter(event))
+                    return true;
+            }
+            return false;
+        });
+    }
+
     // prepare slowcontrol, init here since physics classes
     // register slowcontrol variables in constructor
     slowcontrol_mgr = std_ext::make_unique<SlowControlManager>();
 
 
     // prepare output of TEvents
-    treeEvents = new TTree("treeEvents","TEvent data");
+    treeEvents = nullptr;
     treeEventPtr = nullptr;
-    treeEvents->Branch("data", addressof(treeEventPtr));
+    eventWriter = nullptr;
+    if(WriterThreads>0 && gDirectory->GetFile()) {
+        eventWriter = std_ext::make_unique<EventWriter>(gDirectory, "treeEvents", "TEvent data");
+    }
+    else {
+        treeEvents = new TTree("treeEvents","TEvent data");
+        treeEvents->Branch("data", addressof(treeEventPtr));
+    }
+    treeEventsIndex = std_ext::make_unique<input::EventIndex>();
+    treeEventsIndex->CreateBranches(new TTree(input::EventIndex::TreeName, "Summary of treeEvents"));
+
+    // prepare instrumentation
+    stages_physics.clear();
+    for(const auto& p : physics)
+        stages_physics.push_back(Instrumentation::GetStage("Physics/"+p->GetName()));
+    stage_saveEvent = Instrumentation::GetStage("PhysicsManager/SaveEvent");
 
     long long nEventsRead = 0;
     long long nEventsProcessed = 0;
     long long nEventsAnalyzed = 0;
     long long nEventsSaved = 0;
+    long long nEventsPrefiltered = 0;
 
     bool reached_maxevents = false;
 
@@ -156,7 +191,11 @@ void PhysicsManager::ReadFrom(
 
                 if(!reached_maxevents && !buf_event.WantsSkip) {
 
-                    ProcessEvent(event, manager);
+                    // prefiltered events count as analyzed, so maxevents refers to the same input
+                    if(event.Prefiltered)
+                        nEventsPrefiltered++;
+                    else
+                        ProcessEvent(event, manager);
 
                     // prefer Reconstructed ID, but at least one branch should be non-null
                     const auto& eventid = event.HasReconstructed() ? event.Reconstructed().ID : event.MCTrue().ID;
@@ -180,6 +219,7 @@ void PhysicsManager::ReadFrom(
     }
 
     for(auto& pclass : physics) {
+        pclass->MaterializeHistograms();
         pclass->Finish();
     }
 
@@ -190,20 +230,36 @@ void PhysicsManager::ReadFrom(
         processed_str += std_ext::formatter() << " (" << nEventsProcessed << " processed)";
     if(nEventsRead != nEventsAnalyzed)
         processed_str += std_ext::formatter() << " (" << nEventsRead << " read)";
+    if(nEventsPrefiltered>0)
+        processed_str += std_ext::formatter() << " (" << nEventsPrefiltered << " rejected by prefilter)";
 
 
     LOG(INFO) << "Analyzed " << nEventsAnalyzed << " events"
               << processed_str << ", speed "
               << nEventsProcessed/progress.GetTotalSecs() << " event/s";
 
+    if(eventWriter) {
+        {
+            Instrumentation::ScopedTimer t(Instrumentation::GetStage("PhysicsManager/FinishEventWriter"));
+            treeEvents = eventWriter->Finish();
+        }
+        eventWriter = nullptr;
+        Instrumentation::Count(stage_saveEvent, treeEvents->GetTotBytes());
+    }
+
     const auto nEventsSavedTotal = treeEvents->GetEntries();
     if(nEventsSaved==0) {
         if(nEventsSavedTotal>0)
             VLOG(5) << "Deleting " << nEventsSavedTotal << " treeEvents from slowcontrol only";
         delete treeEvents;
+        delete treeEventsIndex->Tree;
     }
     else if(treeEvents->GetCurrentFile() != nullptr) {
-        treeEvents->Write();
+        {
+            Instrumentation::ScopedTimer t(Instrumentation::GetStage("PhysicsManager/WriteEvents"));
+            treeEvents->Write();
+            treeEventsIndex->Tree->Write();
+        }
         const auto n_sc = nEventsSavedTotal - nEventsSaved;
         LOG(INFO) << "Wrote " << nEventsSaved  << " treeEvents"
                   << (n_sc>0 ? string(std_ext::formatter() << " (+slowcontrol: " << n_sc << ")") : "")
@@ -249,8 +305,16 @@ void PhysicsManager::ProcessEvent(input::event_t& event, physics::manager_t& man
 
     event.EnsureTempBranches();
 
+    // undecoded collections would silently look empty to the physics classes
+    if(event.HasReconstructed())
+        event.Reconstructed().Decode(collections);
+    if(event.HasMCTrue())
+        event.MCTrue().Decode(collections);
+
     // run the physics classes
+    auto it_stage = stages_physics.begin();
     for( auto& m : physics ) {
+        Instrumentation::ScopedTimer t(*it_stage++);
         m->ProcessEvent(event, manager);
     }
 
@@ -261,7 +325,7 @@ void PhysicsManager::SaveEvent(input::event_t event, const physics::manager_t& m
 {
     if(manager.saveEvent || event.SavedForSlowControls) {
         // only warn if manager says it should save
-        if(!treeEvents->GetCurrentFile() && manager.saveEvent)
+        if(!eventWriter && !treeEvents->GetCurrentFile() && manager.saveEvent)
             LOG_N_TIMES(1, WARNING) << "Writing treeEvents to memory. Might be a lot of data!";
 
 
@@ -269,7 +333,18 @@ void PhysicsManager::SaveEvent(input::event_t event, const physics::manager_t& m
         if(!manager.keepReadHits && !event.SavedForSlowControls)
             event.ClearDetectorReadHits();
 
+        treeEventsIndex->Set(event);
+        treeEventsIndex->Tree->Fill();
+
+        Instrumentation::ScopedTimer t(stage_saveEvent);
+        if(eventWriter) {
+            // bytes are counted once the writer has finished
+            eventWriter->Fill(move(event));
+            return;
+        }
         treeEventPtr = addressof(event);
-        treeEvents->Fill();
+        const auto nBytes = treeEvents->Fill();
+        if(nBytes>0)
+            Instrumentation::Count(stage_saveEvent, nBytes);
     }
 }
@@ -2,6 +2,8 @@
 
 #include "Physics.h"
 
+#include "base/Instrumentation.h"
+
 #include <memory>
 #include <queue>
 
@@ -12,6 +14,7 @@ namespace ant {
 namespace analysis {
 
 class SlowControlManager;
+class EventWriter;
 
 namespace slowcontrol {
 struct event_t;
@@ -24,6 +27,7 @@ class ParticleID;
 namespace input {
 struct event_t;
 class DataReader;
+struct EventIndex;
 }
 
 class PhysicsManager {
@@ -63,9 +67,27 @@ protected:
     // for output of TEvents to TTree
     TTree*  treeEvents;
     TEvent* treeEventPtr;
+    // fills treeEvents in the background instead, see WriterThreads
+    std::unique_ptr<EventWriter> eventWriter;
+    // cheap summary with same entries as treeEvents, for selections when reading
+    std::unique_ptr<input::EventIndex> treeEventsIndex;
+
+    // read by any physics class, decoded if read lazily
+    TEventData::collections_t collections;
+
+    // one stage per physics class, in order of physics list
+    std::vector<Instrumentation::stage_t> stages_physics;
+    Instrumentation::stage_t stage_saveEvent;
 
 public:
 
+    /**
+     * @brief WriterThreads if non-zero, treeEvents are serialized and compressed by a background thread.
+     * @note compressing baskets with further threads needs ROOT::EnableImplicitMT(),
+     * which is left to the program as it affects the whole process
+     */
+    static unsigned WriterThreads;
+
     PhysicsManager(volatile bool* interrupt_ = nullptr);
     virtual ~PhysicsManager();
 
@@ -48,4 +48,14 @@ void Plotter::Finish() {}
 
 void Plotter::ShowResult() {}
 
+void Plotter::MakeShard()
+{
+    HistFac.ResetObjects();
+}
+
+void Plotter::MergeShard(const Plotter& shard)
+{
+    HistFac.MergeObjects(shard.HistFac);
+}
+
 ant::analysis::Plotter::~Plotter() {}
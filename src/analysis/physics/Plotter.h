@@ -29,6 +29,26 @@ public:
     virtual void Finish();
     virtual void ShowResult();
 
+    /**
+     * @brief IsParallel tells if ProcessEntry only fills the histograms and trees of HistFac
+     *
+     * Then several instances may process disjoint ranges of entries, see MakeShard and MergeShard.
+     * Objects created lazily in ProcessEntry, like the stacks of cuttree::StackedHists_t, are merged as well.
+     * What the constructor fills must not depend on the processed entries.
+     */
+    virtual bool IsParallel() const { return false; }
+
+    /**
+     * @brief MakeShard clears everything the constructor of this instance has filled,
+     * before it processes a range of entries for another instance
+     */
+    void MakeShard();
+
+    /**
+     * @brief MergeShard adds what the shard has filled, it must not process entries anymore
+     */
+    void MergeShard(const Plotter& shard);
+
     virtual ~Plotter();
 
     struct Exception : std::runtime_error {
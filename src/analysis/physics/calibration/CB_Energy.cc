@@ -27,8 +27,7 @@ CB_Energy::CB_Energy(const string& name, OptionsPtr opts) :
     const BinSettings cb_channels(detector->GetNChannels());
     const BinSettings energybins(1000);
 
-    ggIM = HistFac.makeTH2D("2 neutral IM (CB,CB)", "IM [MeV]", "#",
-                            energybins, cb_channels, "ggIM");
+    ggIM = HistFac.makeFastTH2D("2 neutral IM (CB,CB)", {"IM [MeV]", energybins}, {"#", cb_channels}, "ggIM");
     h_cbdisplay = HistFac.make<TH2CB>("h_cbdisplay","Number of entries");
 }
 
@@ -64,10 +63,10 @@ void CB_Energy::ProcessEvent(const TEvent& event, manager_t&)
 
 void CB_Energy::ShowResult()
 {
-    auto proj = dynamic_cast<TH1D*>(ggIM->ProjectionX());
+    auto proj = dynamic_cast<TH1D*>(ggIM->Get()->ProjectionX());
     proj->GetXaxis()->SetRangeUser(0, 300);
-    h_cbdisplay->SetElements(*ggIM->ProjectionY());
-    canvas(GetName()) << drawoption("colz") << ggIM
+    h_cbdisplay->SetElements(*ggIM->Get()->ProjectionY());
+    canvas(GetName()) << drawoption("colz") << ggIM->Get()
                       << h_cbdisplay
                       << proj
                       << endc;
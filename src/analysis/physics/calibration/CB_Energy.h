@@ -1,6 +1,7 @@
 #pragma once
 
 #include "analysis/physics/Physics.h"
+#include "analysis/plot/FastHistogram.h"
 
 #include "root-addons/cbtaps_display/TH2CB.h"
 
@@ -11,7 +12,7 @@ namespace physics {
 class CB_Energy : public Physics {
 
 protected:
-    TH2* ggIM = nullptr;
+    FastTH2D* ggIM = nullptr;
     TH2CB* h_cbdisplay = nullptr;
 
     const bool RequireClean = true;
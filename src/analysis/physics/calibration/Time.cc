@@ -23,46 +23,38 @@ Time::Time(const Detector_t::Type_t& detectorType,
     const BinSettings TimeBins = isTagger ?
                                      BinSettings::RoundToBinSize(BinSettings(2000,-400,400), calibration::converter::Gains::CATCH_TDC) : BinSettings(2000,-400,400);
 
-    hTime = HistFac.makeTH2D(detectorName + " - Time",
-                             "time [ns]",
-                             detectorName + " channel",
-                             TimeBins,
-                             BinSettings(Detector->GetNChannels()),
-                             "Time"
-                             );
+    hTime = HistFac.makeFastTH2D(detectorName + " - Time",
+                                 {"time [ns]", TimeBins},
+                                 {detectorName + " channel", BinSettings(Detector->GetNChannels())},
+                                 "Time"
+                                 );
     const AxisSettings bins_timeZoomed("t / ns", BinSettings::RoundToBinSize(BinSettings(1000,-65,65), calibration::converter::Gains::CATCH_TDC));
-    hTimeToTriggerRef = HistFac.makeTH2D(
+    hTimeToTriggerRef = HistFac.makeFastTH2D(
                             detectorName + " - Time relative to TriggerRef",
                             bins_timeZoomed,
                             {detectorName + " channel", {Detector->GetNChannels()}},
                             "hTimeToTriggerRef" // should be used for TAPS_ToF offsets...
                             );
-    hTimeZoomed = HistFac.makeTH2D(
+    hTimeZoomed = HistFac.makeFastTH2D(
                             detectorName + " - Time (zoomed)",
                             bins_timeZoomed,
                             {detectorName + " channel", {Detector->GetNChannels()}},
                             "hTimeZoomed" // should be used for TAPS_ToF offsets...
                             );
-    hTimeToTagger = HistFac.makeTH2D(
+    hTimeToTagger = HistFac.makeFastTH2D(
                         detectorName + " - Time relative to tagger",
-                        "time [ns]",
-                        detectorName + " channel",
-                        BinSettings(2000,-1500,1500),
-                        BinSettings(Detector->GetNChannels()),
+                        {"time [ns]", BinSettings(2000,-1500,1500)},
+                        {detectorName + " channel", BinSettings(Detector->GetNChannels())},
                         "hTimeToTagger"
                         );
-    hTriggerRefTiming = HistFac.makeTH1D("CB - Trigger timing",
-                                "time [ns]",
-                                "#",
-                                BinSettings(500,-15,15),
+    hTriggerRefTiming = HistFac.makeFastTH1D("CB - Trigger timing",
+                                {"time [ns]", BinSettings(500,-15,15)},
                                 "hTriggerRefTiming");
-    hTimeMultiplicity = HistFac.makeTH2D(detectorName + " - Time Hit Multiplicity",
-                                         "multiplicity",
-                                         detectorName + " channel",
-                                         BinSettings(8),
-                                         BinSettings(Detector->GetNChannels()),
-                                         "hTimeMultiplicity"
-                                         );
+    hTimeMultiplicity = HistFac.makeFastTH2D(detectorName + " - Time Hit Multiplicity",
+                                             {"multiplicity", BinSettings(8)},
+                                             {detectorName + " channel", BinSettings(Detector->GetNChannels())},
+                                             "hTimeMultiplicity"
+                                             );
 }
 
 void Time::ProcessEvent(const TEvent& event, manager_t&)
@@ -109,12 +101,12 @@ void Time::ShowResult()
 {
     canvas(GetName())
             << drawoption("colz")
-            << hTime
-            << hTimeToTagger
-            << hTriggerRefTiming
-            << hTimeZoomed
-            << hTimeToTriggerRef
-            << hTimeMultiplicity
+            << hTime->Get()
+            << hTimeToTagger->Get()
+            << hTriggerRefTiming->Get()
+            << hTimeZoomed->Get()
+            << hTimeToTriggerRef->Get()
+            << hTimeMultiplicity->Get()
             << endc;
 }
 
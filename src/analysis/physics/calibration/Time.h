@@ -1,6 +1,7 @@
 #pragma once
 
 #include "analysis/physics/Physics.h"
+#include "analysis/plot/FastHistogram.h"
 #include "utils/TriggerSimulation.h"
 
 namespace ant {
@@ -20,12 +21,13 @@ protected:
 
     utils::TriggerSimulation triggersimu;
 
-    TH2D* hTime;
-    TH2D* hTimeToTriggerRef;
-    TH2D* hTimeZoomed;
-    TH2D* hTimeToTagger;
-    TH2D* hTimeMultiplicity;
-    TH1D* hTriggerRefTiming;
+    // filled several times per hit, so use the fast histograms
+    FastTH2D* hTime;
+    FastTH2D* hTimeToTriggerRef;
+    FastTH2D* hTimeZoomed;
+    FastTH2D* hTimeToTagger;
+    FastTH2D* hTimeMultiplicity;
+    FastTH1D* hTriggerRefTiming;
 
     std::shared_ptr<Detector_t> Detector;
     bool isTagger;
@@ -255,7 +255,7 @@ struct PIDEfficiencyCheck_plot : Plotter {
 
     Hist_t::Tree_t tree;
 
-    cuttree::Tree_t<Hist_t> mycuttree;
+    cuttree::Compiled_t<Hist_t> mycuttree;
 
     PIDEfficiencyCheck_plot(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         Plotter(name, input, opts)
@@ -274,7 +274,7 @@ struct PIDEfficiencyCheck_plot : Plotter {
 
     virtual void ProcessEntry(const long long entry) override
     {
-        tree.Tree->GetEntry(entry);
+        tree.GetEntry(entry);
         cuttree::Fill<Hist_t>(mycuttree, tree);
     }
 
@@ -4,6 +4,7 @@
 #include "base/std_ext/string.h"
 #include "base/Logger.h"
 #include "utils/ProtonPermutation.h"
+#include "input/Prefilter.h"
 
 
 using namespace ant;
@@ -68,6 +69,12 @@ EventFilter::~EventFilter()
 
 
 
+bool EventFilter::Prefilter(const input::PrefilterEvent& event)
+{
+    // each candidate has a cluster, which needs at least one calorimeter element with energy information
+    return event.GetMultiplicity(Detector_t::Any_t::Calo, Channel_t::Type_t::Integral) >= nCands.Start();
+}
+
 void EventFilter::ProcessEvent(const TEvent& event, manager_t& manager)
 {
     triggersimu.ProcessEvent(event);
@@ -34,6 +34,7 @@ public:
     virtual ~EventFilter();
 
     virtual void ProcessEvent(const TEvent& event, manager_t& manager) override;
+    virtual bool Prefilter(const input::PrefilterEvent& event) override;
 };
 
 }
@@ -370,7 +370,7 @@ struct MesonDalitzDecays_plot : Plotter {
     Hist_t::Tree_t Tree;
 
     using MCHist_t = MCTrue_Splitter<Hist_t>;
-    cuttree::Tree_t<MCHist_t> hists;
+    cuttree::Compiled_t<MCHist_t> hists;
 
     MesonDalitzDecays_plot(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         Plotter(name, input, opts)
@@ -395,10 +395,15 @@ struct MesonDalitzDecays_plot : Plotter {
 
     virtual void ProcessEntry(const long long entry) override
     {
-        Tree.Tree->GetEntry(entry);
+        Tree.GetEntry(entry);
         cuttree::Fill<MCHist_t>(hists, {Tree});
     }
 
+    virtual bool IsParallel() const override
+    {
+        return true;
+    }
+
 };
 
 
@@ -655,7 +655,7 @@ struct EtapDalitz_plot : Plotter {
     typename Hist_t::Tree_t Tree;
 
     using MCHist_t = MCTrue_Splitter<Hist_t>;
-    cuttree::Tree_t<MCHist_t> cuttree_hists;
+    cuttree::Compiled_t<MCHist_t> cuttree_hists;
 
     EtapDalitz_plot(const string& tag, const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         Plotter(name, input, opts)
@@ -681,7 +681,7 @@ struct EtapDalitz_plot : Plotter {
 
     virtual void ProcessEntry(const long long entry) override
     {
-        Tree.Tree->GetEntry(entry);
+        Tree.GetEntry(entry);
         cuttree::Fill<MCHist_t>(cuttree_hists, {Tree});
     }
 
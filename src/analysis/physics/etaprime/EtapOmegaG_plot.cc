@@ -672,12 +672,12 @@ struct EtapOmegaG_plot : Plotter {
 
             auto h = HistFac.makeTH1D(tag+": Generated events",{"TaggCh",{ept->GetNChannels()}},"h_mctrue_generated",true);
             for(long long entry=0;entry<treeMCWeighting.Tree->GetEntries();entry++) {
-                treeMCWeighting_extra.Tree->GetEntry(entry);
+                treeMCWeighting_extra.GetEntry(entry);
                 if(tag == "Sig" && treeMCWeighting_extra.MCTrue != 1)
                     continue;
                 if(tag == "Ref" && treeMCWeighting_extra.MCTrue != 2)
                     continue;
-                treeMCWeighting.Tree->GetEntry(entry);
+                treeMCWeighting.GetEntry(entry);
                 h->Fill(treeMCWeighting_extra.TaggCh(), treeMCWeighting.MCWeight());
             }
         }
@@ -705,9 +705,14 @@ struct EtapOmegaG_plot : Plotter {
 
     virtual void ProcessEntry(const long long entry) override
     {
-        treeCommon.Tree->GetEntry(entry);
+        treeCommon.GetEntry(entry);
         if(treeMCWeighting.Tree)
-            treeMCWeighting.Tree->GetEntry(entry);
+            treeMCWeighting.GetEntry(entry);
+    }
+
+    virtual bool IsParallel() const override
+    {
+        return true;
     }
 
 };
@@ -717,7 +722,7 @@ struct EtapOmegaG_plot_Ref : EtapOmegaG_plot {
     RefHist_t::Tree_t          treeRef;
 
     using MCRefHist_t = MCTrue_Splitter<RefHist_t>;
-    cuttree::Tree_t<MCRefHist_t> cuttreeRef;
+    cuttree::Compiled_t<MCRefHist_t> cuttreeRef;
 
     EtapOmegaG_plot_Ref(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         EtapOmegaG_plot("Ref", name, input, opts)
@@ -731,7 +736,7 @@ struct EtapOmegaG_plot_Ref : EtapOmegaG_plot {
     virtual void ProcessEntry(const long long entry) override
     {
         EtapOmegaG_plot::ProcessEntry(entry);
-        treeRef.Tree->GetEntry(entry);
+        treeRef.GetEntry(entry);
         cuttree::Fill<MCRefHist_t>(cuttreeRef, {treeCommon, treeRef, treeMCWeighting});
     }
 };
@@ -744,8 +749,8 @@ struct EtapOmegaG_plot_Sig : EtapOmegaG_plot {
 
     using MCSigPi0Hist_t = MCTrue_Splitter<SigPi0Hist_t>;
     using MCSigOmegaPi0Hist_t = MCTrue_Splitter<SigOmegaPi0Hist_t>;
-    cuttree::Tree_t<MCSigPi0Hist_t>      cuttreeSigPi0;
-    cuttree::Tree_t<MCSigOmegaPi0Hist_t> cuttreeSigOmegaPi0;
+    cuttree::Compiled_t<MCSigPi0Hist_t>      cuttreeSigPi0;
+    cuttree::Compiled_t<MCSigOmegaPi0Hist_t> cuttreeSigOmegaPi0;
 
     EtapOmegaG_plot_Sig(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         EtapOmegaG_plot("Sig", name, input, opts)
@@ -766,9 +771,9 @@ struct EtapOmegaG_plot_Sig : EtapOmegaG_plot {
     virtual void ProcessEntry(const long long entry) override
     {
         EtapOmegaG_plot::ProcessEntry(entry);
-        treeSigShared.Tree->GetEntry(entry);
-        treeSigPi0.Tree->GetEntry(entry);
-        treeSigOmegaPi0.Tree->GetEntry(entry);
+        treeSigShared.GetEntry(entry);
+        treeSigPi0.GetEntry(entry);
+        treeSigOmegaPi0.GetEntry(entry);
         cuttree::Fill<MCSigPi0Hist_t>(cuttreeSigPi0, {treeCommon, treeSigShared, treeSigPi0, treeMCWeighting});
         if(cuttreeSigOmegaPi0)
             cuttree::Fill<MCSigOmegaPi0Hist_t>(cuttreeSigOmegaPi0, {treeCommon, treeSigShared, treeSigOmegaPi0, treeMCWeighting});
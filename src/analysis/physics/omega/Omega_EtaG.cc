@@ -1715,7 +1715,7 @@ public:
     long long GetNumEntries() const override { return t->GetEntries(); }
     void ProcessEntry(const long long entry) override;
 
-    plot::cuttree::Tree_t<MCTrue_Splitter<OmegaHist_t>> signal_hists;
+    plot::cuttree::Compiled_t<MCTrue_Splitter<OmegaHist_t>> signal_hists;
     OmegaHist_t::Tree_t tree;
 
 
@@ -358,13 +358,13 @@ void singlePi0::Finish()
 
     for ( long long en = 0 ; en < seenSignal.Tree->GetEntries() ; ++en )
     {
-        seenSignal.Tree->GetEntry(en);
+        seenSignal.GetEntry(en);
         hist_seen->Fill(seenSignal.TaggerBin(), seenSignal.CosThetaPi0());
     }
 
     for ( long long en = 0 ; en < recSignal.Tree->GetEntries() ; ++en )
     {
-        recSignal.Tree->GetEntry(en);
+        recSignal.GetEntry(en);
         hist_rec->Fill(recSignal.TaggerBin(), recSignal.CosThetaPi0());
     }
 
@@ -545,7 +545,7 @@ void singlePi0MCTrue::Finish()
 
     for ( long long en = 0 ; en < tree.Tree->GetEntries() ; en ++)
     {
-        tree.Tree->GetEntry(en);
+        tree.GetEntry(en);
         const auto cthetaPi0 = tree.theta_pi0_coms();
 
         fillHists(theta_p_labVStheta_pi0_coms,
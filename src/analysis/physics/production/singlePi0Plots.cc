@@ -536,7 +536,7 @@ protected:
 
     };
 
-    plot::cuttree::Tree_t<MCTrue_Splitter<SinglePi0Hist_t>> signal_hists;
+    plot::cuttree::Compiled_t<MCTrue_Splitter<SinglePi0Hist_t>> signal_hists;
 
 
     TTree* t = nullptr;
@@ -625,6 +625,8 @@ public:
 
     virtual void ShowResult() override{}
 
+    virtual bool IsParallel() const override { return true; }
+
     virtual ~singlePi0_Plot(){}
 
 };
@@ -435,7 +435,7 @@ protected:
 
     };
 
-    plot::cuttree::Tree_t<MCTrue_Splitter<TriplePi0Hist_t>> signal_hists;
+    plot::cuttree::Compiled_t<MCTrue_Splitter<TriplePi0Hist_t>> signal_hists;
 
     static const string data_name;
     static const double binScale;
@@ -513,6 +513,8 @@ public:
     virtual void Finish() override{}
     virtual void ShowResult() override{}
 
+    virtual bool IsParallel() const override { return true; }
+
     virtual ~triplePi0_Plot(){}
 
 };
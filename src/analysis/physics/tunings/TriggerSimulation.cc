@@ -73,6 +73,7 @@ void TriggerSimulation::ProcessEvent(const TEvent& event, manager_t&)
     t.IsMC = recon.ID.isSet(TID::Flags_t::MC);
     t.Triggered = triggersimu.HasTriggered();
     t.CBEnergySum = triggersimu.GetCBEnergySum();
+    t.CBMultiplicity = triggersimu.GetCBMultiplicity();
 
     h_CBESum_raw->Fill(triggersimu.GetCBEnergySum());
     h_CBTiming->Fill(triggersimu.GetRefTiming());
@@ -267,7 +268,7 @@ struct TriggerSimulation_plot : Plotter {
 
     Hist_t::Tree_t tree;
 
-    cuttree::Tree_t<DataMC_Splitter> mycuttree;
+    cuttree::Compiled_t<DataMC_Splitter> mycuttree;
 
     TriggerSimulation_plot(const string& name, const WrapTFileInput& input, OptionsPtr opts) :
         Plotter(name, input, opts)
@@ -286,13 +287,13 @@ struct TriggerSimulation_plot : Plotter {
 
     virtual void ProcessEntry(const long long entry) override
     {
-        tree.Tree->GetEntry(entry);
+        tree.GetEntry(entry);
         cuttree::Fill<DataMC_Splitter>(mycuttree, tree);
     }
 
     virtual void ShowResult() override {
         canvas c(GetName());
-        mycuttree->Get().Hist.Draw(c);
+        mycuttree.GetTree()->Get().Hist.Draw(c);
         c << endc;
     }
 
@@ -17,6 +17,7 @@ public:
         ADD_BRANCH_T(bool,   IsMC)
         ADD_BRANCH_T(bool,   Triggered)
         ADD_BRANCH_T(double, CBEnergySum)
+        ADD_BRANCH_T(unsigned, CBMultiplicity)
 
         ADD_BRANCH_T(double,   TaggW)
         ADD_BRANCH_T(double,   TaggT)
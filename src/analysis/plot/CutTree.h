@@ -13,6 +13,11 @@
 #include <map>
 #include <string>
 #include <functional>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
 
 namespace ant {
 namespace analysis {
@@ -138,6 +143,190 @@ void Fill(Tree_t<Hist_t> cuttree, const Fill_t& f) {
     }
 }
 
+/**
+ * @brief The Compiled_t class fills a tree made by Make without walking it recursively
+ *
+ * All branches of such a tree have the same cuts at the same level, so each of those
+ * distinct cuts is evaluated once per entry into a bitmask of its level,
+ * instead of once per node. The nodes are then visited in a flat depth-first list,
+ * skipping the subtrees of failed nodes.
+ * As in the recursive Fill, the cuts of a level are only evaluated if a node of the level
+ * above passed, so cuts may still rely on previous levels.
+ *
+ * Can be assigned from the result of Make, so replacing Tree_t by Compiled_t is enough.
+ */
+template<typename Hist_t>
+class Compiled_t {
+public:
+    using Fill_t = typename Hist_t::Fill_t;
+
+    Compiled_t() = default;
+    Compiled_t(Tree_t<Hist_t> tree);
+
+    explicit operator bool() const { return cuttree != nullptr; }
+    const Tree_t<Hist_t>& GetTree() const { return cuttree; }
+
+    void Fill(const Fill_t& f);
+
+    /**
+     * @brief Fill a range of entries, evaluating the cuts for blocks of up to 64 entries at once
+     * @note the entries of a block are all alive at the same time, they must not refer
+     * to the same buffer (like the current entry of a tree), and the histograms are
+     * filled node by node instead of entry by entry
+     */
+    template<typename It>
+    void Fill(It first, It last);
+
+private:
+    using mask_t = std::uint64_t;
+    static constexpr std::size_t MaxCuts = 64;
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    struct node_t {
+        Hist_t*     Hist;
+        std::size_t Level;
+        std::size_t Cut;    // index of cut within level
+        std::size_t Parent; // index of parent node, npos for root
+        std::size_t Skip;   // index of next node not in the subtree
+    };
+
+    Tree_t<Hist_t> cuttree;
+    std::vector<std::vector<typename Cut_t<Fill_t>::Passes_t>> levels;
+    std::vector<node_t> nodes; // depth-first order
+    std::vector<std::vector<std::size_t>> levelNodes;
+
+    // buffers, re-used for each entry
+    std::vector<mask_t> passed;
+    std::vector<bool> evaluated;
+
+    void flatten(const Tree_t<Hist_t>& node, std::size_t level, std::size_t cut, std::size_t parent);
+};
+
+template<typename Hist_t>
+Compiled_t<Hist_t>::Compiled_t(Tree_t<Hist_t> tree) :
+    cuttree(tree)
+{
+    if(!cuttree)
+        return;
+    // the first branch tells the cuts of each level
+    for(auto node = cuttree; ; node = node->Daughters().front()) {
+        levels.emplace_back();
+        if(node->GetParent()) {
+            for(const auto& d : node->GetParent()->Daughters())
+                levels.back().emplace_back(d->Get().PassesCut);
+        }
+        else {
+            levels.back().emplace_back(node->Get().PassesCut);
+        }
+        if(levels.back().size() > MaxCuts)
+            throw std::runtime_error("Cannot compile cut tree with more than 64 cuts in one level");
+        if(node->IsLeaf())
+            break;
+    }
+    levelNodes.resize(levels.size());
+    flatten(cuttree, 0, 0, npos);
+    passed.resize(levels.size());
+    evaluated.resize(levels.size());
+}
+
+template<typename Hist_t>
+void Compiled_t<Hist_t>::flatten(const Tree_t<Hist_t>& node, std::size_t level, std::size_t cut, std::size_t parent)
+{
+    if(level >= levels.size() || (level > 0 && node->GetParent()->Daughters().size() != levels[level].size()))
+        throw std::runtime_error("Cannot compile cut tree with different cuts in its branches");
+
+    const auto index = nodes.size();
+    nodes.emplace_back(node_t{std::addressof(node->Get().Hist), level, cut, parent, npos});
+    levelNodes[level].push_back(index);
+
+    std::size_t daughter_cut = 0;
+    for(const auto& d : node->Daughters())
+        flatten(d, level+1, daughter_cut++, index);
+
+    nodes[index].Skip = nodes.size();
+}
+
+template<typename Hist_t>
+void Compiled_t<Hist_t>::Fill(const Fill_t& f)
+{
+    std::fill(evaluated.begin(), evaluated.end(), false);
+
+    for(std::size_t i=0;i<nodes.size();) {
+        const auto& node = nodes[i];
+        // visiting a node means its parent passed
+        if(!evaluated[node.Level]) {
+            mask_t mask = 0;
+            const auto& cuts = levels[node.Level];
+            for(std::size_t c=0;c<cuts.size();c++) {
+                if(cuts[c](f))
+                    mask |= mask_t(1) << c;
+            }
+            passed[node.Level] = mask;
+            evaluated[node.Level] = true;
+        }
+        if(passed[node.Level] & (mask_t(1) << node.Cut)) {
+            node.Hist->Fill(f);
+            ++i;
+        }
+        else {
+            i = node.Skip;
+        }
+    }
+}
+
+template<typename Hist_t>
+template<typename It>
+void Compiled_t<Hist_t>::Fill(It first, It last)
+{
+    std::vector<const Fill_t*> block;
+    block.reserve(MaxCuts);
+    std::vector<mask_t> cutmasks;
+    std::vector<mask_t> alive(nodes.size());
+
+    while(first != last) {
+        block.clear();
+        for(; first != last && block.size() < MaxCuts; ++first)
+            block.push_back(std::addressof(*first));
+
+        // bit e of the masks stands for entry e of the block
+        mask_t levelAlive = block.size() == MaxCuts ? ~mask_t(0) : (mask_t(1) << block.size()) - 1;
+        for(std::size_t level=0;level<levels.size();level++) {
+            const auto& cuts = levels[level];
+            cutmasks.assign(cuts.size(), 0);
+            if(levelAlive) {
+                for(std::size_t c=0;c<cuts.size();c++) {
+                    for(std::size_t e=0;e<block.size();e++) {
+                        const mask_t bit = mask_t(1) << e;
+                        if((levelAlive & bit) && cuts[c](*block[e]))
+                            cutmasks[c] |= bit;
+                    }
+                }
+            }
+            mask_t nextAlive = 0;
+            for(auto i : levelNodes[level]) {
+                const auto& node = nodes[i];
+                alive[i] = cutmasks[node.Cut] & (node.Parent == npos ? levelAlive : alive[node.Parent]);
+                nextAlive |= alive[i];
+            }
+            levelAlive = nextAlive;
+        }
+
+        for(std::size_t i=0;i<nodes.size();i++) {
+            if(!alive[i])
+                continue;
+            for(std::size_t e=0;e<block.size();e++) {
+                if(alive[i] & (mask_t(1) << e))
+                    nodes[i].Hist->Fill(*block[e]);
+            }
+        }
+    }
+}
+
+template<typename Hist_t, typename Fill_t = typename Hist_t::Fill_t>
+void Fill(Compiled_t<Hist_t>& compiled, const Fill_t& f) {
+    compiled.Fill(f);
+}
+
 template<typename Hist_t>
 struct StackedHists_t {
 public:
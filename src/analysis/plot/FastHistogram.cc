@@ -0,0 +1,168 @@
+#include "FastHistogram.h"
+
+#include "TH1D.h"
+#include "TH2D.h"
+#include "TH3D.h"
+#include "TAxis.h"
+
+#include "base/Logger.h"
+
+#include <algorithm>
+#include <mutex>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+void detail::FastHistograms::Materialize()
+{
+    for(auto& h : *this)
+        h->Materialize();
+}
+
+detail::FastHistograms::~FastHistograms()
+{
+    // the ROOT histograms are owned by their directory and might be gone already
+    const auto n = count_if(begin(), end(), [] (const unique_ptr<FastHistogram_traits>& h) {
+        return !h->IsMaterialized();
+    });
+    if(n>0)
+        LOG(WARNING) << "Content of " << n << " fast histograms was not materialized and is lost";
+}
+
+namespace {
+
+struct thread_indices_t {
+    std::mutex Mutex;
+    std::vector<unsigned> Free;
+    unsigned Next = 0;
+};
+
+thread_indices_t& GetThreadIndices() {
+    static thread_indices_t indices;
+    return indices;
+}
+
+const TAxis* GetAxis(const TH1* h, unsigned i) {
+    return i == 0 ? h->GetXaxis() : i == 1 ? h->GetYaxis() : h->GetZaxis();
+}
+
+}
+
+detail::ThreadIndex_t::ThreadIndex_t() :
+    Index([] () {
+        auto& indices = GetThreadIndices();
+        lock_guard<mutex> lock(indices.Mutex);
+        if(indices.Free.empty())
+            return indices.Next++;
+        // prefer small indices
+        auto it = min_element(indices.Free.begin(), indices.Free.end());
+        const auto index = *it;
+        indices.Free.erase(it);
+        return index;
+    }())
+{}
+
+detail::ThreadIndex_t::~ThreadIndex_t()
+{
+    // the mutex also makes the shard's content visible to the next thread using it
+    auto& indices = GetThreadIndices();
+    lock_guard<mutex> lock(indices.Mutex);
+    indices.Free.push_back(Index);
+}
+
+template<unsigned N, typename TH>
+constexpr unsigned FastHistogram<N, TH>::MaxThreads;
+
+template<unsigned N, typename TH>
+FastHistogram<N, TH>::FastHistogram(TH* hist_) :
+    hist(hist_),
+    nBins(1)
+{
+    for(unsigned i=0;i<N;i++) {
+        auto axis = GetAxis(hist, i);
+        if(axis->GetXbins()->GetSize() > 0)
+            throw Exception(string("FastHistogram needs uniform binning, but ")+hist->GetName()+" has variable bins");
+        axes[i] = {axis->GetNbins(), axis->GetXmin(), axis->GetXmax()};
+        nBins *= axes[i].Bins+2;
+    }
+    for(auto& s : shards)
+        s.store(nullptr);
+}
+
+template<unsigned N, typename TH>
+FastHistogram<N, TH>::~FastHistogram()
+{
+    for(auto& s : shards)
+        delete s.load();
+}
+
+template<unsigned N, typename TH>
+void FastHistogram<N, TH>::shard_t::Reset()
+{
+    std::fill(SumW.begin(), SumW.end(), 0.0);
+    std::fill(SumW2.begin(), SumW2.end(), 0.0);
+    Stats.fill(0);
+    Entries = 0;
+    Weighted = false;
+}
+
+template<unsigned N, typename TH>
+bool FastHistogram<N, TH>::IsMaterialized() const
+{
+    return none_of(shards.begin(), shards.end(), [] (const atomic<shard_t*>& s_) {
+        auto s = s_.load(memory_order_acquire);
+        return s != nullptr && s->Entries > 0;
+    });
+}
+
+template<unsigned N, typename TH>
+void FastHistogram<N, TH>::Materialize()
+{
+    // do not touch the histogram if there's nothing to add
+    if(IsMaterialized())
+        return;
+
+    // GetStats before touching the contents,
+    // as it may calculate the statistics from them
+    array<double, TH1::kNstat> stats;
+    stats.fill(0);
+    hist->GetStats(stats.data());
+    double entries = hist->GetEntries();
+
+    for(auto& s_ : shards) {
+        auto s = s_.load(memory_order_acquire);
+        if(s == nullptr || s->Entries == 0)
+            continue;
+
+        // as TH1::Fill, switch to errors when filled with weights
+        if(s->Weighted && hist->GetSumw2N() == 0)
+            hist->Sumw2();
+
+        auto contents = hist->GetArray();
+        for(size_t bin=0;bin<nBins;bin++)
+            contents[bin] += s->SumW[bin];
+
+        if(hist->GetSumw2N() > 0) {
+            auto sumw2 = hist->GetSumw2()->GetArray();
+            for(size_t bin=0;bin<nBins;bin++)
+                sumw2[bin] += s->SumW2[bin];
+        }
+
+        for(unsigned i=0;i<NStats;i++)
+            stats[i] += s->Stats[i];
+        entries += s->Entries;
+
+        s->Reset();
+    }
+
+    hist->PutStats(stats.data());
+    hist->SetEntries(entries);
+}
+
+namespace ant {
+namespace analysis {
+template class FastHistogram<1, TH1D>;
+template class FastHistogram<2, TH2D>;
+template class FastHistogram<3, TH3D>;
+}}
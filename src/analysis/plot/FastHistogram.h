@@ -0,0 +1,241 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+class TH1D;
+class TH2D;
+class TH3D;
+
+namespace ant {
+namespace analysis {
+
+namespace detail {
+
+struct FastHistogram_traits {
+    virtual void Materialize() = 0;
+    virtual bool IsMaterialized() const = 0;
+    virtual ~FastHistogram_traits() = default;
+};
+
+// the list is shared among a HistogramFactory and its children,
+// it must be materialized explicitly while the ROOT histograms still exist
+struct FastHistograms : std::list<std::unique_ptr<FastHistogram_traits>> {
+    void Materialize();
+    ~FastHistograms();
+};
+
+// small number for each thread using fast histograms,
+// given back when the thread exits so that later threads can reuse it
+struct ThreadIndex_t {
+    const unsigned Index;
+    ThreadIndex_t();
+    ~ThreadIndex_t();
+    ThreadIndex_t(const ThreadIndex_t&) = delete;
+    ThreadIndex_t& operator=(const ThreadIndex_t&) = delete;
+};
+
+inline unsigned GetThreadIndex() noexcept {
+    static thread_local const ThreadIndex_t index;
+    return index.Index;
+}
+
+}
+
+/**
+ * @brief The FastHistogram class is a lightweight accumulator for a uniformly binned ROOT histogram
+ *
+ * Filling is non-virtual and does the same bin lookup as TAxis::FindBin, so results are identical
+ * to filling the ROOT histogram directly. Each thread fills its own shard without any locking.
+ * The shards are added to the ROOT histogram by Materialize(), which must not run concurrently to
+ * any Fill. HistogramFactory does that for all its fast histograms before Physics::Finish().
+ * Content which was not materialized is lost, as the ROOT histogram may be gone at destruction.
+ *
+ * At most MaxThreads threads may fill at the same time, the shard of a finished thread
+ * is reused by the next one.
+ */
+template<unsigned N, typename TH>
+class FastHistogram : public detail::FastHistogram_traits {
+public:
+    static constexpr unsigned MaxThreads = 64;
+
+    // the histogram must be uniformly binned
+    explicit FastHistogram(TH* hist_);
+    virtual ~FastHistogram();
+    FastHistogram(const FastHistogram&) = delete;
+    FastHistogram& operator=(const FastHistogram&) = delete;
+
+    /**
+     * @brief Get the ROOT histogram, filled up to the last Materialize()
+     */
+    TH* Get() const noexcept { return hist; }
+
+    virtual void Materialize() override;
+    virtual bool IsMaterialized() const override;
+
+    struct Exception : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+protected:
+    // number of statistics as provided by TH1::GetStats
+    static constexpr unsigned NStats = N == 1 ? 4 : N == 2 ? 7 : 11;
+
+    struct axis_t {
+        int    Bins;
+        double Min;
+        double Max;
+
+        // same as TAxis::FindBin for fixed bins
+        int FindBin(double x) const noexcept {
+            if(x < Min)
+                return 0;
+            if(!(x < Max))
+                return Bins+1;
+            return 1 + int(Bins*(x-Min)/(Max-Min));
+        }
+    };
+
+    struct shard_t {
+        std::vector<double> SumW;  // in global bin numbering of ROOT
+        std::vector<double> SumW2;
+        std::array<double, NStats> Stats;
+        double Entries = 0;
+        bool   Weighted = false;
+
+        explicit shard_t(std::size_t nBins) : SumW(nBins), SumW2(nBins) { Stats.fill(0); }
+        void Reset();
+    };
+
+    TH* const hist;
+    std::array<axis_t, N> axes;
+    std::size_t nBins; // including under/overflow
+    std::array<std::atomic<shard_t*>, MaxThreads> shards;
+
+    // each thread only touches its own shard, so creating it does not need a lock
+    shard_t& shard() {
+        const auto index = detail::GetThreadIndex();
+        if(index >= MaxThreads)
+            throw Exception("Too many threads for FastHistogram");
+        auto s = shards[index].load(std::memory_order_relaxed);
+        if(s == nullptr) {
+            s = new shard_t(nBins);
+            shards[index].store(s, std::memory_order_release);
+        }
+        return *s;
+    }
+
+    static void add_stats(std::array<double, 4>& st, const double* x, double w) noexcept {
+        st[0] += w;
+        st[1] += w*w;
+        st[2] += w*x[0];
+        st[3] += w*x[0]*x[0];
+    }
+    static void add_stats(std::array<double, 7>& st, const double* x, double w) noexcept {
+        st[0] += w;
+        st[1] += w*w;
+        st[2] += w*x[0];
+        st[3] += w*x[0]*x[0];
+        st[4] += w*x[1];
+        st[5] += w*x[1]*x[1];
+        st[6] += w*x[0]*x[1];
+    }
+    static void add_stats(std::array<double, 11>& st, const double* x, double w) noexcept {
+        st[0]  += w;
+        st[1]  += w*w;
+        st[2]  += w*x[0];
+        st[3]  += w*x[0]*x[0];
+        st[4]  += w*x[1];
+        st[5]  += w*x[1]*x[1];
+        st[6]  += w*x[0]*x[1];
+        st[7]  += w*x[2];
+        st[8]  += w*x[2]*x[2];
+        st[9]  += w*x[0]*x[2];
+        st[10] += w*x[1]*x[2];
+    }
+
+    void fill(shard_t& s, const std::array<double, N>& x, double w) noexcept {
+        s.Entries += 1;
+        s.Weighted |= w != 1.0;
+
+        std::size_t bin = 0;
+        bool inRange = true;
+        for(unsigned i=N;i-->0;) {
+            const auto& axis = axes[i];
+            const int b = axis.FindBin(x[i]);
+            inRange &= b > 0 && b <= axis.Bins;
+            bin = bin*(axis.Bins+2) + b;
+        }
+        s.SumW[bin] += w;
+        s.SumW2[bin] += w*w;
+
+        // statistics exclude under/overflows as in TH1::Fill
+        if(!inRange)
+            return;
+        add_stats(s.Stats, x.data(), w);
+    }
+};
+
+class FastTH1D : public FastHistogram<1, TH1D> {
+public:
+    using FastHistogram::FastHistogram;
+
+    void Fill(double x, double w = 1.0) {
+        fill(shard(), {{x}}, w);
+    }
+    void Fill(const std::vector<double>& x) {
+        auto& s = shard();
+        for(auto v : x)
+            fill(s, {{v}}, 1.0);
+    }
+    void Fill(const std::vector<double>& x, const std::vector<double>& w) {
+        auto& s = shard();
+        for(std::size_t i=0;i<x.size();i++)
+            fill(s, {{x[i]}}, w[i]);
+    }
+};
+
+class FastTH2D : public FastHistogram<2, TH2D> {
+public:
+    using FastHistogram::FastHistogram;
+
+    void Fill(double x, double y, double w = 1.0) {
+        fill(shard(), {{x, y}}, w);
+    }
+    void Fill(const std::vector<double>& x, const std::vector<double>& y) {
+        auto& s = shard();
+        for(std::size_t i=0;i<x.size();i++)
+            fill(s, {{x[i], y[i]}}, 1.0);
+    }
+    void Fill(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& w) {
+        auto& s = shard();
+        for(std::size_t i=0;i<x.size();i++)
+            fill(s, {{x[i], y[i]}}, w[i]);
+    }
+};
+
+class FastTH3D : public FastHistogram<3, TH3D> {
+public:
+    using FastHistogram::FastHistogram;
+
+    void Fill(double x, double y, double z, double w = 1.0) {
+        fill(shard(), {{x, y, z}}, w);
+    }
+    void Fill(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& z) {
+        auto& s = shard();
+        for(std::size_t i=0;i<x.size();i++)
+            fill(s, {{x[i], y[i], z[i]}}, 1.0);
+    }
+    void Fill(const std::vector<double>& x, const std::vector<double>& y, const std::vector<double>& z,
+              const std::vector<double>& w) {
+        auto& s = shard();
+        for(std::size_t i=0;i<x.size();i++)
+            fill(s, {{x[i], y[i], z[i]}}, w[i]);
+    }
+};
+
+}} // namespace ant::analysis
@@ -1,4 +1,5 @@
 #include "HistogramFactory.h"
+#include "FastHistogram.h"
 
 #include "base/std_ext/string.h"
 
@@ -8,6 +9,8 @@
 #include "TH1D.h"
 #include "TH2D.h"
 #include "TH3D.h"
+#include "THStack.h"
+#include "TList.h"
 #include "TMath.h"
 #include "TTree.h"
 
@@ -77,7 +80,8 @@ string HistogramFactory::GetNextName(const string &name, const string& autogener
 }
 
 HistogramFactory::HistogramFactory(const string &directory_name, TDirectory* root, const string& title_prefix_):
-    title_prefix(title_prefix_)
+    title_prefix(title_prefix_),
+    fasthists(make_shared<detail::FastHistograms>())
 {
 
     if(!root)
@@ -100,6 +104,7 @@ HistogramFactory::HistogramFactory(const string& directory_name, const Histogram
                                                     std_ext::formatter() << parent.title_prefix << ": " << title_prefix_))
 
 {
+    fasthists = parent.fasthists;
 }
 
 void HistogramFactory::SetTitlePrefix(const string& title_prefix_)
@@ -218,6 +223,154 @@ TH3D* HistogramFactory::makeTH3D(
     return h;
 }
 
+FastTH1D* HistogramFactory::makeFastTH1D(
+        const string& title,
+        const AxisSettings& x_axis_settings,
+        const string& name, bool sumw2) const
+{
+    auto h = new FastTH1D(makeTH1D(title, x_axis_settings, name, sumw2));
+    fasthists->emplace_back(h);
+    return h;
+}
+
+FastTH2D* HistogramFactory::makeFastTH2D(
+        const string& title,
+        const AxisSettings& x_axis_settings,
+        const AxisSettings& y_axis_settings,
+        const string& name, bool sumw2) const
+{
+    auto h = new FastTH2D(makeTH2D(title, x_axis_settings, y_axis_settings, name, sumw2));
+    fasthists->emplace_back(h);
+    return h;
+}
+
+FastTH3D* HistogramFactory::makeFastTH3D(
+        const string& title,
+        const AxisSettings& x_axis_settings,
+        const AxisSettings& y_axis_settings,
+        const AxisSettings& z_axis_settings,
+        const string& name, bool sumw2) const
+{
+    auto h = new FastTH3D(makeTH3D(title, x_axis_settings, y_axis_settings, z_axis_settings, name, sumw2));
+    fasthists->emplace_back(h);
+    return h;
+}
+
+void HistogramFactory::MaterializeFastHistograms() const
+{
+    fasthists->Materialize();
+}
+
+namespace {
+
+void reset_objects(TDirectory* dir) {
+    TIter next(dir->GetList());
+    while(auto obj = next()) {
+        if(auto subdir = dynamic_cast<TDirectory*>(obj))
+            reset_objects(subdir);
+        else if(auto h = dynamic_cast<TH1*>(obj))
+            h->Reset();
+        else if(auto g = dynamic_cast<TGraph*>(obj))
+            g->Set(0);
+        else if(auto t = dynamic_cast<TTree*>(obj))
+            t->Reset();
+    }
+}
+
+template<typename T>
+bool merge_object(TObject* to, TObject* from) {
+    auto to_ = dynamic_cast<T*>(to);
+    auto from_ = dynamic_cast<T*>(from);
+    if(!to_ || !from_)
+        return false;
+    TList list;
+    list.Add(from_);
+    to_->Merge(addressof(list));
+    return true;
+}
+
+void merge_stack(TDirectory* to, THStack* target, THStack* from) {
+    // stacks refer to their histograms by path, relative to the directory merged into
+    TDirectory::TContext context(to);
+    TList list;
+    list.Add(from);
+    target->Merge(addressof(list), nullptr);
+}
+
+void clone_object(TDirectory* to, TObject* obj) {
+    TDirectory::TContext context(to);
+    if(auto h = dynamic_cast<TH1*>(obj)) {
+        auto clone = dynamic_cast<TH1*>(h->Clone());
+        clone->SetDirectory(to);
+    }
+    else if(auto t = dynamic_cast<TTree*>(obj)) {
+        auto clone = t->CloneTree(-1);
+        // the branch addresses still point to the variables of the other tree
+        clone->ResetBranchAddresses();
+        clone->SetDirectory(to);
+    }
+    else if(auto s = dynamic_cast<THStack*>(obj)) {
+        // a stack is merged into an empty one, which takes over the merged histograms
+        auto clone = static_cast<THStack*>(s->IsA()->New());
+        clone->SetNameTitle(s->GetName(), s->GetTitle());
+        to->Append(clone);
+        merge_stack(to, clone, s);
+    }
+    else {
+        to->Append(obj->Clone());
+    }
+}
+
+TObject* find_target(TDirectory* to, TObject* obj) {
+    auto target = to->GetList()->FindObject(obj->GetName());
+    if(target && target->IsA() != obj->IsA())
+        throw HistogramFactory::Exception(std_ext::formatter() << "Cannot merge " << obj->GetName()
+                                          << " into object of different class in directory " << to->GetPath());
+    return target;
+}
+
+void merge_objects(TDirectory* to, TDirectory* from) {
+    // stacks are merged last, as they refer to the histograms merged before
+    vector<THStack*> stacks;
+    TIter next(from->GetList());
+    while(auto obj = next()) {
+        if(auto s = dynamic_cast<THStack*>(obj)) {
+            stacks.push_back(s);
+            continue;
+        }
+        auto target = find_target(to, obj);
+        if(auto subdir = dynamic_cast<TDirectory*>(obj)) {
+            if(!target)
+                target = to->mkdir(subdir->GetName(), subdir->GetTitle());
+            merge_objects(dynamic_cast<TDirectory*>(target), subdir);
+        }
+        else if(!target)
+            clone_object(to, obj);
+        else if(!merge_object<TH1>(target, obj) && !merge_object<TGraph>(target, obj))
+            merge_object<TTree>(target, obj);
+    }
+    for(auto s : stacks) {
+        if(auto target = find_target(to, s))
+            merge_stack(to, dynamic_cast<THStack*>(target), s);
+        else
+            clone_object(to, s);
+    }
+}
+
+}
+
+void HistogramFactory::ResetObjects() const
+{
+    MaterializeFastHistograms();
+    reset_objects(my_directory);
+}
+
+void HistogramFactory::MergeObjects(const HistogramFactory& other) const
+{
+    other.MaterializeFastHistograms();
+    merge_objects(my_directory, other.my_directory);
+}
+
 TGraph* HistogramFactory::makeGraph(
         const string& title,
         const string& name) const
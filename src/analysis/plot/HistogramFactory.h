@@ -5,6 +5,7 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 
 class TDirectory;
 class TNamed;
@@ -18,6 +19,14 @@ class TGraphErrors;
 namespace ant {
 namespace analysis {
 
+class FastTH1D;
+class FastTH2D;
+class FastTH3D;
+
+namespace detail {
+struct FastHistograms;
+}
+
 class HistogramFactory {
 private:
 
@@ -37,6 +46,9 @@ private:
     mutable unsigned n_unnamed = 0;
     std::string GetNextName(const std::string& name, const std::string& autogenerate_prefix = "hist") const;
 
+    // shared with child factories
+    std::shared_ptr<detail::FastHistograms> fasthists;
+
 
 public:
     struct DirStackPush {
@@ -114,6 +126,57 @@ public:
             const std::string& name="",
             bool  sumw2 = false) const;
 
+    /**
+     * @brief makeFastTH1D creates a histogram as makeTH1D, but returns a fast accumulator for it
+     * @see FastHistogram, the ROOT histogram is filled by MaterializeFastHistograms()
+     */
+    FastTH1D* makeFastTH1D(
+            const std::string& title,
+            const AxisSettings& x_axis_settings,
+            const std::string& name="",
+            bool  sumw2 = false) const;
+
+    FastTH2D* makeFastTH2D(
+            const std::string& title,
+            const AxisSettings& x_axis_settings,
+            const AxisSettings& y_axis_settings,
+            const std::string& name="",
+            bool  sumw2 = false) const;
+
+    FastTH3D* makeFastTH3D(
+            const std::string& title,
+            const AxisSettings& x_axis_settings,
+            const AxisSettings& y_axis_settings,
+            const AxisSettings& z_axis_settings,
+            const std::string& name="",
+            bool  sumw2 = false) const;
+
+    /**
+     * @brief MaterializeFastHistograms adds the content of all fast histograms of this factory,
+     * its parents and children to their ROOT histograms
+     * @note must not run concurrently to filling, and must be called before the ROOT histograms
+     * are used or their directory is deleted, content not materialized then is lost
+     */
+    void MaterializeFastHistograms() const;
+
+    /**
+     * @brief ResetObjects clears the contents of all histograms, graphs and trees
+     * in the directory of this factory and its subdirectories
+     */
+    void ResetObjects() const;
+
+    /**
+     * @brief MergeObjects adds the histograms, graphs, trees and stacks of the other factory
+     * to the ones of this factory with the same name, also in subdirectories
+     *
+     * Objects only the other factory has made, for example lazily created ones, are copied.
+     * Stacks are merged last and then refer to the histograms of this factory.
+     * @param other factory which made its objects the same way, in a different root directory
+     * @note the fast histograms of the other factory are materialized before,
+     * other objects are left as they are
+     */
+    void MergeObjects(const HistogramFactory& other) const;
+
     TGraph* makeGraph(
             const std::string& title,
             const std::string& name="") const;
@@ -2,6 +2,8 @@
 
 #include "expconfig/ExpConfig.h"
 
+#include <algorithm>
+
 using namespace ant;
 using namespace ant::analysis;
 using namespace ant::analysis::PromptRandom;
@@ -37,6 +39,32 @@ void Switch::update_ratio() {
     } else {
         ratio = p/r;
     }
+    update_lookup();
+}
+
+void Switch::update_lookup() {
+    boundaries.clear();
+    for(const windows_t* windows : {&promptw, &randomw}) {
+        for(const auto& i : *windows) {
+            boundaries.push_back(i.Start());
+            boundaries.push_back(i.Stop());
+        }
+    }
+    sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    // the case is constant between two boundaries
+    segments.clear();
+    for(size_t i=1;i<boundaries.size();i++)
+        segments.push_back(classify((boundaries[i-1]+boundaries[i])/2.0));
+}
+
+Case Switch::classify(double tagtime) const {
+    if(randomw.Contains(tagtime))
+        return Case::Random;
+    if(promptw.Contains(tagtime))
+        return Case::Prompt;
+    return Case::Outside;
 }
 
 Switch::Switch(const expconfig::Setup_traits& setup) :
@@ -56,17 +84,35 @@ void Switch::AddRandomRange(const Switch::interval_t& i) {
     update_ratio();
 }
 
-void Switch::SetTaggerTime(const double tagtime) {
+Switch::weight_t Switch::GetWeight(const double tagtime) const {
 
-    if(randomw.Contains(tagtime)) {
-        rpcase = Case::Random;
-        fillw = -Ratio();
-    } else if(promptw.Contains(tagtime)) {
-        rpcase = Case::Prompt;
-        fillw = 1.0;
-    } else {
-        rpcase = Case::Outside;
-        fillw = 0.0;
+    Case c = Case::Outside;
+    auto it = upper_bound(boundaries.begin(), boundaries.end(), tagtime);
+    if(it != boundaries.begin() && *prev(it) == tagtime) {
+        // exactly on a boundary, which belongs to the closed windows
+        c = classify(tagtime);
+    }
+    else if(it != boundaries.begin() && it != boundaries.end()) {
+        c = segments[distance(boundaries.begin(), it)-1];
+    }
+
+    switch(c) {
+    case Case::Random:
+        return {c, -Ratio()};
+    case Case::Prompt:
+        return {c, 1.0};
+    case Case::Outside:
+        break;
     }
+    return {Case::Outside, 0.0};
+}
+
+void Switch::GetWeights(const std::vector<double>& tagtimes, std::vector<weight_t>& weights) const {
+    weights.resize(tagtimes.size());
+    for(size_t i=0;i<tagtimes.size();i++)
+        weights[i] = GetWeight(tagtimes[i]);
+}
 
+void Switch::SetTaggerTime(const double tagtime) {
+    SetWeight(GetWeight(tagtime));
 }
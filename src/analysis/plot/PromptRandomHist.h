@@ -9,6 +9,7 @@
 #include "TH2D.h"
 
 #include <string>
+#include <vector>
 
 namespace ant {
 
@@ -38,6 +39,12 @@ protected:
 
     void update_ratio();
 
+    // windows compiled into sorted boundaries with the case in between
+    std::vector<double> boundaries;
+    std::vector<Case>   segments;
+    void update_lookup();
+    Case classify(double tagtime) const;
+
     Case rpcase = Case::Prompt;
     double fillw = 1.0;
 
@@ -70,6 +77,30 @@ public:
 
     void SetTaggerTime(double tagtime);
 
+    struct weight_t {
+        Case   State;
+        double FillWeight;
+    };
+
+    /**
+     * @brief GetWeight classifies the tagger time without changing the state of the switch
+     */
+    weight_t GetWeight(double tagtime) const;
+
+    /**
+     * @brief GetWeights classifies all tagger times of an event at once
+     * @param tagtimes usually the corrected tagger times of the tagger hits
+     * @param weights resized to size of tagtimes
+     */
+    void GetWeights(const std::vector<double>& tagtimes, std::vector<weight_t>& weights) const;
+
+    /**
+     * @brief SetWeight sets the state from a previously obtained weight
+     */
+    void SetWeight(const weight_t& w) {
+        rpcase = w.State;
+        fillw = w.FillWeight;
+    }
 
 };
 
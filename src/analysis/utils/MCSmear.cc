@@ -9,8 +9,8 @@ using namespace std;
 using namespace ant;
 using namespace ant::analysis::utils;
 
-MCSmear::MCSmear(utils::UncertaintyModelPtr m):
-    model(m), rng(std_ext::make_unique<TRandom2>()) {}
+MCSmear::MCSmear(utils::UncertaintyModelPtr m, CounterRNG::key_t seed_):
+    model(m), rng(std_ext::make_unique<TRandom2>()), seed(seed_) {}
 
 MCSmear::~MCSmear() {}
 
@@ -55,3 +55,76 @@ TParticlePtr MCSmear::Smear(const TParticlePtr& p) const
     Uncertainties_t sigmas;
     return Smear(p, sigmas);
 }
+
+void MCSmear::particles_t::resize(size_t n)
+{
+    for(auto v : {&Ek, &Theta, &Phi, &sigmaEk, &sigmaTheta, &sigmaPhi})
+        v->resize(n);
+}
+
+void MCSmear::Smear(particles_t& particles, CounterRNG& rng)
+{
+    const auto n = particles.size();
+
+    // deviates for Ek, Theta, Phi interleaved per particle
+    static thread_local vector<double> deviates;
+    deviates.resize(3*n);
+    rng.Gaus(deviates);
+
+    auto d = deviates.data();
+    for(size_t i=0;i<n;i++, d+=3) {
+        particles.Ek[i]    += particles.sigmaEk[i]*d[0];
+        particles.Theta[i] += particles.sigmaTheta[i]*d[1];
+        particles.Phi[i]   += particles.sigmaPhi[i]*d[2];
+    }
+}
+
+TParticleList MCSmear::Smear(const TParticleList& particles, uint64_t eventNumber) const
+{
+    const auto n = particles.size();
+
+    static thread_local particles_t soa;
+    soa.resize(n);
+
+    for(size_t i=0;i<n;i++) {
+        const auto& p = particles[i];
+        soa.Ek[i]    = p->Ek();
+        soa.Theta[i] = p->Theta();
+        soa.Phi[i]   = p->Phi();
+        if(p->Type() == ParticleTypeDatabase::BeamTarget) {
+            // only the photon energy is smeared, see Smear(const TParticlePtr&)
+            soa.sigmaEk[i] = model->GetBeamEnergySigma(p->Ek());
+            soa.sigmaTheta[i] = 0;
+            soa.sigmaPhi[i] = 0;
+        }
+        else {
+            const auto sigmas = model->GetSigmas(*p);
+            soa.sigmaEk[i]    = sigmas.sigmaEk;
+            soa.sigmaTheta[i] = sigmas.sigmaTheta;
+            soa.sigmaPhi[i]   = sigmas.sigmaPhi;
+        }
+    }
+
+    CounterRNG crng(seed, eventNumber);
+    Smear(soa, crng);
+
+    TParticleList smeared;
+    smeared.reserve(n);
+    for(size_t i=0;i<n;i++) {
+        const auto& p = particles[i];
+        const auto& type = p->Type();
+        if(type == ParticleTypeDatabase::BeamTarget) {
+            const double Ek = soa.Ek[i];
+            smeared.emplace_back(make_shared<TParticle>(
+                                     type,
+                                     LorentzVec::EPThetaPhi(Ek + type.Mass(), Ek, soa.Theta[i], soa.Phi[i])
+                                     ));
+        }
+        else {
+            auto particle = make_shared<TParticle>(type, soa.Ek[i], soa.Theta[i], soa.Phi[i]);
+            particle->Candidate = p->Candidate;
+            smeared.emplace_back(move(particle));
+        }
+    }
+    return smeared;
+}
@@ -1,8 +1,11 @@
 #pragma once
 #include <memory>
+#include <vector>
+#include <cstdint>
 #include "analysis/utils/Uncertainties.h"
 #include "tree/TParticle.h"
 #include "tree/TCandidate.h"
+#include "base/CounterRNG.h"
 
 class TRandom;
 
@@ -14,10 +17,16 @@ class MCSmear {
 protected:
     UncertaintyModelPtr model;
     std::unique_ptr<TRandom> rng;
+    const CounterRNG::key_t seed;
 
 public:
 
-    MCSmear(UncertaintyModelPtr m);
+    /**
+     * @brief MCSmear
+     * @param m the model providing the sigmas
+     * @param seed_ key for the counter-based generator used by the batch methods
+     */
+    MCSmear(UncertaintyModelPtr m, CounterRNG::key_t seed_ = 0);
 
     ~MCSmear();
 
@@ -25,6 +34,36 @@ public:
 
     ant::TParticlePtr  Smear(const ant::TParticlePtr& p, Uncertainties_t& sigmas) const;
 
+    /**
+     * @brief The particles_t struct holds kinematics and sigmas as structure of arrays
+     */
+    struct particles_t {
+        std::vector<double> Ek;
+        std::vector<double> Theta;
+        std::vector<double> Phi;
+        std::vector<double> sigmaEk;
+        std::vector<double> sigmaTheta;
+        std::vector<double> sigmaPhi;
+
+        std::size_t size() const { return Ek.size(); }
+        void resize(std::size_t n);
+    };
+
+    /**
+     * @brief Smear smears all particles in place, drawing all gaussian deviates at once
+     * @param particles zero sigmas leave the value untouched
+     * @param rng positioned at the stream to use, for example the event number
+     */
+    static void Smear(particles_t& particles, CounterRNG& rng);
+
+    /**
+     * @brief Smear all particles of an event
+     * @param particles the unsmeared particles
+     * @param eventNumber the stream of the counter-based generator, so the result is reproducible per event
+     * @return the smeared particles, in the same order
+     */
+    ant::TParticleList Smear(const ant::TParticleList& particles, std::uint64_t eventNumber) const;
+
 
 };
 
@@ -206,7 +206,7 @@ void MCWeighting::Finish()
     t_norm.CreateBranches(HistFac.makeTTree(treeName));
 
     for(auto entry = 0;entry<t.Tree->GetEntries(); entry++) {
-        t.Tree->GetEntry(entry);
+        t.GetEntry(entry);
         t_norm.MCWeight = isfinite(t.MCWeight) ? (t.MCWeight * nParticleTrees)/N_sum : 1.0;
         t_norm.Tree->Fill();
     }
@@ -1,4 +1,5 @@
 #include "ParticleID.h"
+#include "PolygonCut.h"
 
 #include "tree/TParticle.h"
 
@@ -27,6 +28,23 @@ TParticlePtr ParticleID::Process(const TCandidatePtr& cand) const
     return nullptr;
 }
 
+void ParticleID::IdentifyAll(const TCandidatePtrList& cands, types_t& types) const
+{
+    types.resize(cands.size());
+    for(size_t i=0;i<cands.size();++i)
+        types[i] = Identify(cands[i]);
+}
+
+void ParticleID::ProcessAll(const TCandidatePtrList& cands, particles_t& particles) const
+{
+    // re-used by the following events of the thread
+    thread_local types_t types;
+    IdentifyAll(cands, types);
+    particles.resize(cands.size());
+    for(size_t i=0;i<cands.size();++i)
+        particles[i] = types[i] ? std::make_shared<TParticle>(*types[i], cands[i]) : nullptr;
+}
+
 std::unique_ptr<const ParticleID> ParticleID::default_particle_id = nullptr;
 
 const ParticleID& ParticleID::GetDefault()
@@ -60,23 +78,50 @@ BasicParticleID::~BasicParticleID()
 
 }
 
-bool TestCut(const std::shared_ptr<TCutG>& cut, const double& x, const double& y) {
-    return (cut) && cut->IsInside(x,y);
+void BasicParticleID::compiled_cut_t::Compile(const std::shared_ptr<TCutG>& cutg)
+{
+    source = cutg;
+    cut = cutg ? std::make_shared<const PolygonCut>(*cutg) : nullptr;
 }
 
-
-
-const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr& cand) const
+bool BasicParticleID::compiled_cut_t::Test(const std::shared_ptr<TCutG>& cutg, double x, double y) const
 {
-    const bool hadronic =    TestCut(tof,  cand->CaloEnergy, cand->Time)
-                  || TestCut(size, cand->CaloEnergy, cand->ClusterSize);
-
-    const bool hadronic_enabled = (tof) || (size);
-
-    const bool charged = cand->VetoEnergy > 0.0;
+    if(!cutg)
+        return false;
+    if(cutg == source)
+        return cut->IsInside(x, y);
+    return cutg->IsInside(x, y);
+}
 
+void BasicParticleID::compiled_cut_t::Test(const std::shared_ptr<TCutG>& cutg,
+                                           const std::vector<double>& x, const std::vector<double>& y,
+                                           std::vector<uint8_t>& result) const
+{
+    if(!cutg) {
+        result.assign(x.size(), false);
+        return;
+    }
+    if(cutg == source) {
+        cut->IsInside(x, y, result);
+        return;
+    }
+    result.resize(x.size());
+    for(size_t i=0;i<x.size();++i)
+        result[i] = cutg->IsInside(x[i], y[i]);
+}
 
+void BasicParticleID::Compile()
+{
+    compiled_dEE_proton.Compile(dEE_proton);
+    compiled_dEE_pion.Compile(dEE_pion);
+    compiled_dEE_electron.Compile(dEE_electron);
+    compiled_tof.Compile(tof);
+    compiled_size.Compile(size);
+}
 
+const ParticleTypeDatabase::Type* BasicParticleID::Classify(bool charged, bool hadronic_enabled, bool hadronic,
+                                                            bool proton, bool pion, bool electron) noexcept
+{
     if(!charged) {
 
         if(hadronic) {
@@ -87,22 +132,15 @@ const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr&
 
     } else {  //charged
 
-        if(
-           (hadronic_enabled && hadronic)
-           || (TestCut(dEE_proton, cand->CaloEnergy, cand->VetoEnergy))
-           ) {
+        if((hadronic_enabled && hadronic) || proton) {
             return addressof(ParticleTypeDatabase::Proton);
         }
 
-        if(
-           TestCut(dEE_pion, cand->CaloEnergy, cand->VetoEnergy)
-           ) {
+        if(pion) {
             return addressof(ParticleTypeDatabase::PiCharged);
         }
 
-        if(
-           TestCut(dEE_electron, cand->CaloEnergy, cand->VetoEnergy)
-           ) {
+        if(electron) {
             return addressof(ParticleTypeDatabase::eCharged);
         }
     }
@@ -110,6 +148,62 @@ const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr&
     return nullptr;
 }
 
+const ParticleTypeDatabase::Type* BasicParticleID::Identify(const TCandidatePtr& cand) const
+{
+    const bool hadronic =    compiled_tof.Test(tof,  cand->CaloEnergy, cand->Time)
+                          || compiled_size.Test(size, cand->CaloEnergy, cand->ClusterSize);
+
+    const bool hadronic_enabled = (tof) || (size);
+
+    const bool charged = cand->VetoEnergy > 0.0;
+
+    // evaluate the dE/E cuts only if needed
+    if(!charged)
+        return Classify(charged, hadronic_enabled, hadronic, false, false, false);
+
+    const bool proton = compiled_dEE_proton.Test(dEE_proton, cand->CaloEnergy, cand->VetoEnergy);
+    const bool pion = !proton && compiled_dEE_pion.Test(dEE_pion, cand->CaloEnergy, cand->VetoEnergy);
+    const bool electron = !proton && !pion && compiled_dEE_electron.Test(dEE_electron, cand->CaloEnergy, cand->VetoEnergy);
+
+    return Classify(charged, hadronic_enabled, hadronic, proton, pion, electron);
+}
+
+void BasicParticleID::IdentifyAll(const TCandidatePtrList& cands, types_t& types) const
+{
+    const auto n = cands.size();
+
+    // gather the candidate properties column-wise,
+    // then evaluate each cut once over all candidates
+    // the buffers are re-used by the following events of the thread
+    thread_local vector<double> caloE, time, clustersize, vetoE;
+    caloE.resize(n);
+    time.resize(n);
+    clustersize.resize(n);
+    vetoE.resize(n);
+    for(size_t i=0;i<n;++i) {
+        const auto& cand = *cands[i];
+        caloE[i] = cand.CaloEnergy;
+        time[i] = cand.Time;
+        clustersize[i] = cand.ClusterSize;
+        vetoE[i] = cand.VetoEnergy;
+    }
+
+    thread_local vector<uint8_t> is_tof, is_size, is_proton, is_pion, is_electron;
+    compiled_tof.Test(tof, caloE, time, is_tof);
+    compiled_size.Test(size, caloE, clustersize, is_size);
+    compiled_dEE_proton.Test(dEE_proton, caloE, vetoE, is_proton);
+    compiled_dEE_pion.Test(dEE_pion, caloE, vetoE, is_pion);
+    compiled_dEE_electron.Test(dEE_electron, caloE, vetoE, is_electron);
+
+    const bool hadronic_enabled = (tof) || (size);
+
+    types.resize(n);
+    for(size_t i=0;i<n;++i) {
+        types[i] = Classify(vetoE[i] > 0.0, hadronic_enabled, is_tof[i] || is_size[i],
+                            is_proton[i], is_pion[i], is_electron[i]);
+    }
+}
+
 
 
 
@@ -149,6 +243,37 @@ const ParticleTypeDatabase::Type* CBTAPSBasicParticleID::Identify(const TCandida
     return nullptr;
 }
 
+void CBTAPSBasicParticleID::IdentifyAll(const TCandidatePtrList& cands, types_t& types) const
+{
+    // split by apparatus, identify each part in one batch and scatter back
+    thread_local TCandidatePtrList cb_cands, taps_cands;
+    thread_local vector<size_t> cb_idx, taps_idx;
+    cb_cands.clear();
+    taps_cands.clear();
+    cb_idx.clear();
+    taps_idx.clear();
+    for(size_t i=0;i<cands.size();++i) {
+        const auto& cand = cands[i];
+        if(cand->Detector & Detector_t::Any_t::CB_Apparatus) {
+            cb_cands.emplace_back(cand);
+            cb_idx.emplace_back(i);
+        } else if(cand->Detector & Detector_t::Any_t::TAPS_Apparatus) {
+            taps_cands.emplace_back(cand);
+            taps_idx.emplace_back(i);
+        }
+    }
+
+    types.assign(cands.size(), nullptr);
+
+    thread_local types_t part;
+    cb.IdentifyAll(cb_cands, part);
+    for(size_t i=0;i<cb_idx.size();++i)
+        types[cb_idx[i]] = part[i];
+    taps.IdentifyAll(taps_cands, part);
+    for(size_t i=0;i<taps_idx.size();++i)
+        types[taps_idx[i]] = part[i];
+}
+
 void CBTAPSBasicParticleID::LoadFrom(WrapTFile& file)
 {
 
@@ -163,6 +288,9 @@ void CBTAPSBasicParticleID::LoadFrom(WrapTFile& file)
         taps.dEE_electron   = file.GetSharedClone<TCutG>("taps_dEE_electron");
         taps.tof            = file.GetSharedClone<TCutG>("taps_ToF");
         taps.size           = file.GetSharedClone<TCutG>("taps_CluserSize");
+
+        cb.Compile();
+        taps.Compile();
 }
 
 
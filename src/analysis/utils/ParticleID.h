@@ -4,6 +4,7 @@
 #include "base/ParticleType.h"
 
 #include <memory>
+#include <vector>
 
 class TCutG;
 
@@ -15,13 +16,34 @@ struct TEventData;
 namespace analysis {
 namespace utils {
 
+class PolygonCut;
+
 class ParticleID {
 public:
+    using types_t = std::vector<const ParticleTypeDatabase::Type*>;
+    using particles_t = std::vector<TParticlePtr>;
+
     virtual ~ParticleID();
 
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const =0;
     virtual TParticlePtr Process(const TCandidatePtr& cand) const;
 
+    /**
+     * @brief IdentifyAll identifies all candidates of an event in one go
+     * @param cands the candidates
+     * @param types filled with one type per candidate, nullptr if not identified
+     * @note the default just calls Identify for each candidate
+     */
+    virtual void IdentifyAll(const TCandidatePtrList& cands, types_t& types) const;
+
+    /**
+     * @brief ProcessAll is the batch version of Process, used by ParticleTypeList::Make
+     * @param cands the candidates
+     * @param particles filled with one particle per candidate, nullptr if not identified
+     * @note the default uses IdentifyAll, so derived IDs overriding Process must override this as well
+     */
+    virtual void ProcessAll(const TCandidatePtrList& cands, particles_t& particles) const;
+
     static const ParticleID& GetDefault();
     static void SetDefault(std::unique_ptr<const ParticleID> id);
 private:
@@ -52,7 +74,35 @@ public:
 
     std::shared_ptr<TCutG> size;
 
+    /**
+     * @brief Compile rasterizes the currently set TCutGs into PolygonCuts
+     * @note Cuts changed after compiling fall back to TCutG::IsInside until compiled again
+     */
+    void Compile();
+
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
+    virtual void IdentifyAll(const TCandidatePtrList& cands, types_t& types) const override;
+
+protected:
+    struct compiled_cut_t {
+        std::shared_ptr<TCutG> source;
+        std::shared_ptr<const PolygonCut> cut;
+
+        void Compile(const std::shared_ptr<TCutG>& cutg);
+        bool Test(const std::shared_ptr<TCutG>& cutg, double x, double y) const;
+        void Test(const std::shared_ptr<TCutG>& cutg,
+                  const std::vector<double>& x, const std::vector<double>& y,
+                  std::vector<std::uint8_t>& result) const;
+    };
+
+    compiled_cut_t compiled_dEE_proton;
+    compiled_cut_t compiled_dEE_pion;
+    compiled_cut_t compiled_dEE_electron;
+    compiled_cut_t compiled_tof;
+    compiled_cut_t compiled_size;
+
+    static const ParticleTypeDatabase::Type* Classify(bool charged, bool hadronic_enabled, bool hadronic,
+                                                      bool proton, bool pion, bool electron) noexcept;
 };
 
 class CBTAPSBasicParticleID: public ParticleID {
@@ -66,6 +116,7 @@ public:
     virtual ~CBTAPSBasicParticleID();
 
     virtual const ParticleTypeDatabase::Type* Identify(const TCandidatePtr& cand) const override;
+    virtual void IdentifyAll(const TCandidatePtrList& cands, types_t& types) const override;
 };
 
 }
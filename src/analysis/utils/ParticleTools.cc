@@ -60,8 +60,12 @@ ParticleTypeList ParticleTypeList::Make(const TCandidateList& cands)
 ParticleTypeList ParticleTypeList::Make(const TCandidateList& cands, const ParticleID& id)
 {
     ParticleTypeList list;
-    for(auto cand : cands.get_iter()) {
-        auto particle = id.Process(cand);
+    list.all.reserve(cands.size());
+
+    // identify the candidates of the event in one go
+    thread_local ParticleID::particles_t particles;
+    id.ProcessAll(cands.get_ptr_list(), particles);
+    for(const auto& particle : particles) {
         if(particle)
             list.Add(particle);
     }
@@ -0,0 +1,167 @@
+#include "PolygonCut.h"
+
+#include "TCutG.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace ant::analysis::utils;
+
+namespace {
+
+// Liang-Barsky clipping of segment (x0,y0)-(x1,y1) against the closed rectangle
+bool SegmentTouchesRect(double x0, double y0, double x1, double y1,
+                        double rx0, double ry0, double rx1, double ry1)
+{
+    double t0 = 0.0;
+    double t1 = 1.0;
+    auto clip = [&t0, &t1] (double p, double q) {
+        if(p == 0.0)
+            return q >= 0.0;
+        const double r = q/p;
+        if(p < 0.0) {
+            if(r > t1)
+                return false;
+            t0 = max(t0, r);
+        }
+        else {
+            if(r < t0)
+                return false;
+            t1 = min(t1, r);
+        }
+        return true;
+    };
+    const double dx = x1 - x0;
+    const double dy = y1 - y0;
+    return clip(-dx, x0 - rx0) && clip(dx, rx1 - x0)
+        && clip(-dy, y0 - ry0) && clip(dy, ry1 - y0);
+}
+
+}
+
+PolygonCut::PolygonCut(const std::vector<point_t>& points, unsigned gridsize)
+{
+    px.reserve(points.size());
+    py.reserve(points.size());
+    for(const auto& p : points) {
+        px.emplace_back(p.first);
+        py.emplace_back(p.second);
+    }
+    Build(gridsize);
+}
+
+PolygonCut::PolygonCut(const TCutG& cut, unsigned gridsize) :
+    px(cut.GetX(), cut.GetX()+cut.GetN()),
+    py(cut.GetY(), cut.GetY()+cut.GetN())
+{
+    Build(gridsize);
+}
+
+void PolygonCut::Build(unsigned gridsize)
+{
+    if(px.size() < 3 || gridsize == 0)
+        return;
+
+    x_min = *min_element(px.begin(), px.end());
+    x_max = *max_element(px.begin(), px.end());
+    y_min = *min_element(py.begin(), py.end());
+    y_max = *max_element(py.begin(), py.end());
+
+    // degenerate polygons never contain anything
+    if(!(x_max > x_min) || !(y_max > y_min))
+        return;
+
+    nx = gridsize;
+    ny = gridsize;
+    const double dx = (x_max - x_min)/nx;
+    const double dy = (y_max - y_min)/ny;
+    inv_dx = 1.0/dx;
+    inv_dy = 1.0/dy;
+
+    // small margin to be safe against rounding in the bin index calculation
+    const double eps = 1e-6;
+    const double mx = eps*dx;
+    const double my = eps*dy;
+
+    auto clamp_x = [this] (double v) { return static_cast<unsigned>(max(0.0, min(v, nx-1.0))); };
+    auto clamp_y = [this] (double v) { return static_cast<unsigned>(max(0.0, min(v, ny-1.0))); };
+
+    vector<bool> edge(nx*ny, false);
+
+    const auto np = px.size();
+    for(size_t i=0, j=np-1; i<np; j=i++) {
+        const double x0 = px[j], y0 = py[j];
+        const double x1 = px[i], y1 = py[i];
+
+        const unsigned ix0 = clamp_x(floor((min(x0,x1) - x_min)*inv_dx - eps));
+        const unsigned ix1 = clamp_x(floor((max(x0,x1) - x_min)*inv_dx + eps));
+        const unsigned iy0 = clamp_y(floor((min(y0,y1) - y_min)*inv_dy - eps));
+        const unsigned iy1 = clamp_y(floor((max(y0,y1) - y_min)*inv_dy + eps));
+
+        for(unsigned iy=iy0; iy<=iy1; ++iy) {
+            for(unsigned ix=ix0; ix<=ix1; ++ix) {
+                const double rx0 = x_min + ix*dx;
+                const double ry0 = y_min + iy*dy;
+                if(SegmentTouchesRect(x0, y0, x1, y1,
+                                      rx0 - mx, ry0 - my, rx0 + dx + mx, ry0 + dy + my))
+                    edge[ix + iy*nx] = true;
+            }
+        }
+    }
+
+    // cells without any edge are completely inside or outside,
+    // so testing the center is sufficient
+    cells.resize(nx*ny);
+    for(unsigned iy=0; iy<ny; ++iy) {
+        for(unsigned ix=0; ix<nx; ++ix) {
+            const auto bin = ix + iy*nx;
+            if(edge[bin])
+                cells[bin] = cell_t::Edge;
+            else
+                cells[bin] = IsInsideExact(x_min + (ix+0.5)*dx, y_min + (iy+0.5)*dy) ?
+                                 cell_t::Inside : cell_t::Outside;
+        }
+    }
+}
+
+bool PolygonCut::IsInsideExact(double x, double y) const noexcept
+{
+    // same algorithm as TMath::IsInside, used by TCutG::IsInside
+    bool odd = false;
+    const auto np = px.size();
+    for(size_t i=0, j=np-1; i<np; j=i++) {
+        if((py[i] < y && py[j] >= y) || (py[j] < y && py[i] >= y)) {
+            if(px[i] + (y - py[i])/(py[j] - py[i])*(px[j] - px[i]) < x)
+                odd = !odd;
+        }
+    }
+    return odd;
+}
+
+bool PolygonCut::IsInside(double x, double y) const noexcept
+{
+    if(cells.empty())
+        return false;
+
+    // also catches NaN
+    if(!(x >= x_min && x <= x_max && y >= y_min && y <= y_max))
+        return false;
+
+    const unsigned ix = min(static_cast<unsigned>((x - x_min)*inv_dx), nx-1);
+    const unsigned iy = min(static_cast<unsigned>((y - y_min)*inv_dy), ny-1);
+
+    const auto cell = cells[ix + iy*nx];
+    if(cell == cell_t::Edge)
+        return IsInsideExact(x, y);
+    return cell == cell_t::Inside;
+}
+
+void PolygonCut::IsInside(const std::vector<double>& x, const std::vector<double>& y,
+                          std::vector<uint8_t>& result) const
+{
+    const auto n = x.size();
+    result.resize(n);
+    for(size_t i=0;i<n;++i)
+        result[i] = IsInside(x[i], y[i]);
+}
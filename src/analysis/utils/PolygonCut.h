@@ -0,0 +1,65 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+class TCutG;
+
+namespace ant {
+namespace analysis {
+namespace utils {
+
+/**
+ * @brief The PolygonCut class is a precompiled replacement for TCutG::IsInside
+ *
+ * The polygon is rasterized once at construction into a uniform grid
+ * over its bounding box. Each grid cell is either completely inside,
+ * completely outside or touched by an edge of the polygon. Only points
+ * in the latter cells are tested exactly with the same crossing-number
+ * algorithm as TMath::IsInside, so results are identical to TCutG.
+ *
+ * The object is immutable after construction and thus safe to use from several threads.
+ */
+class PolygonCut {
+public:
+    using point_t = std::pair<double, double>;
+
+    explicit PolygonCut(const std::vector<point_t>& points, unsigned gridsize = 64);
+    explicit PolygonCut(const TCutG& cut, unsigned gridsize = 64);
+
+    bool IsInside(double x, double y) const noexcept;
+
+    /**
+     * @brief IsInside evaluates the cut for a batch of points
+     * @param x x-coordinates
+     * @param y y-coordinates, same size as x
+     * @param result filled with 0/1, resized to size of x
+     */
+    void IsInside(const std::vector<double>& x, const std::vector<double>& y,
+                  std::vector<std::uint8_t>& result) const;
+
+    std::size_t GetNPoints() const noexcept { return px.size(); }
+
+protected:
+    enum class cell_t : std::uint8_t { Outside, Inside, Edge };
+
+    std::vector<double> px;
+    std::vector<double> py;
+
+    unsigned nx = 0;
+    unsigned ny = 0;
+    double x_min = 0;
+    double y_min = 0;
+    double x_max = 0;
+    double y_max = 0;
+    double inv_dx = 0;
+    double inv_dy = 0;
+
+    std::vector<cell_t> cells;
+
+    void Build(unsigned gridsize);
+    bool IsInsideExact(double x, double y) const noexcept;
+};
+
+}}} // namespace ant::analysis::utils
@@ -5,70 +5,139 @@
 
 #include "base/Logger.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 using namespace ant;
 using namespace ant::analysis::utils;
 
+namespace {
+
+// four independent partial sums break the dependency chain of the additions,
+// so the loop can be vectorized without -ffast-math. Note that this sums in a different
+// order than a plain loop, so the result may differ from it in the last bits
+inline double sum4(const double* e, size_t n) noexcept {
+    double s[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for(; i+4<=n; i+=4) {
+        s[0] += e[i];
+        s[1] += e[i+1];
+        s[2] += e[i+2];
+        s[3] += e[i+3];
+    }
+    for(; i<n; i++)
+        s[0] += e[i];
+    return (s[0]+s[1])+(s[2]+s[3]);
+}
+
+inline double masked_sum4(const double* e, const uint8_t* mask, size_t n) noexcept {
+    double s[4] = {0, 0, 0, 0};
+    size_t i = 0;
+    for(; i+4<=n; i+=4) {
+        s[0] += mask[i]   ? e[i]   : 0.0;
+        s[1] += mask[i+1] ? e[i+1] : 0.0;
+        s[2] += mask[i+2] ? e[i+2] : 0.0;
+        s[3] += mask[i+3] ? e[i+3] : 0.0;
+    }
+    for(; i<n; i++)
+        s[0] += mask[i] ? e[i] : 0.0;
+    return (s[0]+s[1])+(s[2]+s[3]);
+}
+
+unsigned GetNCBElements() {
+    for(const auto& detector : ExpConfig::Setup::Get().GetDetectors()) {
+        if(detector->Type == Detector_t::Type_t::CB)
+            return detector->GetNChannels();
+    }
+    return 0;
+}
+
+}
+
+void TriggerSimulation::model_t::Resize(const config_t& config, unsigned nElements)
+{
+    const auto oldSize = CBESumMask.size();
+    if(nElements <= oldSize)
+        return;
+    CBEnergies.resize(nElements, 0.0);
+    CBESumMask.resize(nElements, 1);
+    for(auto element : config.CBESum_MissingElements) {
+        if(element >= oldSize && element < nElements)
+            CBESumMask[element] = 0;
+    }
+    nSectors = config.CB_SectorSize > 0 ?
+                   (nElements + config.CB_SectorSize - 1) / config.CB_SectorSize : 0;
+}
+
 TriggerSimulation::TriggerSimulation() :
-    config(ExpConfig::Setup::Get().GetTriggerSimuConfig()),
+    TriggerSimulation(ExpConfig::Setup::Get().GetTriggerSimuConfig())
+{
+    model.Resize(config, GetNCBElements());
+}
+
+TriggerSimulation::TriggerSimulation(const config_t& config_) :
+    config(config_),
     random_CBESum_threshold(config.CBESum_Edge, config.CBESum_Width)
 {}
 
-bool TriggerSimulation::ProcessEvent(const TEvent& event)
+void TriggerSimulation::FillCBEnergies(const TEventData& recon)
 {
-    info.Reset();
+    auto& energies = model.CBEnergies;
+    std::fill(energies.begin(), energies.end(), 0.0);
 
-    const auto& recon = event.Reconstructed();
-
-    const bool isMC = recon.ID.isSet(TID::Flags_t::MC);
+    for(const TDetectorReadHit& dethit : recon.DetectorReadHits) {
+        if(dethit.DetectorType != Detector_t::Type_t::CB)
+            continue;
+        if(dethit.ChannelType != Channel_t::Type_t::Integral)
+            continue;
+        if(dethit.Channel >= energies.size())
+            model.Resize(config, dethit.Channel+1);
+        // one could also use uncalibrated values
+        // with some fixed constant? or average from all gains?
+        for(auto& energy : dethit.Values)
+            energies[dethit.Channel] += energy.Calibrated;
+    }
+}
 
-    // CBTiming as average over cluster timings
-    {
-        if(isMC) {
-            info.CBTiming = 0;
-        }
-        else {
-            double TimeEsum = 0.0;
-            double TimeE = 0.0;
-            for(const auto& cluster : recon.Clusters) {
-                if(cluster.DetectorType != Detector_t::Type_t::CB)
-                    continue;
-                // ignore weird clusters
-                if(!cluster.isSane())
-                    continue;
-                TimeEsum += cluster.Energy;
-                TimeE += cluster.Energy*cluster.Time;
-            }
-            info.CBTiming = TimeE/TimeEsum;
-        }
+unsigned TriggerSimulation::CountSectors() const
+{
+    if(!std::isfinite(config.CB_SectorThreshold))
+        return 0;
+    const auto& energies = model.CBEnergies;
+    const size_t sectorSize = config.CB_SectorSize;
+    unsigned multiplicity = 0;
+    for(size_t sector=0;sector<model.nSectors;sector++) {
+        const size_t begin = sector*sectorSize;
+        const size_t n = std::min(sectorSize, energies.size()-begin);
+        if(sum4(std::addressof(energies[begin]), n) > config.CB_SectorThreshold)
+            multiplicity++;
     }
+    return multiplicity;
+}
+
+bool TriggerSimulation::ProcessReadHits(const TEventData& recon)
+{
+    info.Reset();
+
+    const bool isMC = recon.ID.isSet(TID::Flags_t::MC);
 
     // CBEsum is sum over detector read hits (except possibly ignored channels)
-    {
-        info.CBEnergySum = 0.0;
-        for(const TDetectorReadHit& dethit : recon.DetectorReadHits) {
-            if(dethit.DetectorType != Detector_t::Type_t::CB)
-                continue;
-            if(dethit.ChannelType != Channel_t::Type_t::Integral)
-                continue;
-            if(std_ext::contains(config.CBESum_MissingElements, dethit.Channel))
-                continue;
-            // one could also use uncalibrated values
-            // with some fixed constant? or average from all gains?
-            for(auto& energy : dethit.Values)
-                info.CBEnergySum += energy.Calibrated;
-        }
-    }
+    FillCBEnergies(recon);
+    info.CBEnergySum = masked_sum4(model.CBEnergies.data(), model.CBESumMask.data(),
+                                   model.CBEnergies.size());
+    info.CBMultiplicity = CountSectors();
 
     if(isMC) {
         if(config.Type == config_t::Type_t::CBESum) {
             // lazy init random generator with timestamp of (first) event
             if(!random_gen) {
                 random_gen = std_ext::make_unique<std::default_random_engine>(
-                                 event.Reconstructed().ID.Timestamp
+                                 recon.ID.Timestamp
                                  );
             }
-            info.hasTriggered = info.CBEnergySum > random_CBESum_threshold(*random_gen);
+            info.hasTriggered = info.CBEnergySum > random_CBESum_threshold(*random_gen)
+                                && info.CBMultiplicity >= config.CB_MinMultiplicity;
         }
         // may implement other trigger simulations on MC here
         else {
@@ -81,8 +150,36 @@ bool TriggerSimulation::ProcessEvent(const TEvent& event)
         info.hasTriggered = true;
     }
 
-    /// \todo The multiplicity is a much harder business, see acqu/root/src/TA2BasePhysics.cc
-    /// the code there might only apply to the old trigger system before 2012
+    /// \todo The multiplicity of the old trigger system before 2012 is a much harder business,
+    /// see acqu/root/src/TA2BasePhysics.cc
+
+    return std::isfinite(info.CBEnergySum);
+}
+
+bool TriggerSimulation::ProcessEvent(const TEvent& event)
+{
+    const auto& recon = event.Reconstructed();
+
+    ProcessReadHits(recon);
+
+    // CBTiming as average over cluster timings
+    if(recon.ID.isSet(TID::Flags_t::MC)) {
+        info.CBTiming = 0;
+    }
+    else {
+        double TimeEsum = 0.0;
+        double TimeE = 0.0;
+        for(const auto& cluster : recon.Clusters) {
+            if(cluster.DetectorType != Detector_t::Type_t::CB)
+                continue;
+            // ignore weird clusters
+            if(!cluster.isSane())
+                continue;
+            TimeEsum += cluster.Energy;
+            TimeE += cluster.Energy*cluster.Time;
+        }
+        info.CBTiming = TimeE/TimeEsum;
+    }
 
     // return true if information is complete and sane
     return info.IsSane();
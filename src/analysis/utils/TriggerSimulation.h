@@ -4,10 +4,13 @@
 #include "expconfig/ExpConfig.h"
 
 #include <random>
+#include <vector>
+#include <cstdint>
 
 namespace ant {
 
 struct TEvent;
+struct TEventData;
 struct TTaggerHit;
 
 namespace analysis {
@@ -16,9 +19,10 @@ namespace utils {
 class TriggerSimulation {
 
     struct info_t {
-        bool   hasTriggered;
-        double CBEnergySum;
-        double CBTiming;
+        bool     hasTriggered;
+        double   CBEnergySum;
+        double   CBTiming;
+        unsigned CBMultiplicity;
         info_t() {
             Reset(); // ensure reset on startup
         }
@@ -26,6 +30,7 @@ class TriggerSimulation {
             hasTriggered = false;
             CBEnergySum = std_ext::NaN;
             CBTiming = std_ext::NaN;
+            CBMultiplicity = 0;
         }
         bool IsSane() {
             return std::isfinite(CBEnergySum) &&
@@ -41,9 +46,25 @@ class TriggerSimulation {
     std::unique_ptr<std::default_random_engine> random_gen;
     std::normal_distribution<double> random_CBESum_threshold;
 
+    // the config compiled into tables indexed by CB element,
+    // grown on demand if the read hits contain unexpected elements
+    struct model_t {
+        std::vector<double>       CBEnergies; // dense energies of the current event
+        std::vector<std::uint8_t> CBESumMask; // 1 if element is part of the analog sum
+        unsigned                  nSectors = 0;
+
+        void Resize(const config_t& config, unsigned nElements);
+    };
+
+    model_t model;
+
+    void FillCBEnergies(const TEventData& recon);
+    unsigned CountSectors() const;
+
 public:
 
     TriggerSimulation();
+    explicit TriggerSimulation(const config_t& config_);
 
     /**
      * @brief ProcessEvent inspects the full event to tell trigger decision
@@ -52,6 +73,15 @@ public:
      */
     bool ProcessEvent(const TEvent& event);
 
+    /**
+     * @brief ProcessReadHits tells the trigger decision from the detector read hits only,
+     * so it can be used before clusters and candidates are built
+     * @param recon the reconstructed event data, only ID and DetectorReadHits are used
+     * @return true if the energy sum is sane
+     * @note the reference timing is not available afterwards, use ProcessEvent for that
+     */
+    bool ProcessReadHits(const TEventData& recon);
+
     /**
      * @brief HasTriggered returns true if the experiment would have accepted this event
      * @return the trigger decision
@@ -64,6 +94,12 @@ public:
      */
     double GetCBEnergySum() const { return info.CBEnergySum; }
 
+    /**
+     * @brief GetCBMultiplicity emulates the multiplicity trigger
+     * @return number of CB sectors above threshold, zero if not configured by setup
+     */
+    unsigned GetCBMultiplicity() const { return info.CBMultiplicity; }
+
     /**
      * @brief GetRefTiming tries to calculate the reference timing,
      * typically given by the analog energy sum
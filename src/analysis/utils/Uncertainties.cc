@@ -25,7 +25,7 @@ double UncertaintyModel::GetBeamEnergySigma(double photon_energy) const
         unsigned channel;
         if(tagger->TryGetChannelFromPhoton(photon_energy, channel)) {
             // sigma of uniform distribution is width/sqrt(12)
-            return tagger->GetPhotonEnergyWidth(channel)/sqrt(12.0);
+            return tagger->GetChannelTable().PhotonEnergyWidths[channel]/sqrt(12.0);
         }
     }
 
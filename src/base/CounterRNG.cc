@@ -0,0 +1,57 @@
+#include "CounterRNG.h"
+
+#include <cmath>
+
+using namespace std;
+using namespace ant;
+
+namespace {
+
+inline void mulhilo(uint32_t a, uint32_t b, uint32_t& hi, uint32_t& lo) noexcept {
+    const uint64_t p = uint64_t(a)*b;
+    hi = uint32_t(p >> 32);
+    lo = uint32_t(p);
+}
+
+}
+
+void CounterRNG::Generate() noexcept
+{
+    // Philox4x32-10, see Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"
+    constexpr uint32_t M0 = 0xD2511F53;
+    constexpr uint32_t M1 = 0xCD9E8D57;
+    constexpr uint32_t W0 = 0x9E3779B9;
+    constexpr uint32_t W1 = 0xBB67AE85;
+
+    uint32_t k0 = uint32_t(key);
+    uint32_t k1 = uint32_t(key >> 32);
+    ctr_t c = ctr;
+
+    for(int round=0;round<10;round++) {
+        uint32_t hi0, lo0, hi1, lo1;
+        mulhilo(M0, c[0], hi0, lo0);
+        mulhilo(M1, c[2], hi1, lo1);
+        c = {hi1 ^ c[1] ^ k0, lo1, hi0 ^ c[3] ^ k1, lo0};
+        k0 += W0;
+        k1 += W1;
+    }
+    buffer = c;
+
+    // 64bit counter in the lower words, the upper words hold the stream
+    if(++ctr[0] == 0)
+        ++ctr[1];
+}
+
+void CounterRNG::Gaus(double* out, size_t n) noexcept
+{
+    constexpr double two_pi = 2*M_PI;
+    size_t i = 0;
+    for(; i+1<n; i+=2) {
+        const double r   = sqrt(-2.0*log(Uniform()));
+        const double phi = two_pi*Uniform();
+        out[i]   = r*cos(phi);
+        out[i+1] = r*sin(phi);
+    }
+    if(i<n)
+        out[i] = sqrt(-2.0*log(Uniform()))*cos(two_pi*Uniform());
+}
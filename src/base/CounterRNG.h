@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+namespace ant {
+
+/**
+ * @brief The CounterRNG class is a counter-based random number generator (Philox4x32-10)
+ *
+ * The numbers are a pure function of key, stream and counter. Using the event number
+ * as stream gives reproducible numbers per event, independent of the processing order
+ * and without any state shared between threads. Gaussian deviates are drawn in bulk
+ * with the Box-Muller transform, two per generator call.
+ *
+ * Example:
+ *
+ *     CounterRNG rng(seed);
+ *     rng.SetStream(eventNumber);
+ *     rng.Gaus(deviates, n);
+ */
+class CounterRNG {
+public:
+    using key_t = std::uint64_t;
+
+    explicit CounterRNG(key_t key_, std::uint64_t stream = 0) noexcept :
+        key(key_)
+    {
+        SetStream(stream);
+    }
+
+    /**
+     * @brief SetStream starts a new, independent stream of numbers
+     */
+    void SetStream(std::uint64_t stream) noexcept {
+        ctr = {0, 0, std::uint32_t(stream), std::uint32_t(stream >> 32)};
+        nBuffered = 0;
+    }
+
+    /**
+     * @brief Next returns 64 random bits
+     */
+    std::uint64_t Next() noexcept {
+        if(nBuffered == 0) {
+            Generate();
+            nBuffered = 2;
+        }
+        --nBuffered;
+        return (std::uint64_t(buffer[2*nBuffered]) << 32) | buffer[2*nBuffered+1];
+    }
+
+    /**
+     * @brief Uniform returns a uniform deviate in (0,1]
+     */
+    double Uniform() noexcept {
+        return ((Next() >> 11) + 1) * (1.0/(std::uint64_t(1) << 53));
+    }
+
+    /**
+     * @brief Gaus fills out with n standard normal deviates
+     */
+    void Gaus(double* out, std::size_t n) noexcept;
+
+    void Gaus(std::vector<double>& out) noexcept {
+        Gaus(out.data(), out.size());
+    }
+
+    /**
+     * @brief Gaus returns a single normal deviate with given mean and sigma
+     */
+    double Gaus(double mean, double sigma) noexcept {
+        double x;
+        Gaus(&x, 1);
+        return mean + sigma*x;
+    }
+
+protected:
+    using ctr_t = std::array<std::uint32_t, 4>;
+
+    const key_t key;
+    ctr_t ctr;
+    ctr_t buffer;
+    unsigned nBuffered = 0;
+
+    void Generate() noexcept;
+};
+
+}
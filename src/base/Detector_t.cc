@@ -2,13 +2,20 @@
 
 #include "base/interval.h"
 #include "base/std_ext/string.h"
+#include "base/std_ext/memory.h"
 
 #include <sstream>
 #include <map>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
 
 using namespace ant;
 using namespace std;
 
+constexpr unsigned Detector_t::NTypes;
+constexpr unsigned Channel_t::NTypes;
+
 const Detector_t::Any_t Detector_t::Any_t::None;
 const Detector_t::Any_t Detector_t::Any_t::Tracker(Type_t::MWPC0 | Type_t::MWPC1);
 const Detector_t::Any_t Detector_t::Any_t::CB_Apparatus(Detector_t::Any_t::Tracker | Type_t::PID | Type_t::CB | Type_t::APT);
@@ -49,7 +56,7 @@ ant::Detector_t::Any_t::operator string() const {
 
 #define MAKE_DETECTOR_TYPE_ENTRY(det) {Detector_t::Type_t::det, #det}
 
-const map<Detector_t::Type_t, string> detectorTypeMap = {
+constexpr pair<Detector_t::Type_t, const char*> detectorTypeEntries[] = {
     MAKE_DETECTOR_TYPE_ENTRY(CB),
     MAKE_DETECTOR_TYPE_ENTRY(Cherenkov),
     MAKE_DETECTOR_TYPE_ENTRY(MWPC0),
@@ -67,6 +74,11 @@ const map<Detector_t::Type_t, string> detectorTypeMap = {
     MAKE_DETECTOR_TYPE_ENTRY(APT)
 };
 
+static_assert(extent<decltype(detectorTypeEntries)>::value == Detector_t::NTypes,
+              "Detector_t::NTypes does not match the number of detector types");
+
+const map<Detector_t::Type_t, string> detectorTypeMap(begin(detectorTypeEntries), end(detectorTypeEntries));
+
 const char* ant::Detector_t::ToString(const Type_t& type)
 {
     auto it = detectorTypeMap.find(type);
@@ -103,23 +115,26 @@ bool Detector_t::IsIgnored(unsigned channel) const
 }
 
 
+#define MAKE_CHANNEL_TYPE_ENTRY(ch) {Channel_t::Type_t::ch, #ch}
+
+constexpr pair<Channel_t::Type_t, const char*> channelTypeEntries[] = {
+    MAKE_CHANNEL_TYPE_ENTRY(BitPattern),
+    MAKE_CHANNEL_TYPE_ENTRY(Integral),
+    MAKE_CHANNEL_TYPE_ENTRY(IntegralAlternate),
+    MAKE_CHANNEL_TYPE_ENTRY(IntegralShort),
+    MAKE_CHANNEL_TYPE_ENTRY(IntegralShortAlternate),
+    MAKE_CHANNEL_TYPE_ENTRY(Timing),
+    MAKE_CHANNEL_TYPE_ENTRY(Raw)
+};
+
+static_assert(extent<decltype(channelTypeEntries)>::value == Channel_t::NTypes,
+              "Channel_t::NTypes does not match the number of channel types");
+
 const char* ant::Channel_t::ToString(const Type_t& type)
 {
-    switch(type) {
-    case Channel_t::Type_t::BitPattern:
-        return "BitPattern";
-    case Channel_t::Type_t::Integral:
-        return "Integral";
-    case Channel_t::Type_t::IntegralAlternate:
-        return "IntegralAlternate";
-    case Channel_t::Type_t::IntegralShort:
-        return "IntegralShort";
-    case Channel_t::Type_t::IntegralShortAlternate:
-        return "IntegralShortAlternate";
-    case Channel_t::Type_t::Timing:
-        return "Timing";
-    case Channel_t::Type_t::Raw:
-        return "Raw";
+    for(const auto& entry : channelTypeEntries) {
+        if(entry.first == type)
+            return entry.second;
     }
     throw runtime_error("Not implemented");
 }
@@ -144,13 +159,54 @@ double TaggerDetector_t::GetPhotonEnergyWidth(unsigned channel) const
 
 bool TaggerDetector_t::TryGetChannelFromPhoton(double photonEnergy, unsigned& channel) const
 {
-    for(channel=0;channel<GetNChannels();++channel) {
+    const auto& table = GetChannelTable();
+    const auto& low = table.SortedLowEdges;
+
+    // all channels with low edge <= photonEnergy are candidates, but only
+    // the ones not further away than the largest width can contain it
+    // (twice the width to be safe against rounding)
+    auto it = upper_bound(low.begin(), low.end(), photonEnergy);
+    bool found = false;
+    while(it != low.begin()) {
+        --it;
+        if(*it < photonEnergy - 2*table.MaxWidth)
+            break;
+        const auto ch = table.SortedChannels[distance(low.begin(), it)];
         const auto& i = interval<double>::CenterWidth(
-                            GetPhotonEnergy(channel),
-                            GetPhotonEnergyWidth(channel)
+                            table.PhotonEnergies[ch],
+                            table.PhotonEnergyWidths[ch]
                             );
-        if(i.Contains(photonEnergy))
-            return true;
+        // prefer lowest channel if overlapping
+        if(i.Contains(photonEnergy) && (!found || ch < channel)) {
+            channel = ch;
+            found = true;
+        }
     }
-    return false;
+    return found;
+}
+
+const TaggerDetector_t::channeltable_t& TaggerDetector_t::GetChannelTable() const
+{
+    call_once(channeltable_built, [this] () {
+        auto table = std_ext::make_unique<channeltable_t>();
+        const auto nChannels = GetNChannels();
+        vector<pair<double, unsigned>> sorted;
+        for(unsigned ch=0;ch<nChannels;ch++) {
+            table->PhotonEnergies.push_back(GetPhotonEnergy(ch));
+            table->PhotonEnergyWidths.push_back(GetPhotonEnergyWidth(ch));
+            const auto& i = interval<double>::CenterWidth(
+                                table->PhotonEnergies.back(),
+                                table->PhotonEnergyWidths.back()
+                                );
+            sorted.emplace_back(i.Start(), ch);
+            table->MaxWidth = max(table->MaxWidth, i.Length());
+        }
+        sort(sorted.begin(), sorted.end());
+        for(const auto& s : sorted) {
+            table->SortedLowEdges.push_back(s.first);
+            table->SortedChannels.push_back(s.second);
+        }
+        channeltable = move(table);
+    });
+    return *channeltable;
 }
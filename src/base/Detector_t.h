@@ -5,6 +5,8 @@
 #include "base/std_ext/math.h"
 
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
@@ -28,6 +30,9 @@ struct Detector_t {
         Raw, APT
     };
 
+    // number of detector types, checked against the ToString entries in Detector_t.cc
+    static constexpr unsigned NTypes = static_cast<unsigned>(Type_t::APT)+1;
+
     // Any_t represents a collection of detectors
     struct Any_t : bitflag<Type_t> {
 
@@ -118,6 +123,8 @@ struct Channel_t {
         IntegralAlternate, IntegralShortAlternate,
         BitPattern, Raw
     };
+    // number of channel types, checked against the ToString entries in Detector_t.cc
+    static constexpr unsigned NTypes = static_cast<unsigned>(Type_t::Raw)+1;
     static bool IsIntegral(const Type_t& t);
     static const char* ToString(const Type_t& type);
 };
@@ -179,8 +186,40 @@ struct TaggerDetector_t : Detector_t {
      * @note Only works for taggers with more than one channel.
      */
     virtual double GetPhotonEnergyWidth(unsigned channel) const;
+
+    /**
+     * @brief TryGetChannelFromPhoton finds the channel containing the photon energy
+     * @param photonEnergy in MeV
+     * @param channel lowest channel whose width around its photon energy contains photonEnergy
+     * @return true if found
+     *
+     * Uses a binary search in the channel table
+     */
     bool TryGetChannelFromPhoton(double photonEnergy, unsigned& channel) const;
 
+    /**
+     * @brief The channeltable_t struct holds dense per-channel values of the tagger
+     *
+     * The values are obtained once from the virtual getters, so that per-hit lookups
+     * become a plain array access. Channels are additionally sorted by their lower
+     * photon energy edge for binary search.
+     */
+    struct channeltable_t {
+        std::vector<double> PhotonEnergies;      // indexed by channel
+        std::vector<double> PhotonEnergyWidths;  // indexed by channel
+
+        std::vector<double>   SortedLowEdges;    // ascending
+        std::vector<unsigned> SortedChannels;    // channel for each low edge
+        double MaxWidth = 0;
+    };
+
+    /**
+     * @brief GetChannelTable returns the table, built on first call
+     * @note Photon energies and widths must not change after the first call,
+     * the tagging efficiencies are not part of the table as they are calibrated
+     */
+    const channeltable_t& GetChannelTable() const;
+
     struct taggeff_t
     {
         double Value;
@@ -214,6 +253,9 @@ protected:
 
     double BeamEnergy;
 
+    mutable std::once_flag channeltable_built;
+    mutable std::unique_ptr<const channeltable_t> channeltable;
+
     TaggerDetector_t(const Type_t& type,
                      double beamEnergy
                      ) :
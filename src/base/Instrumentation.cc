@@ -0,0 +1,214 @@
+#include "Instrumentation.h"
+
+#include "std_ext/memory.h"
+
+#include "TDirectory.h"
+#include "TH1D.h"
+#include "TAxis.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <list>
+#include <map>
+#include <mutex>
+#include <iomanip>
+#include <memory>
+
+using namespace std;
+using namespace ant;
+
+std::atomic<bool> Instrumentation::Enabled{true};
+
+namespace {
+
+struct accumulator_t {
+    std::atomic<uint64_t> Calls{0};
+    std::atomic<uint64_t> Counts{0};
+    std::atomic<uint64_t> Nanos{0};
+};
+
+// incremented by Reset, the thread data is only valid if it belongs to the current generation
+std::atomic<unsigned> resetGeneration{0};
+
+struct thread_data_t {
+    std::array<accumulator_t, Instrumentation::MaxStages> Stages;
+    std::atomic<unsigned> Generation{resetGeneration.load()};
+};
+
+struct registry_t {
+    std::mutex Mutex;
+    std::vector<std::string> Names;
+    std::map<std::string, Instrumentation::stage_t> IDs;
+    // thread data is kept after the thread has finished
+    std::list<std::unique_ptr<thread_data_t>> Threads;
+};
+
+registry_t& GetRegistry() {
+    static registry_t registry;
+    return registry;
+}
+
+thread_data_t& GetThreadData() {
+    static thread_local thread_data_t* data = nullptr;
+    if(data == nullptr) {
+        auto& registry = GetRegistry();
+        lock_guard<mutex> lock(registry.Mutex);
+        registry.Threads.emplace_back(std_ext::make_unique<thread_data_t>());
+        data = registry.Threads.back().get();
+    }
+    // only the owning thread zeroes its accumulators after a Reset,
+    // so no increment can get lost in between
+    const auto generation = resetGeneration.load(memory_order_acquire);
+    if(data->Generation.load(memory_order_relaxed) != generation) {
+        for(auto& acc : data->Stages) {
+            acc.Calls.store(0, memory_order_relaxed);
+            acc.Counts.store(0, memory_order_relaxed);
+            acc.Nanos.store(0, memory_order_relaxed);
+        }
+        data->Generation.store(generation, memory_order_release);
+    }
+    return *data;
+}
+
+// only the owning thread writes, so no atomic read-modify-write is needed,
+// the atomics just make reading from other threads safe
+inline void add_relaxed(std::atomic<uint64_t>& a, uint64_t n) noexcept {
+    a.store(a.load(memory_order_relaxed) + n, memory_order_relaxed);
+}
+
+}
+
+Instrumentation::stage_t Instrumentation::GetStage(const string& name)
+{
+    auto& registry = GetRegistry();
+    lock_guard<mutex> lock(registry.Mutex);
+    auto it = registry.IDs.find(name);
+    if(it != registry.IDs.end())
+        return it->second;
+    const stage_t stage = registry.Names.size();
+    registry.Names.emplace_back(name);
+    registry.IDs.emplace(name, stage);
+    return stage;
+}
+
+void Instrumentation::Add(stage_t stage, chrono::nanoseconds elapsed) noexcept
+{
+    if(!Enabled.load(memory_order_relaxed) || stage >= MaxStages)
+        return;
+    auto& acc = GetThreadData().Stages[stage];
+    add_relaxed(acc.Calls, 1);
+    add_relaxed(acc.Nanos, elapsed.count());
+}
+
+void Instrumentation::Count(stage_t stage, uint64_t n) noexcept
+{
+    if(!Enabled.load(memory_order_relaxed) || stage >= MaxStages)
+        return;
+    add_relaxed(GetThreadData().Stages[stage].Counts, n);
+}
+
+vector<Instrumentation::result_t> Instrumentation::GetResults()
+{
+    auto& registry = GetRegistry();
+    lock_guard<mutex> lock(registry.Mutex);
+
+    vector<result_t> results(min<size_t>(registry.Names.size(), MaxStages));
+    for(size_t i=0;i<results.size();i++)
+        results[i].Name = registry.Names[i];
+
+    const auto generation = resetGeneration.load(memory_order_acquire);
+    for(const auto& thread : registry.Threads) {
+        // not accounted anything since the last Reset
+        if(thread->Generation.load(memory_order_acquire) != generation)
+            continue;
+        for(size_t i=0;i<results.size();i++) {
+            const auto& acc = thread->Stages[i];
+            const auto calls = acc.Calls.load(memory_order_relaxed);
+            const auto counts = acc.Counts.load(memory_order_relaxed);
+            if(calls == 0 && counts == 0)
+                continue;
+            auto& r = results[i];
+            r.Calls += calls;
+            r.Counts += counts;
+            r.TotalSecs += acc.Nanos.load(memory_order_relaxed)*1e-9;
+            r.Threads++;
+        }
+    }
+
+    // remove unused stages
+    results.erase(remove_if(results.begin(), results.end(), [] (const result_t& r) {
+        return r.Threads == 0;
+    }), results.end());
+    return results;
+}
+
+void Instrumentation::PrintTable(ostream& s)
+{
+    const auto results = GetResults();
+    size_t width = 5;
+    for(const auto& r : results)
+        width = max(width, r.Name.size());
+
+    s << left << setw(width) << "Stage" << right
+      << setw(12) << "Calls"
+      << setw(12) << "Total/s"
+      << setw(12) << "Avg/us"
+      << setw(14) << "Counts"
+      << setw(8)  << "Threads" << '\n';
+    for(const auto& r : results) {
+        s << left << setw(width) << r.Name << right
+          << setw(12) << r.Calls
+          << setw(12) << fixed << setprecision(3) << r.TotalSecs
+          << setw(12) << fixed << setprecision(3) << (r.Calls>0 ? 1e6*r.TotalSecs/r.Calls : 0.0)
+          << setw(14) << r.Counts
+          << setw(8)  << r.Threads << '\n';
+    }
+}
+
+void Instrumentation::WriteHistograms(TDirectory* dir)
+{
+    if(dir == nullptr)
+        return;
+
+    const auto results = GetResults();
+    if(results.empty())
+        return;
+
+    const string dirname = "Instrumentation";
+    auto subdir = dir->GetDirectory(dirname.c_str());
+    if(subdir == nullptr)
+        subdir = dir->mkdir(dirname.c_str());
+
+    const int nBins = results.size();
+    auto make_hist = [subdir, nBins] (const string& name, const string& title) {
+        auto h = new TH1D(name.c_str(), title.c_str(), nBins, 0, nBins);
+        h->SetDirectory(subdir);
+        return h;
+    };
+
+    auto h_calls  = make_hist("Calls", "Calls per stage");
+    auto h_counts = make_hist("Counts", "Counts per stage");
+    auto h_total  = make_hist("TotalTime", "Total time per stage / s");
+    auto h_avg    = make_hist("AvgTime", "Average time per call / #mus");
+
+    for(int i=0;i<nBins;i++) {
+        const auto& r = results[i];
+        const int bin = i+1;
+        h_calls->SetBinContent(bin, r.Calls);
+        h_counts->SetBinContent(bin, r.Counts);
+        h_total->SetBinContent(bin, r.TotalSecs);
+        h_avg->SetBinContent(bin, r.Calls>0 ? 1e6*r.TotalSecs/r.Calls : 0.0);
+        for(auto h : {h_calls, h_counts, h_total, h_avg})
+            h->GetXaxis()->SetBinLabel(bin, r.Name.c_str());
+    }
+}
+
+void Instrumentation::Reset()
+{
+    // the accumulators are zeroed by their owning threads,
+    // see GetThreadData, until then GetResults skips them
+    auto& registry = GetRegistry();
+    lock_guard<mutex> lock(registry.Mutex);
+    resetGeneration.fetch_add(1, memory_order_acq_rel);
+}
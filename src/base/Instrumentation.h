@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+
+class TDirectory;
+
+namespace ant {
+
+/**
+ * @brief The Instrumentation class provides cheap built-in timers and counters for processing stages
+ *
+ * Stages are registered once by name, usually in a constructor or as a function-static.
+ * Each thread accumulates into its own storage, which is summed up only when the
+ * results are requested. The overhead of a ScopedTimer is two steady_clock readings,
+ * so it can stay enabled in production.
+ *
+ * Example:
+ *
+ *     static const auto stage = Instrumentation::GetStage("Reconstruct/BuildHits");
+ *     Instrumentation::ScopedTimer t(stage);
+ */
+class Instrumentation {
+public:
+    using stage_t = unsigned;
+
+    /**
+     * @brief MaxStages limits the number of stages, additional stages are ignored
+     */
+    static constexpr stage_t MaxStages = 256;
+
+    /**
+     * @brief Enabled can be used to switch off all accounting, also while other threads are running
+     */
+    static std::atomic<bool> Enabled;
+
+    /**
+     * @brief GetStage registers a stage, or returns the already registered one
+     * @param name unique name, use / to group stages
+     * @return the stage id
+     * @note thread-safe, but not meant for hot paths
+     */
+    static stage_t GetStage(const std::string& name);
+
+    /**
+     * @brief Add accounts one call with given duration to stage
+     */
+    static void Add(stage_t stage, std::chrono::nanoseconds elapsed) noexcept;
+
+    /**
+     * @brief Count increments the counter of the stage, independent of timing
+     */
+    static void Count(stage_t stage, std::uint64_t n = 1) noexcept;
+
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(stage_t stage_) noexcept :
+            stage(stage_),
+            enabled(Enabled.load(std::memory_order_relaxed)),
+            start(enabled ? clock_t::now() : clock_t::time_point())
+        {}
+        ~ScopedTimer() {
+            if(enabled)
+                Add(stage, clock_t::now() - start);
+        }
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
+    private:
+        using clock_t = std::chrono::steady_clock;
+        const stage_t stage;
+        const bool enabled; // switching off in between must not account a bogus time
+        const clock_t::time_point start;
+    };
+
+    struct result_t {
+        std::string Name;
+        std::uint64_t Calls = 0;
+        std::uint64_t Counts = 0;
+        double TotalSecs = 0;
+        unsigned Threads = 0; // number of threads which used this stage
+    };
+
+    /**
+     * @brief GetResults sums up the stages over all threads
+     * @return results for all stages which were used, in order of registration
+     */
+    static std::vector<result_t> GetResults();
+
+    /**
+     * @brief PrintTable writes the results as human-readable table
+     */
+    static void PrintTable(std::ostream& s);
+
+    /**
+     * @brief WriteHistograms creates histograms with calls, counts and time per stage
+     * @param dir where the subdirectory "Instrumentation" is created
+     */
+    static void WriteHistograms(TDirectory* dir);
+
+    /**
+     * @brief Reset sets all accumulators to zero, but keeps the stages
+     * @note safe to call while other threads account, their results from before are discarded
+     */
+    static void Reset();
+};
+
+}
@@ -11,6 +11,7 @@
 #include "TH2D.h"
 #include "TH3D.h"
 #include "Compression.h"
+#include "RVersion.h"
 #include "TClass.h"
 
 #include <stdexcept>
@@ -141,9 +142,6 @@ WrapTFileOutput::WrapTFileOutput(const std::string& filename, bool changeDirecto
     else
         file = openFile(filename, root_mode);
 
-    //file->SetCompressionAlgorithm(ROOT::kLZMA);
-    //file->SetCompressionLevel(5);
-
     files.emplace_back(move(file));
 
     VLOG(5) << "Opened file " << filename << " in " << root_mode << "-mode.";
@@ -161,6 +159,45 @@ void WrapTFileOutput::cd()
     files.front()->cd();
 }
 
+void WrapTFileOutput::SetCompression(const string& spec)
+{
+    files.front()->SetCompressionSettings(ParseCompression(spec));
+    VLOG(5) << "Compressing " << files.front()->GetName() << " with " << spec;
+}
+
+int WrapTFileOutput::ParseCompression(const string& spec)
+{
+    const auto tokens = std_ext::tokenize_string(spec, ":");
+    if(tokens.empty() || tokens.size() > 2)
+        throw runtime_error("Compression '"+spec+"' not in format algorithm[:level]");
+
+    const auto& name = tokens.front();
+    ROOT::ECompressionAlgorithm algorithm;
+    if(name == "zlib")
+        algorithm = ROOT::kZLIB;
+    else if(name == "lzma")
+        algorithm = ROOT::kLZMA;
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,8,0)
+    else if(name == "lz4")
+        algorithm = ROOT::kLZ4;
+#endif
+    else
+        throw runtime_error("Unknown compression algorithm '"+name+"'");
+
+    int level = 1;
+    if(tokens.size() == 2) {
+        try {
+            level = stoi(tokens.back());
+        }
+        catch(const logic_error&) {
+            level = -1;
+        }
+        if(level < 1 || level > 9)
+            throw runtime_error("Compression level in '"+spec+"' must be within 1-9");
+    }
+    return ROOT::CompressionSettings(algorithm, level);
+}
+
 
 
 //============================================================================================
@@ -179,6 +179,19 @@ public:
 
     void cd();
 
+    /**
+     * @brief SetCompression applies to all objects created afterwards in the file
+     * @param spec algorithm with optional level 1-9 (default 1), for example "lz4:4" or "lzma:8"
+     * @note Choose lz4 for fast intermediate files, lzma for small archives
+     */
+    void SetCompression(const std::string& spec);
+
+    /**
+     * @brief ParseCompression converts the spec into ROOT's compression settings
+     * @throw std::runtime_error if the algorithm is unknown or the level out of range
+     */
+    static int ParseCompression(const std::string& spec);
+
     template<class T, typename... Args>
     T* CreateInside(Args&&... args)
     {
@@ -7,9 +7,14 @@
 #include "TBufferFile.h"
 #include "TLeaf.h"
 
+#include <set>
+
 using namespace std;
 using namespace ant;
 
+Long64_t WrapTTree::PruningWarmup = 0;
+bool WrapTTree::ParallelUnzip = false;
+
 void WrapTTree::CreateBranches(TTree* tree, bool skipOptional) {
     // some checks first
     if(tree==nullptr)
@@ -109,6 +114,12 @@ void WrapTTree::LinkBranches(TTree* tree, bool requireOptional) {
         ROOTArrayNotifier->PrevNotifier = Tree->GetNotify(); // maybe nullptr, but that's handled by our notifier
         Tree->SetNotify(ROOTArrayNotifier.get());
     }
+
+    // start warm-up for pruning again
+    nReadEntries = 0;
+    pruned = false;
+    for(auto& b : branches)
+        b.Access->Pruned = false;
 }
 
 void WrapTTree::LinkBranches(bool requireOptional)
@@ -116,6 +127,103 @@ void WrapTTree::LinkBranches(bool requireOptional)
     LinkBranches(nullptr, requireOptional);
 }
 
+Int_t WrapTTree::GetEntry(Long64_t entry)
+{
+    if(!pruned && PruningWarmup > 0 && nReadEntries++ == PruningWarmup)
+        Prune();
+    return Tree->GetEntry(entry);
+}
+
+void WrapTTree::Prune()
+{
+    if(!Tree)
+        throw Exception("Set the Tree pointer before calling Prune");
+
+    // the leaf count branches of ROOTArrays are read explicitly by
+    // the TLeaf_wrapper, so they are always kept
+    set<string> keep;
+    set<string> declared;
+    for(auto& b : branches) {
+        const auto& name = b.Access->BranchName;
+        declared.insert(name);
+        auto rootbranch = Tree->GetBranch(name.c_str());
+        if(!rootbranch)
+            continue; // optional branch not present
+        if(b.IsROOTArray) {
+            auto leaf = dynamic_cast<TLeaf*>(rootbranch->GetListOfLeaves()->At(0));
+            if(leaf && leaf->GetLeafCount())
+                keep.insert(leaf->GetLeafCount()->GetBranch()->GetName());
+        }
+        if(b.Access->Accessed) {
+            keep.insert(name);
+        }
+        else {
+            Tree->SetBranchStatus(name.c_str(), 0);
+            b.Access->Pruned = true;
+        }
+    }
+
+    // the current tree of a TChain tells the sizes of the branches
+    TTree* tree = Tree->GetTree() ? Tree->GetTree() : Tree;
+    Long64_t zipBytes = 0;
+    Long64_t keptZipBytes = 0;
+    auto rootbranches = tree->GetListOfBranches();
+    for(int i=0;i<rootbranches->GetEntriesFast();i++) {
+        auto rootbranch = dynamic_cast<TBranch*>(rootbranches->At(i));
+        if(!rootbranch)
+            continue;
+        const string name = rootbranch->GetName();
+        const auto branchZipBytes = rootbranch->GetZipBytes("*");
+        zipBytes += branchZipBytes;
+        if(keep.count(name)) {
+            keptZipBytes += branchZipBytes;
+            continue;
+        }
+        // branches not declared are never used,
+        // unless another WrapTTree with prefix reads them
+        if(branchNamePrefix.empty() && !declared.count(name))
+            Tree->SetBranchStatus(name.c_str(), 0);
+    }
+
+    // size the cache to hold one cluster of the kept branches
+    const auto autoFlush = tree->GetAutoFlush();
+    const auto nEntries = tree->GetEntries();
+    Long64_t cacheSize = 0;
+    if(autoFlush > 0 && nEntries > 0)
+        cacheSize = keptZipBytes/nEntries*autoFlush;
+    else if(autoFlush < 0 && zipBytes > 0)
+        cacheSize = -autoFlush*keptZipBytes/zipBytes;
+    constexpr Long64_t minCacheSize = 1 << 20;
+    constexpr Long64_t maxCacheSize = 256 << 20;
+    cacheSize = std::min(std::max(cacheSize, minCacheSize), maxCacheSize);
+
+    // the cache is trained with the kept branches right away,
+    // trees in memory don't have any
+    if(Tree->GetCurrentFile()) {
+        Tree->SetCacheSize(cacheSize);
+        for(const auto& name : keep)
+            Tree->AddBranchToCache(name.c_str(), true);
+        Tree->StopCacheLearningPhase();
+        if(ParallelUnzip)
+            Tree->SetParallelUnzip(true);
+    }
+
+    pruned = true;
+}
+
+void WrapTTree::Unprune(access_t& access)
+{
+    access.Pruned = false;
+    Tree->SetBranchStatus(access.BranchName.c_str(), 1);
+    Tree->AddBranchToCache(access.BranchName.c_str(), true);
+
+    // read the current entry of the branch, the following ones are read by GetEntry again
+    TTree* tree = Tree->GetTree() ? Tree->GetTree() : Tree;
+    auto rootbranch = tree->GetBranch(access.BranchName.c_str());
+    if(rootbranch && tree->GetReadEntry() >= 0)
+        rootbranch->GetEntry(tree->GetReadEntry());
+}
+
 bool WrapTTree::Matches(TTree* tree, bool exact, bool nowarn) const {
     if(tree == nullptr)
         tree = Tree;
@@ -172,6 +280,9 @@ bool WrapTTree::CopyFrom(const WrapTTree& src) {
         // src branch not found in our list of branches
         if(it_b == branches.end())
             return false;
+        // values are accessed directly below
+        src_b.Access->Touch();
+        it_b->Access->Touch();
         if(it_b->ROOTType != src_b.ROOTType)
             return false;
         // for complex types, we rely on the ROOT machinery to copy them
@@ -45,8 +45,14 @@ namespace ant {
  *
  * Note that WrapTTree even supports branches created with "branchname[sizebranch]" via
  * `WrapTTree::ROOTArray<T>`, which wraps it into an conviniently usable `std::vector<T>`
+ *
+ * When reading with `GetEntry()` instead of `Tree->GetEntry()`, the branches
+ * which are never accessed can be pruned after some entries, see `PruningWarmup`.
  */
 class WrapTTree {
+private:
+    struct access_t; // tracks if a branch is accessed, see GetEntry
+
 public:
     /**
      * @brief Tree to be used as usual TTree
@@ -69,6 +75,37 @@ public:
     // to avoid bogus LinkBranchs(nullptr, true) call
     void LinkBranches(bool requireOptional);
 
+    /**
+     * @brief GetEntry reads the entry like Tree->GetEntry, but prunes the unused branches after some entries
+     *
+     * After PruningWarmup entries were read with all branches enabled, the branches never
+     * accessed so far are disabled and the TTreeCache is sized and trained for the remaining ones,
+     * see Prune(). If a pruned branch is accessed later, it's enabled again and read for the
+     * current entry, so pruning never changes the values seen.
+     * @note Tree must not be read by any other WrapTTree, except by ones with branch name prefix
+     * @return number of bytes read
+     */
+    Int_t GetEntry(Long64_t entry);
+
+    /**
+     * @brief Prune disables the branches not accessed so far, and also the undeclared ones if no prefix is used
+     */
+    void Prune();
+
+    bool IsPruned() const { return pruned; }
+
+    /**
+     * @brief PruningWarmup is the number of entries GetEntry reads before pruning, 0 (default) disables pruning
+     * @note only enable it if no TTree is read by several WrapTTrees without branch name prefix,
+     * as WrapTFileInput::GetObject may hand out the same TTree several times
+     */
+    static Long64_t PruningWarmup;
+
+    /**
+     * @brief ParallelUnzip lets the TTreeCache unzip the following baskets in a background thread once pruned
+     */
+    static bool ParallelUnzip;
+
     /**
      * @brief Matches checks if the branch names are all available
      * @param tree the tree to check
@@ -115,10 +152,15 @@ public:
                                   reinterpret_cast<void**>(std::addressof(Value.Ptr)),
                                   std::is_base_of<ROOTArray_traits, T>::value,
                                   optionalIsPresent);
+            branches.back().Access = std::unique_ptr<access_t>(
+                                         new access_t(wraptree, wraptree.branchNamePrefix+name));
+            Access = branches.back().Access.get();
         }
         ~Branch_t() = default;
         Branch_t(const Branch_t&) = delete;
         Branch_t& operator= (const Branch_t& other) {
+            other.Access->Touch();
+            Access->Touch();
             *Value = *(other.Value);
             return *this;
         }
@@ -128,20 +170,20 @@ public:
         const std::string Name;
 
         // implicit conversion
-        operator T& () { return *Value; }
-        operator const T& () const { return *Value; }
+        operator T& () { Access->Touch(); return *Value; }
+        operator const T& () const { Access->Touch(); return *Value; }
         // assignment/move
-        T& operator= (const T& v) { *Value = v; return *Value; }
-        T& operator= (T&& v) { *Value = v; return *Value; }
+        T& operator= (const T& v) { Access->Touch(); *Value = v; return *Value; }
+        T& operator= (T&& v) { Access->Touch(); *Value = v; return *Value; }
         // if you need to call methods of T, sometimes operator() is handy
-        T& operator() () { return *Value; }
-        const T& operator() () const { return *Value; }
+        T& operator() () { Access->Touch(); return *Value; }
+        const T& operator() () const { Access->Touch(); return *Value; }
         // subscript access for more convinient access
         // templated to use SFINAE for typedefs T::reference, T::const_reference
         template<typename U = T>
-        typename U::reference operator[](std::size_t n) { return (*Value)[n]; }
+        typename U::reference operator[](std::size_t n) { Access->Touch(); return (*Value)[n]; }
         template<typename U = T>
-        typename U::const_reference operator[](std::size_t n) const { return (*Value)[n]; }
+        typename U::const_reference operator[](std::size_t n) const { Access->Touch(); return (*Value)[n]; }
     private:
         struct Value_t {
             explicit Value_t(T* ptr) : Ptr(ptr) {}
@@ -159,6 +201,7 @@ public:
             T* Ptr;
         };
         Value_t Value;
+        access_t* Access;
     };
 
     template<typename T>
@@ -254,6 +297,22 @@ protected:
     ~WrapTTree();
 
 private:
+    struct access_t {
+        WrapTTree& Owner;
+        const std::string BranchName; // including prefix
+        bool Accessed = false;
+        bool Pruned = false;
+
+        access_t(WrapTTree& owner, const std::string& branchName) :
+            Owner(owner), BranchName(branchName) {}
+
+        void Touch() {
+            if(Pruned)
+                Owner.Unprune(*this);
+            Accessed = true;
+        }
+    };
+
     struct ROOT_branchinfo_t {
         const std::string Name;
         TClass * const ROOTClass;
@@ -270,6 +329,7 @@ private:
         void** const ValuePtr;
         const bool IsROOTArray;
         bool* const OptionalIsPresent; // is nullptr if branch non-optional
+        std::unique_ptr<access_t> Access;
 
         ROOT_branch_t(const std::string& name,
                       TClass* rootClass,
@@ -292,6 +352,10 @@ private:
     const std::string branchNamePrefix;
     std::vector<ROOT_branch_t> branches;
 
+    Long64_t nReadEntries = 0;
+    bool pruned = false;
+    void Unprune(access_t& access);
+
     struct ROOTArrayNotifier_t;
     const std::unique_ptr<ROOTArrayNotifier_t> ROOTArrayNotifier;
     void HandleROOTArray(const std::string& branchname, void** valuePtr);
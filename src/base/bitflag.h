@@ -1,3 +1,5 @@
+#pragma once
+
 #include <bitset>
 
 namespace ant {
@@ -11,6 +13,7 @@ public:
     constexpr bitflag() = default;
     constexpr bitflag(Enum value) : bits(1 << static_cast<std::size_t>(value)) {}
     constexpr bitflag(const bitflag& other) : bits(other.bits) {}
+    bitflag& operator=(const bitflag&) = default;
 
     bool operator==(const bitflag& o) const { return bits == o.bits; }
     bool operator!=(const bitflag& o) const { return bits != o.bits; }
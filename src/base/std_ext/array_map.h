@@ -0,0 +1,198 @@
+#pragma once
+
+#include "base/std_ext/mapped_vectors.h" // to_integral
+#include "base/std_ext/variadic.h"
+
+#include <array>
+#include <iterator>
+#include <utility>
+#include <cstddef>
+
+namespace ant {
+namespace std_ext {
+
+/**
+ * @brief The array_map class is a std::map replacement for small enum keys
+ *
+ * The values are stored in a fixed array indexed by the key, so no nodes
+ * are allocated. Clearing keeps the values' allocated memory (if they have any),
+ * so re-using one instance event by event does not allocate in the steady state.
+ * Iteration is in ascending key order, as for std::map.
+ * As for std::map, the keys of the value_type are const, they're fixed to the index at construction.
+ *
+ * @note Value must be default constructible and provide clear()
+ */
+template<typename Key, typename Value, std::size_t N>
+class array_map {
+public:
+    using key_type = Key;
+    using mapped_type = Value;
+    using value_type = std::pair<const Key, Value>;
+    using size_type = std::size_t;
+
+private:
+    using storage_t = std::array<value_type, N>;
+    storage_t items;
+    std::array<bool, N> occupied;
+    size_type n_occupied = 0;
+
+    static size_type index(const Key& key) noexcept {
+        return static_cast<size_type>(to_integral(key));
+    }
+
+    template<std::size_t... Is>
+    static storage_t make_items(indices<Is...>) {
+        return {{ value_type(static_cast<Key>(Is), Value())... }};
+    }
+
+    template<typename Other>
+    void assign_from(Other&& other) {
+        for(size_type i=0;i<N;i++)
+            items[i].second = std::forward<Other>(other).items[i].second;
+        occupied = other.occupied;
+        n_occupied = other.n_occupied;
+    }
+
+    template<bool is_const>
+    class iterator_t {
+    public:
+        using container_t = typename std::conditional<is_const, const array_map, array_map>::type;
+        using value_type = typename std::conditional<is_const, const typename array_map::value_type, typename array_map::value_type>::type;
+        using iterator_category = std::forward_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using pointer = value_type*;
+        using reference = value_type&;
+
+        iterator_t() = default;
+
+        // convert from non-const to const iterator
+        template<bool other_const, typename = typename std::enable_if<is_const && !other_const>::type>
+        iterator_t(const iterator_t<other_const>& other) noexcept :
+            c(other.c), i(other.i) {}
+
+        reference operator*() const noexcept { return c->items[i]; }
+        pointer operator->() const noexcept { return &c->items[i]; }
+
+        iterator_t& operator++() noexcept {
+            ++i; skip(); return *this;
+        }
+
+        friend bool operator==(const iterator_t& x, const iterator_t& y) noexcept {
+            return x.i == y.i;
+        }
+        friend bool operator!=(const iterator_t& x, const iterator_t& y) noexcept {
+            return x.i != y.i;
+        }
+
+    private:
+        friend class array_map;
+        template<bool> friend class iterator_t;
+        container_t* c = nullptr;
+        size_type i = N;
+
+        iterator_t(container_t* c_, size_type i_) noexcept : c(c_), i(i_) { skip(); }
+
+        void skip() noexcept {
+            while(i<N && !c->occupied[i])
+                ++i;
+        }
+    };
+
+public:
+    using iterator = iterator_t<false>;
+    using const_iterator = iterator_t<true>;
+
+    array_map() : items(make_items(build_indices<N>())) {
+        occupied.fill(false);
+    }
+
+    array_map(const array_map&) = default;
+    array_map(array_map&&) = default;
+
+    // the const keys prevent the default assignment, so only the values are assigned
+    array_map& operator=(const array_map& other) {
+        assign_from(other);
+        return *this;
+    }
+    array_map& operator=(array_map&& other) {
+        assign_from(std::move(other));
+        return *this;
+    }
+
+    iterator       begin()       noexcept { return {this, 0}; }
+    const_iterator begin() const noexcept { return {this, 0}; }
+    iterator       end()         noexcept { return {this, N}; }
+    const_iterator end()   const noexcept { return {this, N}; }
+
+    size_type size() const noexcept { return n_occupied; }
+    bool empty() const noexcept { return n_occupied == 0; }
+
+    iterator find(const Key& key) noexcept {
+        const auto i = index(key);
+        return i<N && occupied[i] ? iterator{this, i} : end();
+    }
+    const_iterator find(const Key& key) const noexcept {
+        const auto i = index(key);
+        return i<N && occupied[i] ? const_iterator{this, i} : end();
+    }
+
+    size_type count(const Key& key) const noexcept {
+        return find(key) != end();
+    }
+
+    /**
+     * @brief operator[] returns the value for the key, marking it as present
+     * @note the value keeps its state from before the last clear(), so it's usually cleared but may have reserved memory
+     */
+    Value& operator[](const Key& key) {
+        const auto i = index(key);
+        if(!occupied[i]) {
+            occupied[i] = true;
+            ++n_occupied;
+        }
+        return items[i].second;
+    }
+
+    std::pair<iterator, bool> insert(value_type&& v) {
+        const auto i = index(v.first);
+        if(occupied[i])
+            return {iterator{this, i}, false};
+        items[i].second = std::move(v.second);
+        occupied[i] = true;
+        ++n_occupied;
+        return {iterator{this, i}, true};
+    }
+
+    // the hint is ignored, but provides the std::map interface
+    iterator insert(const_iterator, value_type&& v) {
+        return insert(std::move(v)).first;
+    }
+
+    size_type erase(const Key& key) {
+        const auto i = index(key);
+        if(!occupied[i])
+            return 0;
+        items[i].second.clear();
+        occupied[i] = false;
+        --n_occupied;
+        return 1;
+    }
+
+    iterator erase(const_iterator it) {
+        const auto i = it.i;
+        erase(items[i].first);
+        return {this, i+1};
+    }
+
+    void clear() {
+        for(size_type i=0;i<N;i++) {
+            if(!occupied[i])
+                continue;
+            items[i].second.clear();
+            occupied[i] = false;
+        }
+        n_occupied = 0;
+    }
+};
+
+}} // namespace ant::std_ext
@@ -4,6 +4,7 @@
 
 #include <unistd.h>
 #include <dirent.h>
+#include <cerrno>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -124,6 +125,20 @@ bool ant::std_ext::system::path_exists(const string& path) {
     return 0 == lstat(path.c_str(), &lbuf);
 }
 
+bool system::makeDirectories(const string& path)
+{
+    // create each parent in turn, existing ones are fine
+    for(auto pos = path.find('/', 1); ; pos = path.find('/', pos+1)) {
+        const auto dir = path.substr(0, pos);
+        if(!dir.empty() && mkdir(dir.c_str(), 0777) != 0 && errno != EEXIST)
+            return false;
+        if(pos == string::npos)
+            break;
+    }
+    struct stat buf;
+    return stat(path.c_str(), &buf) == 0 && S_ISDIR(buf.st_mode);
+}
+
 bool system::testopen(const string& filename)
 {
     string errmsg;
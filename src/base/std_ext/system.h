@@ -78,6 +78,12 @@ struct system {
      */
     static bool path_exists(const std::string& path);
 
+    /**
+     * @brief makeDirectories creates the directory and its missing parents, like mkdir -p
+     * @param path to the directory
+     * @return true if the directory exists afterwards
+     */
+    static bool makeDirectories(const std::string& path);
 
 };
 }
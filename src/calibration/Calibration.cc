@@ -0,0 +1,18 @@
+#include "Calibration.h"
+
+#include "tree/TDetectorReadHit.h"
+
+using namespace std;
+using namespace ant;
+
+void Calibration::Converter::ConvertAll(const hits_t& hits, Channel_t::Type_t channelType, batch_t& batch) const
+{
+    batch.Values.resize(0);
+    batch.Offsets.resize(0);
+    batch.Offsets.push_back(0);
+    for(const TDetectorReadHit& hit : hits) {
+        if(hit.ChannelType == channelType)
+            ConvertTo(hit.RawData, batch.Values);
+        batch.Offsets.push_back(batch.Values.size());
+    }
+}
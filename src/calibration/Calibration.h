@@ -25,8 +25,40 @@ public:
      */
     struct Converter {
         using ptr_t = std::shared_ptr<const Converter>;
+        using hits_t = std::vector<std::reference_wrapper<TDetectorReadHit>>;
+
+        /**
+         * @brief ConvertTo appends the values converted from rawData to values
+         *
+         * Does not allocate as long as the capacity of values suffices,
+         * so values can be reused for all hits.
+         */
+        virtual void ConvertTo(const std::vector<uint8_t>& rawData, std::vector<double>& values) const = 0;
+
+        std::vector<double> Convert(const std::vector<uint8_t>& rawData) const {
+            std::vector<double> values;
+            ConvertTo(rawData, values);
+            return values;
+        }
+
+        /**
+         * @brief The batch_t struct holds the converted values of all hits of a detector,
+         * the values of hit i are [Begin(i), End(i))
+         */
+        struct batch_t {
+            std::vector<double>      Values;
+            std::vector<std::size_t> Offsets; // one more than hits
+
+            const double* Begin(std::size_t i) const { return Values.data()+Offsets[i]; }
+            const double* End(std::size_t i) const { return Values.data()+Offsets[i+1]; }
+        };
+
+        /**
+         * @brief ConvertAll converts the raw data of all hits with the given channel type at once
+         * @param batch is overwritten, hits of other channel types get no values
+         */
+        virtual void ConvertAll(const hits_t& hits, Channel_t::Type_t channelType, batch_t& batch) const;
 
-        virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const = 0;
         virtual ~Converter() = default;
     };
 
@@ -0,0 +1,46 @@
+#include "Fingerprint.h"
+
+#include "DataManager.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration;
+
+void Fingerprint::add(const TCalibrationData& cdata)
+{
+    add(cdata.CalibrationID);
+    add(cdata.FirstID);
+    add(cdata.LastID);
+    add(cdata.TimeStamp);
+    add(cdata.Data.size());
+    for(const auto& kv : cdata.Data) {
+        add(kv.Key);
+        add(kv.Value);
+    }
+    add(cdata.FitParameters.size());
+    for(const auto& kv : cdata.FitParameters) {
+        add(kv.Key);
+        add(kv.Value.size());
+        add(kv.Value.data(), kv.Value.size()*sizeof(double));
+    }
+}
+
+void Fingerprint::add(const DataManager& calmgr, const string& calibrationID,
+                      const TID& firstID, const TID& lastID)
+{
+    add(calibrationID);
+
+    // walk along the change points within the range
+    TID tid = firstID;
+    while(true) {
+        TCalibrationData cdata;
+        TID nextChangePoint;
+        const bool found = calmgr.GetData(calibrationID, tid, cdata, nextChangePoint);
+        add(found);
+        if(found)
+            add(cdata);
+        if(nextChangePoint.IsInvalid() || !(tid < nextChangePoint) || lastID < nextChangePoint)
+            break;
+        tid = nextChangePoint;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "tree/TID.h"
+#include "tree/TCalibrationData.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace ant {
+namespace calibration {
+
+class DataManager;
+
+/**
+ * @brief The Fingerprint struct hashes data with FNV-1a, simple and good enough to detect changes
+ */
+struct Fingerprint {
+    using value_t = std::uint64_t;
+
+    value_t Value = 14695981039346656037ULL;
+
+    void add(const void* data, std::size_t n) {
+        auto bytes = reinterpret_cast<const unsigned char*>(data);
+        for(std::size_t i=0;i<n;i++) {
+            Value ^= bytes[i];
+            Value *= 1099511628211ULL;
+        }
+    }
+    template<typename T>
+    void add(const T& v) {
+        static_assert(std::is_arithmetic<T>::value, "Only arithmetic types");
+        add(std::addressof(v), sizeof(T));
+    }
+    void add(const std::string& s) {
+        add(s.size());
+        add(s.data(), s.size());
+    }
+    void add(const TID& tid) {
+        add(tid.Flags);
+        add(tid.Value());
+    }
+    void add(const TCalibrationData& cdata);
+
+    /**
+     * @brief add all calibration data of calibrationID within the given range of TIDs
+     * @note walks along the change points, so changed ranges change the fingerprint as well
+     */
+    void add(const DataManager& calmgr, const std::string& calibrationID,
+             const TID& firstID, const TID& lastID);
+};
+
+}} // namespace ant::calibration
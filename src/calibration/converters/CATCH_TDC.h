@@ -15,26 +15,25 @@ struct CATCH_TDC : MultiHitReference<std::uint16_t> {
         MultiHitReference(referenceChannel, Gains::CATCH_TDC)
     {}
 
-    virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const override
+    virtual void ConvertTo(const std::vector<uint8_t>& rawData, std::vector<double>& values) const override
     {
         // we can only convert if we have exactly one reference hit timing
         if(ReferenceHits.size() != 1)
-            return {};
+            return;
         const std::int32_t refHit = ReferenceHits.front();
         // reject conversion if refhit is invalid (0xffff)
         constexpr std::uint16_t max_u16bit = std::numeric_limits<std::uint16_t>::max();
         if(refHit == max_u16bit)
-            return {};
-
-        auto rawHits = MultiHit<std::uint16_t>::template ConvertRaw<std::int32_t>(rawData);
+            return;
 
         // the magic value was originally 62054, but
         // investigating the output of the CATCH TDC showed that 62121 seems more
         // like the "true" overflow value of the F1 chip
         constexpr std::int32_t CATCH_Overflow = 62054;
 
-        std::vector<double> hits;
-        for(const std::uint16_t rawHit : rawHits) {
+        const std::size_t n = NumberOfWords(rawData);
+        for(std::size_t i=0;i<n;i++) {
+            const std::uint16_t rawHit = GetWord(rawData, i);
             // reject invalid rawhits
             if(rawHit == max_u16bit) {
                 continue;
@@ -47,10 +46,8 @@ struct CATCH_TDC : MultiHitReference<std::uint16_t> {
             const auto value_m = value - CATCH_Overflow;
             value = abs(value) < abs(value_p) ? value : value_p;
             value = abs(value) < abs(value_m) ? value : value_m;
-            hits.push_back(value*Gain);
+            values.push_back(value*Gain);
         }
-
-        return hits;
     }
 };
 
@@ -14,25 +14,35 @@ template<typename T>
 struct MultiHit : Calibration::Converter {
 
 
-    virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const override
+    virtual void ConvertTo(const std::vector<uint8_t>& rawData, std::vector<double>& values) const override
     {
         // just convert T to double
-        return ConvertRaw<double>(rawData);
+        ConvertRaw(rawData, values);
     }
 
 protected:
-    template<typename U = T>
-    static std::vector<U> ConvertRaw(const std::vector<std::uint8_t>& rawData)
+    // number of T words in rawData, zero if rawData does not consist of full words
+    static std::size_t NumberOfWords(const std::vector<std::uint8_t>& rawData)
     {
         constexpr std::size_t wordsize = sizeof(T)/sizeof(std::uint8_t);
         if(rawData.size() % wordsize  != 0)
-            return {};
-        std::vector<U> ret(rawData.size()/wordsize);
-        for(size_t i=0;i<ret.size();i++) {
-            const T* rawVal = reinterpret_cast<const T*>(std::addressof(rawData[wordsize*i]));
-            ret[i] = static_cast<U>(*rawVal);
-        }
-        return ret;
+            return 0;
+        return rawData.size()/wordsize;
+    }
+
+    static T GetWord(const std::vector<std::uint8_t>& rawData, std::size_t i)
+    {
+        constexpr std::size_t wordsize = sizeof(T)/sizeof(std::uint8_t);
+        return *reinterpret_cast<const T*>(std::addressof(rawData[wordsize*i]));
+    }
+
+    // appends the words of rawData to values
+    template<typename U>
+    static void ConvertRaw(const std::vector<std::uint8_t>& rawData, std::vector<U>& values)
+    {
+        const std::size_t n = NumberOfWords(rawData);
+        for(size_t i=0;i<n;i++)
+            values.push_back(static_cast<U>(GetWord(rawData, i)));
     }
 };
 
@@ -27,17 +27,16 @@ struct MultiHitReference : MultiHit<T>, ReconstructHook::DetectorReadHits {
         Gain(gain)
     {}
 
-    virtual std::vector<double> Convert(const std::vector<uint8_t>& rawData) const override
+    virtual void ConvertTo(const std::vector<uint8_t>& rawData, std::vector<double>& values) const override
     {
         // we can only convert if we have a reference hit timing
         if(ReferenceHits.size() != 1)
-            return {};
-        const auto refHit = ReferenceHits.front();
-        auto hits = MultiHit<T>::template ConvertRaw<double>(rawData);
+            return;
+        const double refHit = ReferenceHits.front();
+        const std::size_t n = MultiHit<T>::NumberOfWords(rawData);
         /// \todo think about hit/refHit overflow here?
-        for(auto& hit : hits)
-            hit = (hit - refHit)*Gain;
-        return hits;
+        for(std::size_t i=0;i<n;i++)
+            values.push_back((MultiHit<T>::GetWord(rawData, i) - refHit)*Gain);
     }
 
     virtual void ApplyTo(const readhits_t& hits) override {
@@ -53,7 +52,12 @@ struct MultiHitReference : MultiHit<T>, ReconstructHook::DetectorReadHits {
         if(it_refhit == refhits.cend())
             return;
         // use the same converter for the reference hit
-        ReferenceHits = MultiHit<T>::template ConvertRaw<T>(it_refhit->get().RawData);
+        MultiHit<T>::ConvertRaw(it_refhit->get().RawData, ReferenceHits);
+    }
+
+    // only looks for the reference hit
+    virtual bool Modifies(Detector_t::Type_t, Channel_t::Type_t) const override {
+        return false;
     }
 
 protected:
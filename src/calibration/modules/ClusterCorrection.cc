@@ -44,7 +44,7 @@ ClusterCorrection::~ClusterCorrection()
 }
 
 
-void ClusterCorrection::ApplyTo(clusters_t& clusters)
+void ClusterCorrection::ApplyTo(clusters_t& clusters, const TID&)
 {
 
     if(interpolator) {
@@ -99,10 +99,42 @@ std::list<Updateable_traits::Loader_t> ClusterCorrection::GetLoaders()
     };
 }
 
+ClusterSmearing::ClusterSmearing(std::shared_ptr<ClusterDetector_t> det,
+                                 const string& Name, const Filter_t Filter,
+                                 std::shared_ptr<DataManager> calmgr) :
+    ClusterCorrection(det, Name, Filter, calmgr),
+    rng((CounterRNG::key_t(gRandom->Integer(kMaxUInt)) << 32) | gRandom->Integer(kMaxUInt))
+{}
+
+void ClusterSmearing::ApplyTo(clusters_t& clusters, const TID& id)
+{
+    if(!interpolator)
+        return;
+
+    rng.SetStream(id.Value());
+
+    const auto& entry = clusters.find(DetectorType);
+    if(entry == clusters.end())
+        return;
+
+    auto& detclusters = entry->second;
+    deviates.resize(detclusters.size());
+    rng.Gaus(deviates);
+
+    auto deviate = deviates.begin();
+    for(auto& cluster : detclusters) {
+        const auto sigma  = interpolator->GetPoint(cluster.Energy, cos(cluster.Position.Theta()));
+        cluster.Energy   += sigma*(*deviate++);
+
+        if(cluster.Energy < 0.0)
+            cluster.Energy = 0.0;
+    }
+}
+
 void ClusterSmearing::ApplyTo(TCluster& cluster)
 {
     const auto sigma  = interpolator->GetPoint(cluster.Energy, cos(cluster.Position.Theta()));
-    cluster.Energy    = gRandom->Gaus(cluster.Energy, sigma);
+    cluster.Energy    = rng.Gaus(cluster.Energy, sigma);
 }
 
 void ClusterECorr::ApplyTo(TCluster& cluster)
@@ -3,11 +3,12 @@
 #include "calibration/Calibration.h"
 #include "base/Detector_t.h"
 #include "base/OptionsList.h"
-#include "base/Detector_t.h"
+#include "base/CounterRNG.h"
 
 #include "tree/TID.h" // for TKeyValue, TID
 
 #include <memory>
+#include <vector>
 
 
 namespace ant {
@@ -33,7 +34,7 @@ public:
     };
 
     // ReconstructHook
-    virtual void ApplyTo(clusters_t& clusters) override;
+    virtual void ApplyTo(clusters_t& clusters, const TID& id) override;
 
     virtual void ApplyTo(TCluster& cluster) =0;
 
@@ -59,12 +60,25 @@ protected:
 
 /**
  * @brief Cluster energy smearing based on energy and cos(theta)
+ *
+ * The deviates for all clusters of an event are drawn at once from a counter-based
+ * generator, using the event's id as stream, so the smearing does not depend on the
+ * processing order. The key is taken from gRandom on construction.
  */
 class ClusterSmearing : public ClusterCorrection {
 public:
-    using ClusterCorrection::ClusterCorrection;
+    ClusterSmearing(
+            std::shared_ptr<ClusterDetector_t> det,
+            const std::string& Name,
+            const Filter_t Filter,
+            std::shared_ptr<DataManager> calmgr);
 
+    virtual void ApplyTo(clusters_t& clusters, const TID& id) override;
     void ApplyTo(TCluster& cluster);
+
+protected:
+    CounterRNG rng;
+    std::vector<double> deviates;
 };
 
 /**
@@ -53,8 +53,12 @@ void Energy::ApplyTo(const readhits_t& hits)
 {
     const auto& dethits = hits.get_item(DetectorType);
 
+    // convert the raw data of all hits at once
+    Converter->ConvertAll(dethits, ChannelType, converted);
+
     // now calibrate the Energies (ignore any other kind of hits)
-    for(TDetectorReadHit& dethit : dethits) {
+    for(size_t i=0;i<dethits.size();i++) {
+        TDetectorReadHit& dethit = dethits[i];
         if(dethit.ChannelType != ChannelType)
             continue;
 
@@ -64,8 +68,8 @@ void Energy::ApplyTo(const readhits_t& hits)
             dethit.Values.resize(0);
 
             // apply pedestal/gain to each of the values (might be multihit)
-            for(const double& conv : Converter->Convert(dethit.RawData)) {
-                TDetectorReadHit::Value_t value(conv);
+            for(auto conv = converted.Begin(i); conv != converted.End(i); ++conv) {
+                TDetectorReadHit::Value_t value(*conv);
                 value.Calibrated -= Pedestals.Get(dethit.Channel);
 
                 const double threshold = Thresholds_Raw.Get(dethit.Channel);
@@ -21,6 +21,9 @@ class Energy :
 public:
     // ReconstructHook
     virtual void ApplyTo(const readhits_t& hits) override;
+    virtual bool Modifies(Detector_t::Type_t detectorType, Channel_t::Type_t channelType) const override {
+        return detectorType == DetectorType && channelType == ChannelType;
+    }
 
     // Updateable_traits interface
     virtual std::list<Loader_t> GetLoaders() override;
@@ -51,6 +54,7 @@ protected:
     const std::shared_ptr<DataManager> calibrationManager;
 
     const Calibration::Converter::ptr_t Converter;
+    Calibration::Converter::batch_t converted; // reused in ApplyTo
 
     CalibType Pedestals;
     CalibType Photons;
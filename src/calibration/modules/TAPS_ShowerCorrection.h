@@ -12,7 +12,7 @@ class TAPS_ShowerCorrection :
 {
 public:
 
-    virtual void ApplyTo(clusters_t& sorted_clusters) override {
+    virtual void ApplyTo(clusters_t& sorted_clusters, const TID&) override {
         // search for TAPS clusters
         const auto it_sorted_clusters = sorted_clusters.find(Detector_t::Type_t::TAPS);
         if(it_sorted_clusters == sorted_clusters.end())
@@ -18,6 +18,7 @@ public:
 protected:
     const Detector_t::Type_t DetectorType;
     const Calibration::Converter::ptr_t Converter;
+    std::vector<double> converted; // reused in ApplyTo
 };
 
 }}
@@ -104,7 +104,8 @@ void Time::ApplyTo(const readhits_t& hits)
 
         // the Converter is smart enough to account for reference times
         // by (possibly) being itself a reconstruction hook and searching for it
-        const auto& converted = Converters[dethit.Channel]->Convert(dethit.RawData);
+        converted.resize(0);
+        Converters[dethit.Channel]->ConvertTo(dethit.RawData, converted);
 
         // apply gain/offset to each of the values (might be multihit)
         for(const double& conv : converted) {
@@ -93,6 +93,9 @@ public:
 
     // ReconstructHook
     virtual void ApplyTo(const readhits_t& hits) override;
+    virtual bool Modifies(Detector_t::Type_t detectorType, Channel_t::Type_t channelType) const override {
+        return detectorType == Detector->Type && channelType == Channel_t::Type_t::Timing;
+    }
 
     // Updateable_traits interface
     virtual std::list<Loader_t> GetLoaders() override;
@@ -107,6 +110,7 @@ protected:
     std::shared_ptr<DataManager> calibrationManager;
 
     std::vector<Calibration::Converter::ptr_t> Converters;
+    std::vector<double> converted; // reused in ApplyTo
 
     std::vector<interval<double>> TimeWindows;
 
@@ -18,11 +18,11 @@ using namespace ant;
 std::string ExpConfig::Setup::manualName = ""; // default empty
 ExpConfig::Setup::SetupPtr ExpConfig::Setup::currentSetup = nullptr; // default nothing found so far
 
-void ExpConfig::Setup::SetByTID(const TID& tid)
+ExpConfig::Setup::SetupPtr ExpConfig::Setup::FindByTID(const TID& tid)
 {
     if(!manualName.empty()) {
-        // ignore requests to set by TID if name was specified
-        return;
+        // the name was specified, so no search by TID
+        return currentSetup;
     }
 
     // go to automatic search mode in all registered setups
@@ -43,23 +43,42 @@ void ExpConfig::Setup::SetByTID(const TID& tid)
     if(setups.size()>1)
         throw Exception(std_ext::formatter() << "More than one setup found for TID " << tid);
 
+    return setups.back();
+}
+
+void ExpConfig::Setup::SetByTID(const TID& tid)
+{
+    if(!manualName.empty()) {
+        // ignore requests to set by TID if name was specified
+        return;
+    }
+
     // remember last found
-    currentSetup = setups.back();
+    currentSetup = FindByTID(tid);
 
     LOG(INFO) << "Auto-detected setup with name " << currentSetup->GetName();
 }
 
 const expconfig::Setup_traits& ExpConfig::Setup::Get()
+{
+    return *GetShared();
+}
+
+ExpConfig::Setup::SetupPtr ExpConfig::Setup::GetShared()
 {
     if(!currentSetup)
         throw ExceptionNoSetup("No setup available. Call ExpConfig::Setup::SetBy* methods");
-    return *currentSetup;
+    return currentSetup;
 }
 
 shared_ptr<Detector_t> ExpConfig::Setup::GetDetector(Detector_t::Type_t type)
 {
-    auto& config = Get();
-    for(const auto& detector : config.GetDetectors()) {
+    return GetDetector(Get(), type);
+}
+
+shared_ptr<Detector_t> ExpConfig::Setup::GetDetector(const expconfig::Setup_traits& setup, Detector_t::Type_t type)
+{
+    for(const auto& detector : setup.GetDetectors()) {
         if(detector->Type == type)
             return detector;
     }
@@ -74,6 +93,22 @@ void ExpConfig::Setup::SetByName(const string& setupname)
         throw ExceptionNoSetup("No setup found in registry with name "+setupname);
 }
 
+ExpConfig::Setup::SetupPtr ExpConfig::Setup::FindByName(const string& setupname)
+{
+    auto setup = expconfig::SetupRegistry::GetSetup(setupname);
+    if(!setup)
+        throw ExceptionNoSetup("No setup found in registry with name "+setupname);
+    return setup;
+}
+
+ExpConfig::Setup::SetupPtr ExpConfig::Setup::Create(const string& setupname, OptionsPtr options)
+{
+    auto setup = expconfig::SetupRegistry::CreateSetup(setupname, options);
+    if(!setup)
+        throw ExceptionNoSetup("No setup found in registry with name "+setupname);
+    return setup;
+}
+
 void ExpConfig::Setup::Cleanup()
 {
     currentSetup = nullptr;
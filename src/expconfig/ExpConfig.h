@@ -12,6 +12,7 @@
 #include "reconstruct/Reconstruct_traits.h"
 #include "calibration/Calibration.h"
 #include "base/piecewise_interval.h"
+#include "base/OptionsList.h"
 
 #include <memory>
 #include <list>
@@ -32,6 +33,16 @@ public:
     class Setup {
     public:
 
+        /**
+         * @brief SetupPtr is the explicit context of a setup, as handed to Reconstruct, the unpackers and CandidateBuilder
+         *
+         * Those use the currently set setup by default, see Get(). Passing the setup explicitly
+         * lets several contexts, for example of different setups or setup options, live in one process.
+         * @note the calibration modules of a setup are updated while processing a range of TIDs,
+         * so concurrent contexts of different runs need their own instance, see Create()
+         */
+        using SetupPtr = std::shared_ptr<const expconfig::Setup_traits>;
+
         /**
          * @brief Get returns the currently set setup
          * @return the Setup_traits instance, see also GetByType if specific cast is needed
@@ -39,12 +50,26 @@ public:
          */
         static const expconfig::Setup_traits& Get();
 
+        /**
+         * @brief GetShared returns the currently set setup as explicit context
+         * @return setup pointer, never nullptr
+         * @throws ExceptionNoSetup if no setup is set
+         */
+        static SetupPtr GetShared();
+
         /**
          *  @brief the templated version of Get() for specialized setups (typically used by unpackers)
          */
         template<typename SetupType>
         static const SetupType& GetByType();
 
+        /**
+         *  @brief GetByType casts the given setup context
+         *  @throws ExceptionNoSetup if setup does not implement SetupType
+         */
+        template<typename SetupType>
+        static const SetupType& GetByType(const expconfig::Setup_traits& setup);
+
         /**
          * @brief GetDetector ask for detector by type
          * @param type the requested type
@@ -54,6 +79,11 @@ public:
          */
         static std::shared_ptr<Detector_t> GetDetector(Detector_t::Type_t type);
 
+        /**
+         * @brief GetDetector ask the given setup context for detector by type
+         */
+        static std::shared_ptr<Detector_t> GetDetector(const expconfig::Setup_traits& setup, Detector_t::Type_t type);
+
         /**
          * @brief the templated version of GetDetector() for specialized detectors,
          * @example Use as GetDetector<TaggerDetector_T>() to obtain tagger in setup
@@ -62,6 +92,31 @@ public:
         template<typename DetectorType>
         static std::shared_ptr<DetectorType> GetDetector();
 
+        template<typename DetectorType>
+        static std::shared_ptr<DetectorType> GetDetector(const expconfig::Setup_traits& setup);
+
+        /**
+         * @brief FindByTID searches the setup for tid like SetByTID, but does not make it the current one
+         * @return the setup set by name if SetByName was used, otherwise the matching setup
+         * @throws Exception if none or more than one setup matches
+         */
+        static SetupPtr FindByTID(const TID& tid);
+
+        /**
+         * @brief FindByName returns the setup from the registry, without making it the current one
+         * @throws ExceptionNoSetup if no setup was found with that name
+         */
+        static SetupPtr FindByName(const std::string& setupname);
+
+        /**
+         * @brief Create makes a new instance of the named setup with the given options
+         *
+         * The instance is not shared with the registry, so its calibration modules can be
+         * updated independently of other contexts.
+         * @throws ExceptionNoSetup if no setup was found with that name
+         */
+        static SetupPtr Create(const std::string& setupname, OptionsPtr options);
+
         /**
          * @brief SetByName override current setup to this name, SetByTID won't have any effect then
          * @param setupname the setup's name
@@ -81,7 +136,6 @@ public:
         Setup() = delete; // this class is more a wrapper for handling the setup
 
     private:
-        using SetupPtr = std::shared_ptr<const expconfig::Setup_traits>;
         static std::string manualName;
         static SetupPtr currentSetup;
     };
@@ -152,6 +206,12 @@ public:
         double CBESum_Width = std_ext::NaN;
         std::vector<unsigned> CBESum_MissingElements; // sometimes the analog sum does not include all elements
 
+        // for multiplicity emulation, a sector of consecutive CB elements
+        // counts if its energy sum exceeds the threshold (disabled if NaN)
+        unsigned CB_SectorSize      = 16;
+        double   CB_SectorThreshold = std_ext::NaN; // in MeV
+        unsigned CB_MinMultiplicity = 0;            // for example 2 for M2+ trigger
+
         // may add more fields, for example to specify TAPS multiplicity
     };
 
@@ -176,7 +236,12 @@ public:
 template<typename DetectorType>
 std::shared_ptr<DetectorType> ExpConfig::Setup::GetDetector()
 {
-    auto& setup = Get();
+    return GetDetector<DetectorType>(Get());
+}
+
+template<typename DetectorType>
+std::shared_ptr<DetectorType> ExpConfig::Setup::GetDetector(const expconfig::Setup_traits& setup)
+{
     for(const auto& detector : setup.GetDetectors()) {
         auto detector_ = std::dynamic_pointer_cast<DetectorType, Detector_t>(detector);
         if(detector_ != nullptr)
@@ -191,8 +256,14 @@ const SetupType& ExpConfig::Setup::GetByType()
 {
     if(!currentSetup)
         throw ExceptionNoSetup("No setup specified at all");
+    return GetByType<SetupType>(*currentSetup);
+}
+
+template<typename SetupType>
+const SetupType& ExpConfig::Setup::GetByType(const expconfig::Setup_traits& setup)
+{
     try {
-        return dynamic_cast<const SetupType&>(*currentSetup);
+        return dynamic_cast<const SetupType&>(setup);
     }
     catch(std::bad_cast&) {
         throw ExceptionNoSetup("Requested setup does not implement type");
@@ -201,5 +272,4 @@ const SetupType& ExpConfig::Setup::GetByType()
 }
 
 
-
 } // namespace ant
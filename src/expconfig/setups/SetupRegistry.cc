@@ -18,24 +18,34 @@ SetupRegistry& SetupRegistry::get_instance()
 
 shared_ptr<Setup> SetupRegistry::GetSetup(const string& name)
 {
-    auto& setups = get_instance().setups;
+    auto& instance = get_instance();
+    lock_guard<std::mutex> lock(instance.mutex);
+    auto& setups = instance.setups;
     auto it_setup = setups.lower_bound(name);
     if(it_setup == setups.end() || setups.key_comp()(name, it_setup->first)) {
         // setup not created yet
-        auto& setup_creators = get_instance().setup_creators;
-        auto it_setupcreator = setup_creators.find(name);
-        if(it_setupcreator == setup_creators.end())
+        auto setup = CreateSetup(name, instance.options);
+        if(!setup)
             return nullptr;
-        // found creator
-        auto setup = it_setupcreator->second(name, get_instance().options);
-        if(setup->GetName() != name)
-            throw std::runtime_error(std_ext::formatter()
-                                     << "Setup name " << name << " does not match GetName() " << setup->GetName());
         it_setup = setups.emplace_hint(it_setup, name, setup);
     }
     return it_setup->second;
 }
 
+shared_ptr<Setup> SetupRegistry::CreateSetup(const string& name, OptionsPtr opt)
+{
+    auto& setup_creators = get_instance().setup_creators;
+    auto it_setupcreator = setup_creators.find(name);
+    if(it_setupcreator == setup_creators.end())
+        return nullptr;
+    // found creator
+    auto setup = it_setupcreator->second(name, opt);
+    if(setup->GetName() != name)
+        throw std::runtime_error(std_ext::formatter()
+                                 << "Setup name " << name << " does not match GetName() " << setup->GetName());
+    return setup;
+}
+
 void SetupRegistry::RegisterSetup(Creator creator, string name)
 {
     setup_creators[name] = creator;
@@ -53,7 +63,9 @@ SetupRegistry::~SetupRegistry()
 
 void SetupRegistry::Cleanup()
 {
-    get_instance().setups.clear();
+    auto& instance = get_instance();
+    lock_guard<std::mutex> lock(instance.mutex);
+    instance.setups.clear();
 }
 
 list<string> SetupRegistry::GetNames()
@@ -67,14 +79,18 @@ list<string> SetupRegistry::GetNames()
 
 void SetupRegistry::AddSetup(const string& name, shared_ptr<Setup> setup)
 {
-    get_instance().setups[name] = setup;
+    auto& instance = get_instance();
+    lock_guard<std::mutex> lock(instance.mutex);
+    instance.setups[name] = setup;
 }
 
 void SetupRegistry::SetSetupOptions(OptionsPtr opt)
 {
-    if(!get_instance().setups.empty())
+    auto& instance = get_instance();
+    lock_guard<std::mutex> lock(instance.mutex);
+    if(!instance.setups.empty())
         throw runtime_error("Set SetupOptions before any setups have been created");
-    get_instance().options = opt;
+    instance.options = opt;
 }
 
 SetupRegistration::SetupRegistration(SetupRegistry::Creator creator, string name)
@@ -6,6 +6,7 @@
 #include <list>
 #include <memory>
 #include <functional>
+#include <mutex>
 
 namespace ant {
 namespace expconfig {
@@ -29,6 +30,7 @@ private:
     setup_creators_t setup_creators;
     setups_t setups;
     OptionsPtr options;
+    std::mutex mutex; // setups are created lazily, possibly by several contexts
 
     void RegisterSetup(Creator, std::string);
     static SetupRegistry& get_instance();
@@ -37,6 +39,11 @@ private:
     ~SetupRegistry();
 public:
     static std::shared_ptr<Setup> GetSetup(const std::string& name);
+    /**
+     * @brief CreateSetup makes a new instance, which is not kept by the registry
+     * @return nullptr if no setup with that name is registered
+     */
+    static std::shared_ptr<Setup> CreateSetup(const std::string& name, OptionsPtr opt);
     static std::list<std::string> GetNames();
     static void AddSetup(const std::string& name, std::shared_ptr<Setup> setup);
     static void SetSetupOptions(OptionsPtr opt);
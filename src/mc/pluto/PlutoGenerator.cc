@@ -22,11 +22,13 @@ Cocktail::Cocktail(const string& outfile,
                    bool saveUnstable, bool doBulk,
                    const int verbosity,
                    const string& energyDistribution,
-                   const data::Query::ChannelSelector_t& selector):
+                   const data::Query::ChannelSelector_t& selector,
+                   const unsigned seed):
     _fileOutput(outfile),
     _energies(energies),
     _settings(saveUnstable,doBulk),
-    ChannelSelector(selector)
+    ChannelSelector(selector),
+    _seed(seed)
 {
     sort(_energies.begin(), _energies.end());
     _energyFunction = TF1("beamEnergy",energyDistribution.c_str(),_energies.front(),_energies.back());
@@ -47,8 +49,8 @@ void Cocktail::initLUT()
     // -- Init outputfile and Tree --
     _data = _fileOutput.CreateInside<TTree>("data","Event data");
 
-    // -- Init root - random engine ---
-    _rndEngine = new TRandom3(0);
+    // -- Init root - random engine, seed 0 is random ---
+    _rndEngine = new TRandom3(_seed);
 
     for(double energy : _energies)
     {
@@ -89,6 +89,7 @@ private:
 
     //-- Tools ---
     TRandom3* _rndEngine;
+    const unsigned _seed;
 
     void initLUT();
     PReaction* makeReaction(const double energy,
@@ -108,7 +109,8 @@ public:
              const int verbosity = 0,
              const std::string& energyDistribution = "1.0 / x",
              const data::Query::ChannelSelector_t& selector
-                        = data::Query::GetSelector(data::Query::Selection::gpBeamTarget));
+                        = data::Query::GetSelector(data::Query::Selection::gpBeamTarget),
+             const unsigned seed = 0);
 
     virtual unsigned long Sample(const unsigned long &nevts) const override;
 
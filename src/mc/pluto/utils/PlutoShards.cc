@@ -0,0 +1,132 @@
+#include "PlutoShards.h"
+
+#include "base/Logger.h"
+#include "base/std_ext/string.h"
+
+#include "TFileMerger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+using namespace std;
+using namespace ant;
+using namespace ant::mc::pluto::utils;
+
+// splitmix64, gives well separated outputs even for consecutive inputs
+static uint64_t splitmix64(uint64_t state, uint64_t n) {
+    uint64_t z = state + (n+1)*0x9e3779b97f4a7c15ULL;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+unsigned PlutoShards::GetSeed(uint64_t masterSeed, unsigned shard, unsigned stream)
+{
+    uint64_t z = splitmix64(masterSeed, shard);
+    // further streams are mixed once more, so they are uncorrelated to stream 0
+    if(stream>0)
+        z = splitmix64(z, stream);
+    const unsigned seed = unsigned(z);
+    return seed == 0 ? 1 : seed;
+}
+
+vector<PlutoShards::shard_t> PlutoShards::MakeShards(unsigned nShards, uint64_t masterSeed,
+                                                     unsigned long nEvents, const string& outfile)
+{
+    if(nShards == 0)
+        throw Exception("Need at least one shard");
+
+    string basename(outfile);
+    if(std_ext::string_ends_with(basename, ".root"))
+        basename = basename.substr(0, basename.size()-5);
+
+    vector<shard_t> shards;
+    for(unsigned i=0;i<nShards;i++) {
+        stringstream filename;
+        filename << basename << ".shard" << setw(3) << setfill('0') << i << ".root";
+        shards.push_back({i, GetSeed(masterSeed, i),
+                          nEvents/nShards + (i < nEvents % nShards ? 1 : 0),
+                          filename.str()});
+    }
+    return shards;
+}
+
+void PlutoShards::Run(const vector<shard_t>& shards, const function<void(const shard_t&)>& generate)
+{
+    vector<pid_t> pids;
+    for(const auto& shard : shards) {
+        // avoid duplicate output of buffered streams in the children
+        fflush(nullptr);
+        const pid_t pid = fork();
+        if(pid < 0)
+            throw Exception("Cannot fork worker process");
+        if(pid == 0) {
+            int status = EXIT_SUCCESS;
+            try {
+                generate(shard);
+            }
+            catch(const exception& e) {
+                LOG(ERROR) << "Shard " << shard.Index << " failed: " << e.what();
+                status = EXIT_FAILURE;
+            }
+            fflush(nullptr);
+            // skip atexit handlers of ROOT/Pluto, they belong to the parent
+            _exit(status);
+        }
+        LOG(INFO) << "Started shard " << shard.Index << " with " << shard.nEvents
+                  << " events and seed " << shard.Seed << " (pid " << pid << ")";
+        pids.push_back(pid);
+    }
+
+    unsigned nFailed = 0;
+    for(size_t i=0;i<pids.size();i++) {
+        int status = 0;
+        if(waitpid(pids[i], addressof(status), 0) < 0 ||
+           !WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+            LOG(ERROR) << "Shard " << shards[i].Index << " did not finish successfully";
+            nFailed++;
+        }
+    }
+    if(nFailed>0) {
+        RemoveFiles(shards);
+        throw Exception(std_ext::formatter() << nFailed << " of " << shards.size() << " shards failed");
+    }
+}
+
+void PlutoShards::Merge(const vector<shard_t>& shards, const string& outfile)
+{
+    try {
+        TFileMerger merger(kFALSE, kTRUE); // not local, but fast (no re-compression)
+        merger.SetMsgPrefix("PlutoShards");
+        if(!merger.OutputFile(outfile.c_str(), kTRUE))
+            throw Exception("Cannot open merged output file "+outfile);
+        for(const auto& shard : shards) {
+            if(!merger.AddFile(shard.Filename.c_str(), kFALSE))
+                throw Exception("Cannot add shard file "+shard.Filename);
+        }
+        if(!merger.Merge())
+            throw Exception("Merging shards into "+outfile+" failed");
+    }
+    catch(const Exception&) {
+        // a half-merged outfile is useless, and the shards would be left behind
+        RemoveFiles(shards);
+        remove(outfile.c_str());
+        throw;
+    }
+
+    RemoveFiles(shards);
+
+    LOG(INFO) << "Merged " << shards.size() << " shards into " << outfile;
+}
+
+void PlutoShards::RemoveFiles(const vector<shard_t>& shards)
+{
+    for(const auto& shard : shards)
+        remove(shard.Filename.c_str());
+}
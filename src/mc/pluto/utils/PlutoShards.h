@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ant {
+namespace mc {
+namespace pluto {
+namespace utils
+{
+
+/**
+ * @brief The PlutoShards struct runs Pluto generation in several worker processes
+ *
+ * Pluto and ROOT's gRandom are global state, so each shard is generated in its own
+ * forked process, writing its own file. Every shard gets a seed derived from a master
+ * seed, thus the output is reproducible for the same master seed and number of shards.
+ * The shard files are finally merged into one file, to which the TID tree can be added
+ * as usual, giving consistent TIDs over all shards.
+ */
+struct PlutoShards {
+
+    struct shard_t {
+        unsigned      Index;
+        unsigned      Seed;
+        unsigned long nEvents;
+        std::string   Filename;
+    };
+
+    /**
+     * @brief GetSeed derives the seed of a shard from the master seed
+     * @param stream selects independent seeds for several generators within one shard,
+     * stream 0 is shard_t::Seed
+     * @return never zero, as zero means "random seed" for ROOT's generators
+     */
+    static unsigned GetSeed(std::uint64_t masterSeed, unsigned shard, unsigned stream = 0);
+
+    /**
+     * @brief MakeShards splits nEvents as evenly as possible
+     * @param outfile used to build the shard's filenames
+     */
+    static std::vector<shard_t> MakeShards(unsigned nShards, std::uint64_t masterSeed,
+                                           unsigned long nEvents, const std::string& outfile);
+
+    /**
+     * @brief Run calls generate for each shard in a forked worker process, and waits for all of them
+     * @param generate must write shard_t::nEvents to shard_t::Filename
+     * @throws Exception if any worker fails, the shard files are removed then
+     */
+    static void Run(const std::vector<shard_t>& shards, const std::function<void(const shard_t&)>& generate);
+
+    /**
+     * @brief Merge concatenates the shard files into outfile, and removes the shard files
+     * @throws Exception if merging fails, the shard files and outfile are removed then
+     */
+    static void Merge(const std::vector<shard_t>& shards, const std::string& outfile);
+
+    /**
+     * @brief RemoveFiles deletes the shard files, if they exist
+     */
+    static void RemoveFiles(const std::vector<shard_t>& shards);
+
+    class Exception : public std::runtime_error {
+        using std::runtime_error::runtime_error; // use base class constructor
+    };
+};
+
+}
+}
+}
+}
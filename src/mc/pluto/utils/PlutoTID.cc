@@ -22,7 +22,7 @@ bool CheckExists(WrapTFile& file, const std::string& name) {
     return file.GetObject(name, obj);
 }
 
-void PlutoTID::AddTID(const std::string &filename)
+void PlutoTID::AddTID(const std::string &filename, unsigned seed)
 {
     const auto random_bits = 4;
 
@@ -50,7 +50,7 @@ void PlutoTID::AddTID(const std::string &filename)
         }
 
         TRandom2 rng;
-        rng.SetSeed();
+        rng.SetSeed(seed);
 
         for(decltype(nEvents) i=0; i<nEvents; ++i) {
 
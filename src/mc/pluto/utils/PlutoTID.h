@@ -16,11 +16,12 @@ struct PlutoTID {
     /**
      * @brief Add a TID Tree to a pluto generated ROOT file.
      * @param filename File to edit
+     * @param seed for the random bits of the TID, 0 means random
      *
      * Opens the ROOT file in read/write, looks for a "data" TTree and then adds a TID in a new TTree
      * called "dataTID" for each entry in "data"
      */
-    static void AddTID(const std::string& filename);
+    static void AddTID(const std::string& filename, unsigned seed = 0);
 
     static void CopyTIDPlutoGeant(const std::string& pluto_filename, const std::string& geant_filename);
 };
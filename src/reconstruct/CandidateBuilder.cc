@@ -8,6 +8,9 @@
 #include "base/std_ext/math.h"
 #include "base/std_ext/misc.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace ant;
 using namespace std;
 using namespace ant::reconstruct;
@@ -18,15 +21,180 @@ struct det_type {
     using type = typename T::element_type;
 };
 
+CandidateBuilder::pid_table_t::pid_table_t(const detector::PID& pid, double phi_epsilon) :
+    NBuckets(max(pid.GetNChannels(), 1u)),
+    BucketWidth(2*M_PI/NBuckets)
+{
+    for(unsigned ch=0;ch<pid.GetNChannels();ch++) {
+        DPhiMax.emplace_back(pid.dPhi(ch) + phi_epsilon);
+        // one extra bucket accounts for rounding at the bucket edges
+        BucketSpan.emplace_back(static_cast<unsigned>(ceil(DPhiMax.back()/BucketWidth)) + 1);
+    }
+}
+
+unsigned CandidateBuilder::pid_table_t::GetBucket(double phi) const noexcept
+{
+    const auto bucket = static_cast<int>(floor((phi + M_PI)/BucketWidth));
+    return static_cast<unsigned>(std::min(std::max(bucket, 0), static_cast<int>(NBuckets)-1));
+}
+
+CandidateBuilder::taps_table_t::taps_table_t(const detector::TAPS& taps, double match_distance) :
+    MatchDistance(match_distance)
+{
+    double x_min = std_ext::inf, x_max = -std_ext::inf;
+    double y_min = std_ext::inf, y_max = -std_ext::inf;
+    for(unsigned ch=0;ch<taps.GetNChannels();ch++) {
+        const auto pos = taps.GetPosition(ch);
+        x_min = min(x_min, pos.x);
+        x_max = max(x_max, pos.x);
+        y_min = min(y_min, pos.y);
+        y_max = max(y_max, pos.y);
+    }
+    if(!(x_max >= x_min && y_max >= y_min && match_distance > 0)) {
+        // degenerate, use one big cell
+        NX = NY = 1;
+        return;
+    }
+
+    // make cells slightly larger than the matching distance,
+    // then matching clusters are at most one cell apart
+    const double cellsize = match_distance*(1.0 + 1e-9);
+    InvCellSize = 1.0/cellsize;
+    X0 = x_min;
+    Y0 = y_min;
+    NX = static_cast<unsigned>((x_max - x_min)*InvCellSize) + 1;
+    NY = static_cast<unsigned>((y_max - y_min)*InvCellSize) + 1;
+}
+
+// clamping to the grid keeps neighbouring positions in neighbouring cells
+unsigned CandidateBuilder::taps_table_t::GetCellX(double x) const noexcept
+{
+    const auto cell = static_cast<int>(floor((x - X0)*InvCellSize));
+    return static_cast<unsigned>(std::min(std::max(cell, 0), static_cast<int>(NX)-1));
+}
+
+unsigned CandidateBuilder::taps_table_t::GetCellY(double y) const noexcept
+{
+    const auto cell = static_cast<int>(floor((y - Y0)*InvCellSize));
+    return static_cast<unsigned>(std::min(std::max(cell, 0), static_cast<int>(NY)-1));
+}
+
 CandidateBuilder::CandidateBuilder() :
-    cb(ExpConfig::Setup::GetDetector<det_type<decltype(cb)>::type>()),
-    pid(ExpConfig::Setup::GetDetector<det_type<decltype(pid)>::type>()),
-    taps(ExpConfig::Setup::GetDetector<det_type<decltype(taps)>::type>()),
-    tapsveto(ExpConfig::Setup::GetDetector<det_type<decltype(tapsveto)>::type>()),
-    config(ExpConfig::Setup::Get().GetCandidateBuilderConfig())
+    CandidateBuilder(ExpConfig::Setup::Get())
 {
 }
 
+CandidateBuilder::CandidateBuilder(const expconfig::Setup_traits& setup) :
+    cb(ExpConfig::Setup::GetDetector<det_type<decltype(cb)>::type>(setup)),
+    pid(ExpConfig::Setup::GetDetector<det_type<decltype(pid)>::type>(setup)),
+    taps(ExpConfig::Setup::GetDetector<det_type<decltype(taps)>::type>(setup)),
+    tapsveto(ExpConfig::Setup::GetDetector<det_type<decltype(tapsveto)>::type>(setup)),
+    config(setup.GetCandidateBuilderConfig()),
+    pid_table(*pid, config.PID_Phi_Epsilon),
+    taps_table(*taps, std_ext::sqr(tapsveto->GetElementRadius()))
+{
+}
+
+namespace {
+
+/**
+ * @brief The buckets_t struct sorts item indices into buckets, like a counting sort
+ * @note the items keep their original order within a bucket
+ */
+struct buckets_t {
+    vector<unsigned> Start;
+    vector<unsigned> Items;
+
+    buckets_t(unsigned nBuckets, const vector<int>& bucket_of_item) :
+        Start(nBuckets+1, 0)
+    {
+        for(auto b : bucket_of_item)
+            if(b>=0)
+                Start[b+1]++;
+        for(unsigned b=0;b<nBuckets;b++)
+            Start[b+1] += Start[b];
+        Items.resize(Start.back());
+        auto fill = Start;
+        for(unsigned i=0;i<bucket_of_item.size();i++) {
+            const auto b = bucket_of_item[i];
+            if(b>=0)
+                Items[fill[b]++] = i;
+        }
+    }
+
+    template<typename F>
+    void ForEach(unsigned bucket, F f) const {
+        for(auto i=Start[bucket];i<Start[bucket+1];i++)
+            f(Items[i]);
+    }
+};
+
+template<typename It>
+vector<It> GetIterators(It first, It last) {
+    vector<It> its;
+    for(auto it = first; it != last; ++it)
+        its.emplace_back(it);
+    return its;
+}
+
+/**
+ * @brief match_t collects the result of the veto-calo matching
+ *
+ * Each calo cluster belongs to the first veto cluster (in list order) it matches,
+ * which is the same result as erasing matched calo clusters while looping over the veto clusters.
+ */
+struct match_t {
+    vector<int> CaloOwner;
+    vector<bool> VetoMatched;
+
+    match_t(size_t nVeto, size_t nCalo) :
+        CaloOwner(nCalo, -1),
+        VetoMatched(nVeto, false)
+    {}
+
+    template<typename MakeCandidate>
+    void Apply(TClusterList& veto_clusters, TClusterList& calo_clusters,
+               TClusterList& all_clusters, MakeCandidate make_candidate) const
+    {
+        const auto veto_its = GetIterators(veto_clusters.begin(), veto_clusters.end());
+        const auto calo_its = GetIterators(calo_clusters.begin(), calo_clusters.end());
+
+        // calo cluster indices sorted by owning veto, keeping order within
+        vector<unsigned> matched;
+        for(unsigned j=0;j<calo_its.size();j++)
+            if(CaloOwner[j]>=0)
+                matched.emplace_back(j);
+        stable_sort(matched.begin(), matched.end(), [this] (unsigned a, unsigned b) {
+            return CaloOwner[a] < CaloOwner[b];
+        });
+
+        auto it_matched = matched.begin();
+        for(unsigned i=0;i<veto_its.size();i++) {
+            if(!VetoMatched[i])
+                continue;
+            while(it_matched != matched.end() && CaloOwner[*it_matched] == static_cast<int>(i)) {
+                make_candidate(calo_its[*it_matched], veto_its[i]);
+                all_clusters.push_back(calo_its[*it_matched]);
+                ++it_matched;
+            }
+            all_clusters.push_back(veto_its[i]);
+        }
+
+        // keep only the unmatched clusters
+        TClusterList remaining_veto, remaining_calo;
+        for(unsigned i=0;i<veto_its.size();i++)
+            if(!VetoMatched[i])
+                remaining_veto.push_back(veto_its[i]);
+        for(unsigned j=0;j<calo_its.size();j++)
+            if(CaloOwner[j]<0)
+                remaining_calo.push_back(calo_its[j]);
+        veto_clusters = move(remaining_veto);
+        calo_clusters = move(remaining_calo);
+    }
+};
+
+}
+
 void CandidateBuilder::Build_PID_CB(sorted_clusters_t& sorted_clusters,
                                     candidates_t& candidates, clusters_t& all_clusters) const
 {
@@ -44,54 +212,70 @@ void CandidateBuilder::Build_PID_CB(sorted_clusters_t& sorted_clusters,
     if(pid_clusters.empty())
         return;
 
-    auto it_pid_cluster = pid_clusters.begin();
+    // calculate the phi angle of each cluster only once
+    vector<double> cb_phis;
+    vector<int> cb_buckets;
+    for(const TCluster& cb_cluster : cb_clusters) {
+        const auto cb_phi = cb_cluster.Position.Phi();
+        cb_phis.emplace_back(cb_phi);
+        cb_buckets.emplace_back(isfinite(cb_phi) ? pid_table.GetBucket(cb_phi) : -1);
+    }
+    const buckets_t buckets(pid_table.NBuckets, cb_buckets);
 
-    while(it_pid_cluster != pid_clusters.end()) {
+    match_t match(pid_clusters.size(), cb_clusters.size());
 
-        auto& pid_cluster = *it_pid_cluster;
+    unsigned i = 0;
+    for(const TCluster& pid_cluster : pid_clusters) {
         const auto pid_phi = pid_cluster.Position.Phi();
-        const auto dphi_max = (pid->dPhi(pid_cluster.CentralElement) + config.PID_Phi_Epsilon);
-
-        bool matched = false;
-
-        auto it_cb_cluster = cb_clusters.begin();
-
-        while(it_cb_cluster != cb_clusters.end()) {
-            auto& cb_cluster = *it_cb_cluster;
-            const auto cb_phi = cb_cluster.Position.Phi();
-
+        const auto element = pid_cluster.CentralElement;
+        const auto dphi_max = element < pid_table.DPhiMax.size() ?
+                                  pid_table.DPhiMax[element] :
+                                  pid->dPhi(element) + config.PID_Phi_Epsilon;
+        const unsigned span = element < pid_table.BucketSpan.size() ?
+                                  pid_table.BucketSpan[element] : pid_table.NBuckets;
+
+        auto test_cb_cluster = [&] (unsigned j) {
+            if(match.CaloOwner[j]>=0)
+                return;
             // calculate phi angle difference.
             // Phi_mpi_pi() takes care of wrap-arounds at 180/-180 deg
-            const auto dphi = fabs(vec2::Phi_mpi_pi(cb_phi - pid_phi));
-            if(dphi < dphi_max ) { // match!
-
-                candidates.emplace_back(
-                            Detector_t::Type_t::CB | Detector_t::Type_t::PID,
-                            cb_cluster.Energy,
-                            cb_cluster.Position.Theta(),
-                            cb_cluster.Position.Phi(),
-                            cb_cluster.Time,
-                            cb_cluster.Hits.size(),
-                            pid_cluster.Energy,
-                            numeric_limits<double>::quiet_NaN(), // no tracker information
-                            TClusterList{it_cb_cluster, it_pid_cluster}
-                            );
-                all_clusters.push_back(it_cb_cluster);
-                it_cb_cluster = cb_clusters.erase(it_cb_cluster);
-                matched = true;
+            const auto dphi = fabs(vec2::Phi_mpi_pi(cb_phis[j] - pid_phi));
+            if(dphi < dphi_max) { // match!
+                match.CaloOwner[j] = i;
+                match.VetoMatched[i] = true;
             }
-            else {
-                ++it_cb_cluster;
+        };
+
+        if(isfinite(pid_phi)) {
+            const int nBuckets = pid_table.NBuckets;
+            const int center = pid_table.GetBucket(pid_phi);
+            const int nVisit = min(2*static_cast<int>(span)+1, nBuckets);
+            for(int k=0;k<nVisit;k++) {
+                const int bucket = ((center - static_cast<int>(span) + k) % nBuckets + nBuckets) % nBuckets;
+                buckets.ForEach(bucket, test_cb_cluster);
             }
         }
-
-        if(matched) {
-            all_clusters.push_back(it_pid_cluster);
-            it_pid_cluster = pid_clusters.erase(it_pid_cluster);
-        } else {
-            ++it_pid_cluster;
-        }
+        i++;
     }
+
+    match.Apply(pid_clusters, cb_clusters, all_clusters,
+                [&candidates] (const TClusterList::iterator& it_cb_cluster,
+                               const TClusterList::iterator& it_pid_cluster)
+    {
+        const TCluster& cb_cluster = *it_cb_cluster;
+        const TCluster& pid_cluster = *it_pid_cluster;
+        candidates.emplace_back(
+                    Detector_t::Type_t::CB | Detector_t::Type_t::PID,
+                    cb_cluster.Energy,
+                    cb_cluster.Position.Theta(),
+                    cb_cluster.Position.Phi(),
+                    cb_cluster.Time,
+                    cb_cluster.Hits.size(),
+                    pid_cluster.Energy,
+                    numeric_limits<double>::quiet_NaN(), // no tracker information
+                    TClusterList{it_cb_cluster, it_pid_cluster}
+                    );
+    });
 }
 
 void CandidateBuilder::Build_TAPS_Veto(sorted_clusters_t& sorted_clusters,
@@ -111,53 +295,64 @@ void CandidateBuilder::Build_TAPS_Veto(sorted_clusters_t& sorted_clusters,
     if(veto_clusters.empty())
         return;
 
-    const auto element_radius2 = std_ext::sqr(tapsveto->GetElementRadius());
-
-    auto it_veto_cluster = veto_clusters.begin();
-    while(it_veto_cluster != veto_clusters.end()) {
-
-        auto& veto_cluster = *it_veto_cluster;
+    // sort TAPS clusters into the grid cells
+    vector<int> taps_cells;
+    vector<const TCluster*> taps_ptrs;
+    for(const TCluster& taps_cluster : taps_clusters) {
+        const auto& tpos = taps_cluster.Position;
+        taps_ptrs.emplace_back(addressof(taps_cluster));
+        if(isfinite(tpos.x) && isfinite(tpos.y))
+            taps_cells.emplace_back(taps_table.GetCellX(tpos.x) + taps_table.GetCellY(tpos.y)*taps_table.NX);
+        else
+            taps_cells.emplace_back(-1);
+    }
+    const buckets_t cells(taps_table.NX*taps_table.NY, taps_cells);
 
-        bool matched = false;
+    match_t match(veto_clusters.size(), taps_clusters.size());
 
+    unsigned i = 0;
+    for(const TCluster& veto_cluster : veto_clusters) {
         const auto& vpos = veto_cluster.Position;
 
-        auto it_taps_cluster = taps_clusters.begin();
-
-        while(it_taps_cluster != taps_clusters.end()) {
-
-            auto& taps_cluster = *it_taps_cluster;
-
-            const auto& tpos = taps_cluster.Position;
+        auto test_taps_cluster = [&] (unsigned j) {
+            if(match.CaloOwner[j]>=0)
+                return;
+            const auto& tpos = taps_ptrs[j]->Position;
             const auto& d = tpos - vpos;
-
-            if( d.XY().R() < element_radius2 ) {
-                candidates.emplace_back(
-                            Detector_t::Type_t::TAPS | Detector_t::Type_t::TAPSVeto,
-                            taps_cluster.Energy,
-                            taps_cluster.Position.Theta(),
-                            taps_cluster.Position.Phi(),
-                            taps_cluster.Time,
-                            taps_cluster.Hits.size(),
-                            veto_cluster.Energy,
-                            numeric_limits<double>::quiet_NaN(), // no tracker information
-                            TClusterList{it_taps_cluster, it_veto_cluster}
-                            );
-                all_clusters.push_back(it_taps_cluster);
-                it_taps_cluster = taps_clusters.erase(it_taps_cluster);
-                matched = true;
-            } else {
-                ++it_taps_cluster;
+            if( d.XY().R() < taps_table.MatchDistance ) {
+                match.CaloOwner[j] = i;
+                match.VetoMatched[i] = true;
             }
+        };
+
+        if(isfinite(vpos.x) && isfinite(vpos.y)) {
+            const int cx = taps_table.GetCellX(vpos.x);
+            const int cy = taps_table.GetCellY(vpos.y);
+            for(int y = max(cy-1, 0); y <= min(cy+1, static_cast<int>(taps_table.NY)-1); y++)
+                for(int x = max(cx-1, 0); x <= min(cx+1, static_cast<int>(taps_table.NX)-1); x++)
+                    cells.ForEach(x + y*taps_table.NX, test_taps_cluster);
         }
-
-        if(matched) {
-            all_clusters.push_back(it_veto_cluster);
-            it_veto_cluster = veto_clusters.erase(it_veto_cluster);
-        } else {
-            ++it_veto_cluster;
-        }
+        i++;
     }
+
+    match.Apply(veto_clusters, taps_clusters, all_clusters,
+                [&candidates] (const TClusterList::iterator& it_taps_cluster,
+                               const TClusterList::iterator& it_veto_cluster)
+    {
+        const TCluster& taps_cluster = *it_taps_cluster;
+        const TCluster& veto_cluster = *it_veto_cluster;
+        candidates.emplace_back(
+                    Detector_t::Type_t::TAPS | Detector_t::Type_t::TAPSVeto,
+                    taps_cluster.Energy,
+                    taps_cluster.Position.Theta(),
+                    taps_cluster.Position.Phi(),
+                    taps_cluster.Time,
+                    taps_cluster.Hits.size(),
+                    veto_cluster.Energy,
+                    numeric_limits<double>::quiet_NaN(), // no tracker information
+                    TClusterList{it_taps_cluster, it_veto_cluster}
+                    );
+    });
 }
 
 void CandidateBuilder::Catchall(sorted_clusters_t& sorted_clusters,
@@ -10,6 +10,7 @@
 #include <map>
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace ant {
 
@@ -43,6 +44,43 @@ protected:
 
     const expconfig::Setup_traits::candidatebuilder_config_t config;
 
+    /**
+     * @brief The pid_table_t struct maps PID elements to the CB phi range they can match
+     *
+     * The CB clusters are sorted into phi buckets of one PID element width,
+     * so each PID cluster only needs to look at a few neighbouring buckets.
+     */
+    struct pid_table_t {
+        std::vector<double>   DPhiMax;    // PID element -> max. phi difference to CB cluster
+        std::vector<unsigned> BucketSpan; // PID element -> number of neighbouring buckets to visit
+        unsigned NBuckets = 0;
+        double BucketWidth = 0;
+
+        pid_table_t(const expconfig::detector::PID& pid, double phi_epsilon);
+        unsigned GetBucket(double phi) const noexcept;
+    };
+    const pid_table_t pid_table;
+
+    /**
+     * @brief The taps_table_t struct is a uniform grid in the TAPS x/y plane
+     *
+     * The cell size equals the matching distance, so a TAPSVeto cluster
+     * only needs to look at TAPS clusters in the neighbouring cells.
+     */
+    struct taps_table_t {
+        double MatchDistance = 0;
+        double X0 = 0;
+        double Y0 = 0;
+        double InvCellSize = 0;
+        unsigned NX = 0;
+        unsigned NY = 0;
+
+        taps_table_t(const expconfig::detector::TAPS& taps, double match_distance);
+        unsigned GetCellX(double x) const noexcept;
+        unsigned GetCellY(double y) const noexcept;
+    };
+    const taps_table_t taps_table;
+
     void Build_PID_CB(
             sorted_clusters_t& sorted_clusters,
             candidates_t& candidates, clusters_t& all_clusters
@@ -64,6 +102,7 @@ protected:
 
 public:
     CandidateBuilder();
+    explicit CandidateBuilder(const expconfig::Setup_traits& setup);
 
     // this method shall fill the TEvent reference
     // with tracks built from the given sorted clusters
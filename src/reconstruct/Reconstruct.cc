@@ -11,6 +11,10 @@
 #include "base/std_ext/container.h"
 #include "base/Logger.h"
 
+#include <cxxabi.h>
+#include <cstdlib>
+#include <typeinfo>
+
 #include <algorithm>
 #include <iostream>
 #include <iterator>
@@ -27,12 +31,17 @@ Reconstruct::clustering_t Reconstruct::GetDefaultClustering()
 }
 
 Reconstruct::candidatebuilder_t Reconstruct::GetDefaultCandidateBuilder()
+{
+    return GetDefaultCandidateBuilder(ExpConfig::Setup::Get());
+}
+
+Reconstruct::candidatebuilder_t Reconstruct::GetDefaultCandidateBuilder(const expconfig::Setup_traits& setup)
 {
     /// \todo instead of using the full-blown CandidateBuilder here,
     /// it would be better to compose it out of smaller parts
     /// this might get important if using the MWPCs...
     try {
-        return std_ext::make_unique<CandidateBuilder>();
+        return std_ext::make_unique<CandidateBuilder>(setup);
     }
     catch(ExpConfig::ExceptionNoDetector e) {
         LOG(WARNING) << "Candidate builder could not be activated: " << e.what();
@@ -41,20 +50,49 @@ Reconstruct::candidatebuilder_t Reconstruct::GetDefaultCandidateBuilder()
 }
 
 template<typename List>
-List getSortedHooks() {
+List getSortedHooks(const expconfig::Setup_traits& setup) {
     typename std::remove_const<List>::type hooks;
     using shared_ptr_t = typename List::value_type;
     using element_t = typename shared_ptr_t::element_type;
-    for(const auto& hook : ExpConfig::Setup::Get().GetReconstructHooks()) {
+    for(const auto& hook : setup.GetReconstructHooks()) {
         std_ext::AddToSharedPtrList<element_t>(hook, hooks);
     }
     return hooks;
 }
 
-Reconstruct::sorted_detectors_t Reconstruct::sorted_detectors_t::Build()
+template<typename List>
+std::vector<Instrumentation::stage_t> getHookStages(const List& hooks) {
+    std::vector<Instrumentation::stage_t> stages;
+    for(const auto& hook : hooks) {
+        // use the dynamic type of the hook as name
+        const auto& hook_ref = *hook;
+        const char* mangled = typeid(hook_ref).name();
+        char* demangled = abi::__cxa_demangle(mangled, nullptr, nullptr, nullptr);
+        stages.push_back(Instrumentation::GetStage(
+                             std::string("ReconstructHook/") + (demangled ? demangled : mangled)));
+        std::free(demangled);
+    }
+    return stages;
+}
+
+Reconstruct::instrumentation_t Reconstruct::BuildInstrumentation() const
+{
+    instrumentation_t i;
+    i.ReadHits         = Instrumentation::GetStage("Reconstruct/ReadHits");
+    i.BuildHits        = Instrumentation::GetStage("Reconstruct/BuildHits");
+    i.BuildClusters    = Instrumentation::GetStage("Reconstruct/BuildClusters");
+    i.CandidateBuilder = Instrumentation::GetStage("Reconstruct/CandidateBuilder");
+    i.Hooks_ReadHits    = getHookStages(hooks_readhits);
+    i.Hooks_ClusterHits = getHookStages(hooks_clusterhits);
+    i.Hooks_Clusters    = getHookStages(hooks_clusters);
+    i.Hooks_EventData   = getHookStages(hooks_eventdata);
+    return i;
+}
+
+Reconstruct::sorted_detectors_t Reconstruct::sorted_detectors_t::Build(const expconfig::Setup_traits& setup)
 {
     sorted_detectors_t sorted_detectors;
-    for(const auto& detector : ExpConfig::Setup::Get().GetDetectors()) {
+    for(const auto& detector : setup.GetDetectors()) {
         auto ret = sorted_detectors.insert(make_pair(detector->Type, detector));
         if(!ret.second) {
             throw Exception("Setup provided detector list with two detectors of same type");
@@ -64,16 +102,74 @@ Reconstruct::sorted_detectors_t Reconstruct::sorted_detectors_t::Build()
 }
 
 Reconstruct::Reconstruct(clustering_t clustering_, candidatebuilder_t candidatebuilder_) :
-    includeIgnoredElements(ExpConfig::Setup::Get().GetIncludeIgnoredElements()),
-    sorted_detectors(sorted_detectors_t::Build()),
-    hooks_readhits(getSortedHooks<decltype(hooks_readhits)>()),
-    hooks_clusterhits(getSortedHooks<decltype(hooks_clusterhits)>()),
-    hooks_clusters(getSortedHooks<decltype(hooks_clusters)>()),
-    hooks_eventdata(getSortedHooks<decltype(hooks_eventdata)>()),
+    Reconstruct(ExpConfig::Setup::GetShared(), move(clustering_), move(candidatebuilder_))
+{
+}
+
+// the setup is dereferenced while constructing the members already
+static const Reconstruct::setup_t& checkSetup(const Reconstruct::setup_t& setup) {
+    if(!setup)
+        throw ExpConfig::ExceptionNoSetup("Reconstruct needs a setup, but got nullptr");
+    return setup;
+}
+
+Reconstruct::Reconstruct(setup_t setup_) :
+    Reconstruct(setup_, GetDefaultClustering(), GetDefaultCandidateBuilder(*checkSetup(setup_)))
+{
+}
+
+Reconstruct::Reconstruct(setup_t setup_, clustering_t clustering_, candidatebuilder_t candidatebuilder_) :
+    setup(checkSetup(setup_)),
+    includeIgnoredElements(setup->GetIncludeIgnoredElements()),
+    sorted_detectors(sorted_detectors_t::Build(*setup)),
+    hooks_readhits(getSortedHooks<decltype(hooks_readhits)>(*setup)),
+    hooks_clusterhits(getSortedHooks<decltype(hooks_clusterhits)>(*setup)),
+    hooks_clusters(getSortedHooks<decltype(hooks_clusters)>(*setup)),
+    hooks_eventdata(getSortedHooks<decltype(hooks_eventdata)>(*setup)),
     clustering(move(clustering_)),
     candidatebuilder(move(candidatebuilder_)),
-    updateablemanager(std_ext::make_unique<UpdateableManager>(ExpConfig::Setup::Get().GetUpdateables()))
+    updateablemanager(std_ext::make_unique<UpdateableManager>(setup->GetUpdateables())),
+    instrumentation(BuildInstrumentation())
 {
+    // prepare the dense channel arrays for each detector
+    channelhits.resize(Detector_t::NTypes);
+    for(const auto& it_detector : sorted_detectors) {
+        const auto nChannels = it_detector.second.Detector->GetNChannels();
+        auto& c = channelhits[std_ext::to_integral(it_detector.first)];
+        c.Hits.resize(nChannels);
+        c.Occupied.resize(nChannels, false);
+        c.Touched.reserve(nChannels);
+    }
+}
+
+Reconstruct::Reconstruct(Reconstruct&& other) :
+    Reconstruct(other.setup, move(other.clustering), move(other.candidatebuilder))
+{
+}
+
+TClusterHit& Reconstruct::channelhits_t::Get(unsigned channel)
+{
+    if(channel >= Hits.size()) {
+        Hits.resize(channel+1);
+        Occupied.resize(channel+1, false);
+    }
+    auto& hit = Hits[channel];
+    if(!Occupied[channel]) {
+        Occupied[channel] = true;
+        Touched.push_back(channel);
+        hit.Channel = channel;
+        hit.Energy = std_ext::NaN;
+        hit.Time = std_ext::NaN;
+        hit.Data.clear();
+    }
+    return hit;
+}
+
+void Reconstruct::channelhits_t::Reset()
+{
+    for(auto ch : Touched)
+        Occupied[ch] = false;
+    Touched.clear();
 }
 
 // implement the destructor here,
@@ -100,27 +196,42 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed) const
     // do the hit matching, which builds the TClusterHit's
     // put into the AdaptorTClusterHit to track Energy/Timing information
     // for subsequent clustering
-    sorted_bydetectortype_t<TClusterHit> sorted_clusterhits;
-    BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    {
+        Instrumentation::ScopedTimer t(instrumentation.BuildHits);
+        BuildHits(sorted_clusterhits, reconstructed.TaggerHits);
+    }
 
     // apply hooks which modify clusterhits
-    for(const auto& hook : hooks_clusterhits) {
-        hook->ApplyTo(sorted_clusterhits);
+    {
+        auto it_stage = instrumentation.Hooks_ClusterHits.begin();
+        for(const auto& hook : hooks_clusterhits) {
+            Instrumentation::ScopedTimer t(*it_stage++);
+            hook->ApplyTo(sorted_clusterhits);
+        }
     }
 
     // then build clusters (at least for calorimeters this is not trivial)
     sorted_clusters_t sorted_clusters;
-    BuildClusters(move(sorted_clusterhits), sorted_clusters);
+    {
+        Instrumentation::ScopedTimer t(instrumentation.BuildClusters);
+        BuildClusters(sorted_clusterhits, sorted_clusters);
+    }
 
     // apply hooks which modify clusters
-    for(const auto& hook : hooks_clusters) {
-        hook->ApplyTo(sorted_clusters);
+    {
+        auto it_stage = instrumentation.Hooks_Clusters.begin();
+        for(const auto& hook : hooks_clusters) {
+            Instrumentation::ScopedTimer t(*it_stage++);
+            hook->ApplyTo(sorted_clusters, reconstructed.ID);
+        }
     }
 
     // do the candidate building (if available)
     if(candidatebuilder) {
+        Instrumentation::ScopedTimer t(instrumentation.CandidateBuilder);
         candidatebuilder->Build(move(sorted_clusters),
                                 reconstructed.Candidates, reconstructed.Clusters);
+        Instrumentation::Count(instrumentation.CandidateBuilder, reconstructed.Candidates.size());
     }
     else {
         /// \todo it would be better if a seperate "simple" candidatebuilder was used here
@@ -130,10 +241,15 @@ void Reconstruct::DoReconstruct(TEventData& reconstructed) const
                 reconstructed.Clusters.push_back(it_cluster);
         }
     }
+    Instrumentation::Count(instrumentation.BuildClusters, reconstructed.Clusters.size());
 
     // apply hooks which may modify the whole event
-    for(const auto& hook : hooks_eventdata) {
-        hook->ApplyTo(reconstructed);
+    {
+        auto it_stage = instrumentation.Hooks_EventData.begin();
+        for(const auto& hook : hooks_eventdata) {
+            Instrumentation::ScopedTimer t(*it_stage++);
+            hook->ApplyTo(reconstructed);
+        }
     }
 
 }
@@ -145,13 +261,19 @@ void Reconstruct::ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorRe
     // we need to use non-const references because calibrations
     // may change the content (use std::reference_wrapper to hold it in vector)
     sorted_readhits.clear();
-    for(TDetectorReadHit& readhit : detectorReadHits) {
-        sorted_readhits.add_item(readhit.DetectorType, readhit);
+    {
+        Instrumentation::ScopedTimer t(instrumentation.ReadHits);
+        for(TDetectorReadHit& readhit : detectorReadHits) {
+            sorted_readhits.add_item(readhit.DetectorType, readhit);
+        }
+        Instrumentation::Count(instrumentation.ReadHits, detectorReadHits.size());
     }
 
     // apply calibration
     // this may change the given readhits
+    auto it_stage = instrumentation.Hooks_ReadHits.begin();
     for(const auto& hook : hooks_readhits) {
+        Instrumentation::ScopedTimer t(*it_stage++);
         hook->ApplyTo(sorted_readhits);
     }
 }
@@ -159,7 +281,8 @@ void Reconstruct::ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorRe
 void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_clusterhits,
         vector<TTaggerHit>& taggerhits) const
 {
-    auto insert_hint = sorted_clusterhits.cbegin();
+    // keeps the memory of the hit lists from the previous event
+    sorted_clusterhits.clear();
 
     for(const auto& it_hit : sorted_readhits) {
         const Detector_t::Type_t detectortype = it_hit.first;
@@ -177,7 +300,7 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
             continue;
         }
 
-        map<unsigned, TClusterHit> hits;
+        auto& hits = channelhits[std_ext::to_integral(detectortype)];
 
         for(const TDetectorReadHit& readhit : readhits) {
             if(!includeIgnoredElements && detector.Detector->IsIgnored(readhit.Channel))
@@ -188,12 +311,11 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
                 continue;
 
 
-            auto& clusterhit = hits[readhit.Channel];
+            auto& clusterhit = hits.Get(readhit.Channel);
             // copy over all readhit info to clusterhit
             // For example, CB_TimeWalk needs all timings here!
             for(auto& v : readhit.Values)
                 clusterhit.Data.emplace_back(readhit.ChannelType, v);
-            clusterhit.Channel = readhit.Channel; // copy over the channel
 
             // set the energy or timing field (might stay NaN if not calibrated)
             // for multihit timing
@@ -203,9 +325,19 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
                 clusterhit.Time = readhit.Values.front().Calibrated;
         }
 
-        TClusterHitList clusterhits;
-        for(auto& it_hit : hits) {
-            auto& hit = it_hit.second;
+        // The trigger or tagger detectors don't fill anything
+        // so skip it
+        if(hits.Touched.empty())
+            continue;
+
+        // keep ordering by channel
+        sort(hits.Touched.begin(), hits.Touched.end());
+
+        TClusterHitList& clusterhits = sorted_clusterhits[detectortype];
+        clusterhits.reserve(hits.Touched.size());
+
+        for(auto ch : hits.Touched) {
+            auto& hit = hits.Hits[ch];
 
             // check for weird energies
             if(hit.IsSane() && hit.Energy<0) {
@@ -216,19 +348,10 @@ void Reconstruct::BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_cluster
                         << Detector_t::ToString(detectortype) << " Ch=" << hit.Channel;
                 hit.Energy = std_ext::NaN;
             }
-            clusterhits.emplace_back(move(it_hit.second));
+            clusterhits.emplace_back(move(hit));
         }
 
-
-        // The trigger or tagger detectors don't fill anything
-        // so skip it
-        if(clusterhits.empty())
-            continue;
-
-        // insert the clusterhits
-        insert_hint =
-                sorted_clusterhits.insert(insert_hint,
-                                          make_pair(detectortype, move(clusterhits)));
+        hits.Reset();
     }
 }
 
@@ -262,6 +385,9 @@ void Reconstruct::HandleTagger(const shared_ptr<TaggerDetector_t>& taggerdetecto
         }
     }
 
+    // avoid virtual calls per hit
+    const auto& photonEnergies = taggerdetector->GetChannelTable().PhotonEnergies;
+
     for(const auto& hit : hits) {
         const auto channel = hit.first;
         const auto& item = hit.second;
@@ -271,7 +397,7 @@ void Reconstruct::HandleTagger(const shared_ptr<TaggerDetector_t>& taggerdetecto
         const auto qdc_energy = item.Energies.empty() ? std_ext::NaN : item.Energies.front().Calibrated;
         for(const auto& timing : item.Timings) {
             taggerhits.emplace_back(channel,
-                                    taggerdetector->GetPhotonEnergy(channel),
+                                    photonEnergies[channel],
                                     timing.Calibrated,
                                     qdc_energy
                                     );
@@ -283,8 +409,6 @@ void Reconstruct::BuildClusters(
         const sorted_clusterhits_t& sorted_clusterhits,
         sorted_clusters_t& sorted_clusters) const
 {
-    auto insert_hint = sorted_clusters.begin();
-
     for(const auto& it_clusterhits : sorted_clusterhits) {
         const Detector_t::Type_t detectortype = it_clusterhits.first;
         const TClusterHitList& clusterhits = it_clusterhits.second;
@@ -327,11 +451,8 @@ void Reconstruct::BuildClusters(
         }
 
         // insert the clusters (if any)
-        if(!clusters.empty()) {
-            insert_hint =
-                    sorted_clusters.insert(insert_hint,
-                                           make_pair(detectortype, move(clusters)));
-        }
+        if(!clusters.empty())
+            sorted_clusters.insert(make_pair(detectortype, move(clusters)));
     }
 }
 
@@ -2,8 +2,11 @@
 
 #include <memory>
 #include <list>
+#include <vector>
 
 #include "Reconstruct_traits.h"
+#include "expconfig/ExpConfig.h"
+#include "base/Instrumentation.h"
 
 namespace ant {
 
@@ -18,13 +21,25 @@ public:
 
     using clustering_t       = std::unique_ptr<const reconstruct::Clustering_traits>;
     using candidatebuilder_t = std::unique_ptr<const reconstruct::CandidateBuilder_traits>;
+    using setup_t            = ExpConfig::Setup::SetupPtr;
 
     static clustering_t       GetDefaultClustering();
     static candidatebuilder_t GetDefaultCandidateBuilder();
+    static candidatebuilder_t GetDefaultCandidateBuilder(const expconfig::Setup_traits& setup);
 
+    /**
+     * @brief Reconstruct with the currently set setup, see ExpConfig::Setup::Get()
+     */
     Reconstruct(clustering_t clustering_ = GetDefaultClustering(),
                 candidatebuilder_t candidatebuilder_ = GetDefaultCandidateBuilder());
 
+    /**
+     * @brief Reconstruct with the given setup, independent of the currently set one
+     * @throws ExpConfig::ExceptionNoSetup if setup_ is nullptr
+     */
+    explicit Reconstruct(setup_t setup_);
+    Reconstruct(setup_t setup_, clustering_t clustering_, candidatebuilder_t candidatebuilder_);
+
     // this method converts a TDetectorRead
     // into a calibrated TEvent
     virtual void DoReconstruct(TEventData& reconstructed) const override;
@@ -37,16 +52,43 @@ public:
 
 protected:
 
+    /**
+     * @brief Reconstruct takes over the setup, clustering and candidate builder of other
+     * @note other must not be used afterwards, see reconstruct::ReconstructReplay
+     */
+    Reconstruct(Reconstruct&& other);
+
+    const setup_t setup;
+
     const bool includeIgnoredElements = false;
 
     // sorted_readhits is mutable in order to
     using sorted_readhits_t = ReconstructHook::Base::readhits_t;
     mutable sorted_readhits_t sorted_readhits;
 
-    void ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorReadHits) const;
+    virtual void ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorReadHits) const;
 
     template<typename T>
-    using sorted_bydetectortype_t = std::map<Detector_t::Type_t, std::vector< T > >;
+    using sorted_bydetectortype_t = bydetectortype_t< std::vector< T > >;
+
+    // sorted_clusterhits is mutable in order to re-use its memory
+    mutable sorted_bydetectortype_t<TClusterHit> sorted_clusterhits;
+
+    /**
+     * @brief The channelhits_t struct gathers the hits of one detector by channel
+     *
+     * The hits are stored densely indexed by the channel. Only the touched
+     * channels are reset for the next event, and the memory is kept.
+     */
+    struct channelhits_t {
+        std::vector<TClusterHit> Hits;
+        std::vector<bool> Occupied;
+        std::vector<unsigned> Touched;
+
+        TClusterHit& Get(unsigned channel);
+        void Reset();
+    };
+    mutable std::vector<channelhits_t> channelhits;
 
     void BuildHits(sorted_bydetectortype_t<TClusterHit>& sorted_clusterhits,
             std::vector<TTaggerHit>& taggerhits
@@ -86,7 +128,7 @@ protected:
             return std::map<Detector_t::Type_t,  std::shared_ptr<Detector_t> >(begin(), end());
         }
         // helper method for construction
-        static sorted_detectors_t Build();
+        static sorted_detectors_t Build(const expconfig::Setup_traits& setup);
     };
     const sorted_detectors_t sorted_detectors;
 
@@ -98,9 +140,25 @@ protected:
     const shared_ptr_list<ReconstructHook::Clusters>         hooks_clusters;
     const shared_ptr_list<ReconstructHook::EventData>        hooks_eventdata;
 
-    const clustering_t       clustering;
-    const candidatebuilder_t candidatebuilder;
+    // not const to be movable, see Reconstruct(Reconstruct&&)
+    clustering_t       clustering;
+    candidatebuilder_t candidatebuilder;
     const std::unique_ptr<reconstruct::UpdateableManager> updateablemanager;
+
+    // instrumentation stages, one for each hook in order of the lists above
+    using stages_t = std::vector<Instrumentation::stage_t>;
+    struct instrumentation_t {
+        Instrumentation::stage_t ReadHits;
+        Instrumentation::stage_t BuildHits;
+        Instrumentation::stage_t BuildClusters;
+        Instrumentation::stage_t CandidateBuilder;
+        stages_t Hooks_ReadHits;
+        stages_t Hooks_ClusterHits;
+        stages_t Hooks_Clusters;
+        stages_t Hooks_EventData;
+    };
+    const instrumentation_t instrumentation;
+    instrumentation_t BuildInstrumentation() const;
 };
 
 }
@@ -0,0 +1,112 @@
+#include "ReconstructReplay.h"
+
+#include "tree/TDetectorReadHit.h"
+
+#include "base/Logger.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::reconstruct;
+
+ReconstructReplay::ReconstructReplay(changed_t isChanged,
+                                     clustering_t clustering_,
+                                     candidatebuilder_t candidatebuilder_) :
+    Reconstruct(move(clustering_), move(candidatebuilder_)),
+    dirty(Detector_t::NTypes*Channel_t::NTypes, false)
+{
+    Init(isChanged);
+}
+
+ReconstructReplay::ReconstructReplay(changed_t isChanged, Reconstruct&& reconstruct) :
+    Reconstruct(move(reconstruct)),
+    dirty(Detector_t::NTypes*Channel_t::NTypes, false)
+{
+    Init(isChanged);
+}
+
+void ReconstructReplay::Init(const changed_t& isChanged)
+{
+    auto modifies = [this] (const ReconstructHook::DetectorReadHits& hook, bool only_dirty) {
+        for(unsigned d=0;d<Detector_t::NTypes;d++) {
+            for(unsigned c=0;c<Channel_t::NTypes;c++) {
+                const auto detectorType = static_cast<Detector_t::Type_t>(d);
+                const auto channelType = static_cast<Channel_t::Type_t>(c);
+                if(only_dirty && !IsDirty(detectorType, channelType))
+                    continue;
+                if(hook.Modifies(detectorType, channelType))
+                    return true;
+            }
+        }
+        return false;
+    };
+
+    // the changed hooks make their types dirty
+    for(const auto& hook : hooks_readhits) {
+        if(!isChanged(*hook))
+            continue;
+        for(unsigned d=0;d<Detector_t::NTypes;d++) {
+            for(unsigned c=0;c<Channel_t::NTypes;c++) {
+                const auto detectorType = static_cast<Detector_t::Type_t>(d);
+                const auto channelType = static_cast<Channel_t::Type_t>(c);
+                if(hook->Modifies(detectorType, channelType))
+                    dirty[index(detectorType, channelType)] = true;
+            }
+        }
+    }
+
+    // then any hook modifying dirty types needs to run again,
+    // read-only hooks provide information to others and run if anything is dirty
+    const bool anyDirty = IsAnyDirty();
+    for(const auto& hook : hooks_readhits) {
+        if(modifies(*hook, true))
+            rerun.push_back(rerun_t::Modifying);
+        else if(anyDirty && !modifies(*hook, false))
+            rerun.push_back(rerun_t::ReadOnly);
+        else
+            rerun.push_back(rerun_t::No);
+    }
+
+    VLOG(5) << "Replaying " << GetNRerunHooks() << " of " << hooks_readhits.size() << " read hit hooks";
+}
+
+ReconstructReplay::~ReconstructReplay() = default;
+
+bool ReconstructReplay::IsAnyDirty() const
+{
+    return find(dirty.begin(), dirty.end(), true) != dirty.end();
+}
+
+unsigned ReconstructReplay::GetNRerunHooks() const
+{
+    return rerun.size() - count(rerun.begin(), rerun.end(), rerun_t::No);
+}
+
+void ReconstructReplay::ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorReadHits) const
+{
+    // same sorting as in Reconstruct, but additionally
+    // build the list of dirty hits
+    sorted_readhits.clear();
+    sorted_dirtyhits.clear();
+    {
+        Instrumentation::ScopedTimer t(instrumentation.ReadHits);
+        for(TDetectorReadHit& readhit : detectorReadHits) {
+            sorted_readhits.add_item(readhit.DetectorType, readhit);
+            if(IsDirty(readhit.DetectorType, readhit.ChannelType))
+                sorted_dirtyhits.add_item(readhit.DetectorType, readhit);
+        }
+        Instrumentation::Count(instrumentation.ReadHits, detectorReadHits.size());
+    }
+
+    auto it_rerun = rerun.begin();
+    auto it_stage = instrumentation.Hooks_ReadHits.begin();
+    for(const auto& hook : hooks_readhits) {
+        Instrumentation::ScopedTimer t(*it_stage++);
+        const auto r = *it_rerun++;
+        if(r == rerun_t::Modifying)
+            hook->ApplyTo(sorted_dirtyhits);
+        else if(r == rerun_t::ReadOnly)
+            hook->ApplyTo(sorted_readhits);
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Reconstruct.h"
+
+#include <functional>
+
+namespace ant {
+namespace reconstruct {
+
+/**
+ * @brief The ReconstructReplay class reconstructs events whose read hits were already calibrated before
+ *
+ * Only the DetectorReadHits hooks which are reported as changed are applied again,
+ * together with all hooks modifying the same detector/channel types (as they may
+ * depend on each other's order) and the read-only hooks (such as reference time converters).
+ * The modifying hooks only see the read hits of the affected ("dirty") types.
+ *
+ * The provider of the events must restore the read hits of the dirty types to
+ * their state before calibration, and may keep the calibrated values for all others,
+ * see IsDirty(). All later reconstruction stages run as usual.
+ */
+class ReconstructReplay : public Reconstruct {
+public:
+    using changed_t = std::function<bool(const ReconstructHook::DetectorReadHits&)>;
+
+    ReconstructReplay(changed_t isChanged,
+                      clustering_t clustering_ = GetDefaultClustering(),
+                      candidatebuilder_t candidatebuilder_ = GetDefaultCandidateBuilder());
+
+    /**
+     * @brief ReconstructReplay replaces the given reconstruct, keeping its setup, clustering and candidate builder
+     */
+    ReconstructReplay(changed_t isChanged, Reconstruct&& reconstruct);
+    virtual ~ReconstructReplay();
+
+    bool IsDirty(Detector_t::Type_t detectorType, Channel_t::Type_t channelType) const {
+        return dirty[index(detectorType, channelType)];
+    }
+
+    bool IsAnyDirty() const;
+
+    /**
+     * @brief GetNRerunHooks
+     * @return number of DetectorReadHits hooks which are applied again
+     */
+    unsigned GetNRerunHooks() const;
+
+protected:
+    void Init(const changed_t& isChanged);
+
+    virtual void ApplyHooksToReadHits(std::vector<TDetectorReadHit>& detectorReadHits) const override;
+
+    static unsigned index(Detector_t::Type_t detectorType, Channel_t::Type_t channelType) {
+        return std_ext::to_integral(detectorType)*Channel_t::NTypes + std_ext::to_integral(channelType);
+    }
+
+    enum class rerun_t { No, ReadOnly, Modifying };
+
+    std::vector<bool>    dirty;
+    std::vector<rerun_t> rerun; // same order as hooks_readhits
+
+    mutable sorted_readhits_t sorted_dirtyhits;
+};
+
+}} // namespace ant::reconstruct
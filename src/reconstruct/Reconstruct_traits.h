@@ -2,6 +2,7 @@
 
 #include "base/Detector_t.h"
 #include "base/std_ext/mapped_vectors.h"
+#include "base/std_ext/array_map.h"
 #include "base/std_ext/shared_ptr_container.h"
 
 #include <memory>
@@ -46,14 +47,20 @@ struct Reconstruct_traits {
  * find their reference timings.
  *
  */
+/**
+ * @brief bydetectortype_t is a map-like fixed array indexed by the detector type
+ */
+template<typename T>
+using bydetectortype_t = std_ext::array_map<Detector_t::Type_t, T, Detector_t::NTypes>;
+
 struct ReconstructHook {
     /**
      * @brief The Base struct just defines some useful types
      */
     struct Base {
         using readhits_t = std_ext::mapped_vectors< Detector_t::Type_t, std::reference_wrapper<TDetectorReadHit> >;
-        using clusterhits_t = std::map< Detector_t::Type_t, TClusterHitList >;
-        using clusters_t = std::map< Detector_t::Type_t, TClusterList >;
+        using clusterhits_t = bydetectortype_t< TClusterHitList >;
+        using clusters_t = bydetectortype_t< TClusterList >;
         virtual ~Base() = default;
     };
 
@@ -62,6 +69,13 @@ struct ReconstructHook {
      */
     struct DetectorReadHits : virtual Base {
         virtual void ApplyTo(const readhits_t& hits) = 0;
+
+        /**
+         * @brief Modifies tells if the hook may change read hits of given type
+         * @return true by default, which is always safe
+         * @note used to replay only parts of the calibration, see reconstruct::ReconstructReplay
+         */
+        virtual bool Modifies(Detector_t::Type_t, Channel_t::Type_t) const { return true; }
     };
 
     /**
@@ -73,9 +87,10 @@ struct ReconstructHook {
 
     /**
      * @brief The Clusters struct instances are applied before candidate matching and after clustering
+     * @note the event's id can be used to seed random numbers reproducibly per event
      */
     struct Clusters : virtual Base {
-        virtual void ApplyTo(clusters_t& clusters) = 0;
+        virtual void ApplyTo(clusters_t& clusters, const TID& id) = 0;
     };
 
     /**
@@ -117,7 +132,7 @@ struct Clustering_traits {
 };
 
 struct CandidateBuilder_traits {
-    using sorted_clusters_t = std::map<Detector_t::Type_t, TClusterList >;
+    using sorted_clusters_t = bydetectortype_t< TClusterList >;
     using candidates_t = TCandidateList;
     using clusters_t = TClusterList;
 
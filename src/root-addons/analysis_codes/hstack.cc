@@ -31,8 +31,10 @@ hstack::hstack(const string& name, const std::string& title, bool simple_) :
     simple(simple_)
 {
     // simulate behaviour of TH1
-    if(!simple)
+    if(!simple) {
         gDirectory->Append(this);
+        dirpath = GetDirPath(gDirectory);
+    }
 
     // figure out cutnames now, as later we have
     // no idea where gDirectory points to (in TBrowser)
@@ -63,9 +65,12 @@ TH1* hstack::hist_t::GetPtr(const string& path)
 
 string hstack::hist_t::GetPath(const TH1* ptr)
 {
-    const std::string path = std_ext::formatter()
-                             << ptr->GetDirectory()->GetPath()
-                             << "/" << ptr->GetName();
+    return std_ext::formatter() << GetDirPath(ptr->GetDirectory()) << "/" << ptr->GetName();
+}
+
+string hstack::GetDirPath(const TDirectory* dir)
+{
+    const std::string path = dir->GetPath();
     // strip the file of the full path
     const auto n = path.find_first_of(':');
     if(n == path.npos)
@@ -522,6 +527,9 @@ Long64_t hstack::Merge(TCollection* li, TFileMergeInfo*)
         return 0;
     TIter next(li);
 
+    // the current directory is the one merged into
+    const auto mergepath = GetDirPath(gDirectory);
+
     while(auto h = dynamic_cast<hstack*>(next())) {
         if(!IsCompatible(*h)) {
             LOG(ERROR) << "Skipping incompatible hstack:\n "
@@ -529,6 +537,15 @@ Long64_t hstack::Merge(TCollection* li, TFileMergeInfo*)
                        << *h;
             continue;
         }
+        // a default constructed stack becomes a copy of the first one merged
+        if(hists.empty() && origtitle.empty()) {
+            origtitle = h->origtitle;
+            cutnames = h->cutnames;
+            simple = h->simple;
+        }
+        // stacks created in another directory refer to histograms there,
+        // which are expected to be merged to the same relative path
+        const bool relocate = !h->dirpath.empty() && h->dirpath != mergepath;
         // we add non-existing paths
         auto have_path = [] (const hists_t& hists, const string& path) {
             for(const auto& hist : hists)
@@ -536,7 +553,12 @@ Long64_t hstack::Merge(TCollection* li, TFileMergeInfo*)
                     return true;
             return false;
         };
-        for(const auto& hist : h->hists) {
+        for(auto hist : h->hists) {
+            if(relocate) {
+                if(std_ext::string_starts_with(hist.Path, h->dirpath))
+                    hist.Path = mergepath + hist.Path.substr(h->dirpath.size());
+                hist.Ptr = hist_t::GetPtr(hist.Path);
+            }
             if(!have_path(hists, hist.Path))
                 hists.emplace_back(hist);
         }
@@ -19,6 +19,7 @@
 #endif
 
 class TH1;
+class TDirectory;
 class TLegend;
 class TPaveText;
 
@@ -143,6 +144,8 @@ protected:
         static std::string GetPath(const TH1* ptr);
     };
 
+    static std::string GetDirPath(const TDirectory* dir);
+
     using hists_t = std::vector<hist_t>;
     hists_t hists;
 
@@ -158,6 +161,7 @@ protected:
     std::list<std::string> cutnames;
     std::string origtitle;
     bool simple;
+    std::string dirpath; // where the stack was created, empty if read from file
 
     std::unique_ptr<TLegend>   intellilegend;
     std::unique_ptr<TPaveText> intellititle;
@@ -195,7 +199,7 @@ public:
     virtual void UseYAxisEntriesPerBin(bool flag); // *TOGGLE* *GETTER=GetUseYAxisEntriesPerBin
     virtual bool GetUseYAxisEntriesPerBin() const;
 
-    // to be used with Ant-hadd
+    // to be used with Ant-hadd, or to merge in-memory stacks located in another directory
     virtual Long64_t Merge(TCollection* li, TFileMergeInfo *info) override;
 
     hstack();
@@ -0,0 +1,99 @@
+#include "MemoryArchive.h"
+
+#include "TBuffer.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+
+MemoryOutputArchive::MemoryOutputArchive(string& target) :
+    OutputArchive<MemoryOutputArchive, cereal::AllowEmptyClassElision>(this),
+    targetString(addressof(target))
+{
+    // the string's size serves as capacity while writing
+    begin = &target[0];
+    cur = begin + target.size();
+    end = cur;
+}
+
+MemoryOutputArchive::MemoryOutputArchive(TBuffer& target, size_t sizeHint) :
+    OutputArchive<MemoryOutputArchive, cereal::AllowEmptyClassElision>(this),
+    targetTBuffer(addressof(target))
+{
+    begin = targetTBuffer->Buffer();
+    cur = begin + targetTBuffer->Length();
+    end = begin + targetTBuffer->BufferSize();
+    if(sizeHint > size_t(end - cur))
+        Grow(sizeHint);
+}
+
+MemoryOutputArchive::MemoryOutputArchive(MemoryOutputArchive& parent_) :
+    OutputArchive<MemoryOutputArchive, cereal::AllowEmptyClassElision>(this),
+    targetString(parent_.targetString),
+    targetTBuffer(parent_.targetTBuffer),
+    parent(addressof(parent_)),
+    begin(parent_.begin),
+    cur(parent_.cur),
+    end(parent_.end)
+{}
+
+MemoryOutputArchive::~MemoryOutputArchive() noexcept
+{
+    if(parent) {
+        // the target might have moved while growing
+        parent->begin = begin;
+        parent->cur = cur;
+        parent->end = end;
+    }
+    else if(targetString) {
+        targetString->resize(cur - begin);
+    }
+    else {
+        targetTBuffer->SetBufferOffset(cur - begin);
+    }
+}
+
+void MemoryOutputArchive::Grow(size_t size)
+{
+    const size_t used = cur - begin;
+    if(targetString) {
+        targetString->resize(max(max(2*targetString->size(), used + size), size_t(256)));
+        begin = &(*targetString)[0];
+        end = begin + targetString->size();
+    }
+    else {
+        targetTBuffer->SetBufferOffset(used);
+        targetTBuffer->AutoExpand(used + size);
+        begin = targetTBuffer->Buffer();
+        end = begin + targetTBuffer->BufferSize();
+    }
+    cur = begin + used;
+}
+
+MemoryInputArchive::MemoryInputArchive(const char* begin_, const char* end_) :
+    InputArchive<MemoryInputArchive, cereal::AllowEmptyClassElision>(this),
+    begin(begin_),
+    cur(begin_),
+    end(end_)
+{}
+
+MemoryInputArchive::MemoryInputArchive(TBuffer& source) :
+    InputArchive<MemoryInputArchive, cereal::AllowEmptyClassElision>(this),
+    tbuffer(addressof(source)),
+    begin(source.Buffer()),
+    cur(begin + source.Length()),
+    end(begin + source.BufferSize())
+{}
+
+MemoryInputArchive::~MemoryInputArchive() noexcept
+{
+    if(tbuffer)
+        tbuffer->SetBufferOffset(cur - begin);
+}
+
+void MemoryInputArchive::ThrowEndOfData(size_t size) const
+{
+    throw cereal::Exception("Failed to read " + to_string(size) + " bytes from memory, only "
+                            + to_string(end - cur) + " left");
+}
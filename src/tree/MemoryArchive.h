@@ -0,0 +1,184 @@
+#pragma once
+
+// ignore warnings from library
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-virtual-dtor"
+#include "cereal/cereal.hpp"
+#include "cereal/types/polymorphic.hpp"
+#include "cereal/types/vector.hpp"
+#pragma GCC diagnostic pop
+
+#include "TDetectorReadHit.h"
+
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+class TBuffer;
+
+namespace ant {
+
+/**
+ * @brief The MemoryOutputArchive class is a cereal binary archive writing directly to memory
+ *
+ * The output is byte-compatible with cereal::BinaryOutputArchive, but each field
+ * is just copied instead of going through a std::streambuf. The target is either a std::string,
+ * which is appended to, or a TBuffer, which is written at its current position.
+ * The target grows as needed and is finalized when the archive is destroyed.
+ */
+class MemoryOutputArchive : public cereal::OutputArchive<MemoryOutputArchive, cereal::AllowEmptyClassElision>
+{
+public:
+    explicit MemoryOutputArchive(std::string& target);
+    /// @param sizeHint bytes reserved up front
+    MemoryOutputArchive(TBuffer& target, std::size_t sizeHint = 0);
+    /// continues at the position of parent, but with its own shared pointer bookkeeping
+    explicit MemoryOutputArchive(MemoryOutputArchive& parent);
+    ~MemoryOutputArchive() noexcept;
+
+    void saveBinary(const void* data, std::size_t size) {
+        if(size > std::size_t(end - cur))
+            Grow(size);
+        std::memcpy(cur, data, size);
+        cur += size;
+    }
+
+    /// @return offset of the next written byte in the target
+    std::size_t Position() const { return cur - begin; }
+
+    /// overwrite bytes already written at the given position, such as a size prefix
+    void Overwrite(std::size_t position, const void* data, std::size_t size) {
+        std::memcpy(begin + position, data, size);
+    }
+
+private:
+    std::string* targetString = nullptr;
+    TBuffer* targetTBuffer = nullptr;
+    MemoryOutputArchive* parent = nullptr;
+    char* begin;
+    char* cur;
+    char* end;
+
+    void Grow(std::size_t size);
+};
+
+/**
+ * @brief The MemoryInputArchive class reads cereal binary archives directly from memory
+ */
+class MemoryInputArchive : public cereal::InputArchive<MemoryInputArchive, cereal::AllowEmptyClassElision>
+{
+public:
+    MemoryInputArchive(const char* begin_, const char* end_);
+    /// reads from the current position of source, which is advanced when the archive is destroyed
+    explicit MemoryInputArchive(TBuffer& source);
+    ~MemoryInputArchive() noexcept;
+
+    void loadBinary(void* data, std::size_t size) {
+        std::memcpy(data, Skip(size), size);
+    }
+
+    /// @return pointer to the next size bytes, which are skipped
+    const char* Skip(std::size_t size) {
+        if(size > std::size_t(end - cur))
+            ThrowEndOfData(size);
+        const char* data = cur;
+        cur += size;
+        return data;
+    }
+
+private:
+    TBuffer* tbuffer = nullptr;
+    const char* begin;
+    const char* cur;
+    const char* end;
+
+    [[noreturn]] void ThrowEndOfData(std::size_t size) const;
+};
+
+/**
+ * @brief is_packed marks types whose memory layout equals their binary serialization,
+ * vectors of them are copied in one go by the memory archives
+ */
+template<typename T>
+struct is_packed : std::false_type {};
+
+template<>
+struct is_packed<TDetectorReadHit::Value_t> : std::true_type {
+    static_assert(sizeof(TDetectorReadHit::Value_t) == 2*sizeof(double), "Value_t has padding");
+};
+
+} // namespace ant
+
+namespace cereal {
+
+// the same serialization functions as for the BinaryArchive
+
+template<class T> inline
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+CEREAL_SAVE_FUNCTION_NAME(ant::MemoryOutputArchive& ar, T const& t)
+{
+    ar.saveBinary(std::addressof(t), sizeof(t));
+}
+
+template<class T> inline
+typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+CEREAL_LOAD_FUNCTION_NAME(ant::MemoryInputArchive& ar, T& t)
+{
+    ar.loadBinary(std::addressof(t), sizeof(t));
+}
+
+template <class Archive, class T> inline
+CEREAL_ARCHIVE_RESTRICT(ant::MemoryInputArchive, ant::MemoryOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, NameValuePair<T>& t)
+{
+    ar(t.value);
+}
+
+template <class Archive, class T> inline
+CEREAL_ARCHIVE_RESTRICT(ant::MemoryInputArchive, ant::MemoryOutputArchive)
+CEREAL_SERIALIZE_FUNCTION_NAME(Archive& ar, SizeTag<T>& t)
+{
+    ar(t.size);
+}
+
+template <class T> inline
+void CEREAL_SAVE_FUNCTION_NAME(ant::MemoryOutputArchive& ar, BinaryData<T> const& bd)
+{
+    ar.saveBinary(bd.data, static_cast<std::size_t>(bd.size));
+}
+
+template <class T> inline
+void CEREAL_LOAD_FUNCTION_NAME(ant::MemoryInputArchive& ar, BinaryData<T>& bd)
+{
+    ar.loadBinary(bd.data, static_cast<std::size_t>(bd.size));
+}
+
+// vectors of packed types in one go, giving the same bytes as element-wise
+
+template<class T> inline
+typename std::enable_if<ant::is_packed<T>::value, void>::type
+CEREAL_SAVE_FUNCTION_NAME(ant::MemoryOutputArchive& ar, std::vector<T> const& vector)
+{
+    ar(make_size_tag(static_cast<size_type>(vector.size())));
+    ar.saveBinary(vector.data(), vector.size()*sizeof(T));
+}
+
+template<class T> inline
+typename std::enable_if<ant::is_packed<T>::value, void>::type
+CEREAL_LOAD_FUNCTION_NAME(ant::MemoryInputArchive& ar, std::vector<T>& vector)
+{
+    size_type size;
+    ar(make_size_tag(size));
+    vector.resize(static_cast<std::size_t>(size));
+    ar.loadBinary(vector.data(), vector.size()*sizeof(T));
+}
+
+} // namespace cereal
+
+// register archives for polymorphic support
+CEREAL_REGISTER_ARCHIVE(ant::MemoryOutputArchive)
+CEREAL_REGISTER_ARCHIVE(ant::MemoryInputArchive)
+
+// tie input and output archives together
+CEREAL_SETUP_ARCHIVE_TRAITS(ant::MemoryInputArchive, ant::MemoryOutputArchive)
@@ -3,27 +3,42 @@
 #include "stream_TBuffer.h"
 
 #include "base/std_ext/memory.h"
+#include "base/std_ext/string.h"
 #include "base/Logger.h"
 
 #include "TClass.h"
 
-#include <streambuf>
-
 using namespace std;
 using namespace ant;
 
 // use some versioning
 CEREAL_CLASS_VERSION(TEvent, ANT_TEVENT_VERSION)
 
-// tell cereal to use the correct TParticle load/save due to inheritance from LorentzVec
-
-namespace cereal
+void TEvent::load(MemoryInputArchive& archive, const uint32_t version)
 {
-  template <class Archive>
-  struct specialize<Archive, TParticle, cereal::specialization::member_load_save> {};
+    if(version == ANT_TEVENT_VERSION) {
+        archive(reconstructed, mctrue, SavedForSlowControls);
+        return;
+    }
+    if(version != 5)
+        throw std::runtime_error(std_ext::formatter() << "TEvent version " << version << " not supported");
+
+    // same layout as cereal uses for std::unique_ptr
+    for(auto ptr : {addressof(reconstructed), addressof(mctrue)}) {
+        uint8_t valid;
+        archive(valid);
+        if(valid) {
+            *ptr = std_ext::make_unique<TEventData>();
+            (*ptr)->load_v5(archive);
+        }
+        else {
+            ptr->reset();
+        }
+    }
+    archive(SavedForSlowControls);
 }
 
-// create some TBuffer to std::streambuf interface
+// serialize with cereal directly into the TBuffer
 void TEvent::Streamer(TBuffer& R__b)
 {
     stream_TBuffer::DoBinary(R__b, *this);
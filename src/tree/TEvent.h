@@ -7,13 +7,14 @@
 #include <stdexcept>
 #endif
 
-#define ANT_TEVENT_VERSION 5
+#define ANT_TEVENT_VERSION 6
 
 namespace ant {
 
 #ifndef __CINT__
 struct TID;
 struct TEventData;
+class MemoryInputArchive;
 #endif
 
 
@@ -35,12 +36,13 @@ struct TEvent
     bool SavedForSlowControls = false;
 
     template<class Archive>
-    void serialize(Archive& archive, const std::uint32_t version) {
-        if(version != ANT_TEVENT_VERSION)
-            throw std::runtime_error("TEvent version mismatch");
+    void save(Archive& archive, const std::uint32_t) const {
         archive(reconstructed, mctrue, SavedForSlowControls);
     }
 
+    // also reads version 5, which stored the TEventData without length-prefixed collections
+    void load(MemoryInputArchive& archive, const std::uint32_t version);
+
     friend std::ostream& operator<<( std::ostream& s, const TEvent& o);
 
     explicit TEvent(const TID& id_reconstructed);
@@ -1,11 +1,197 @@
 #include "TEventData.h"
+#include "stream_TBuffer.h"
+#include "MemoryArchive.h"
+
+#include "base/std_ext/string.h"
+
+#include <sstream>
+#include <stdexcept>
 
 using namespace std;
 using namespace ant;
 
+// tell cereal to use the correct TParticle load/save due to inheritance from LorentzVec
+namespace cereal
+{
+  template <class Archive>
+  struct specialize<Archive, TParticle, cereal::specialization::member_load_save> {};
+}
+
+thread_local TEventData::collections_t TEventData::LazyCollections;
+
 TEventData::TEventData(const TID& id) : ID(id) {}
 TEventData::TEventData() = default;
 
+const char* TEventData::GetCollectionName(Collection_t c)
+{
+    switch(c) {
+    case Collection_t::DetectorReadHits: return "DetectorReadHits";
+    case Collection_t::SlowControls:     return "SlowControls";
+    case Collection_t::UnpackerMessages: return "UnpackerMessages";
+    case Collection_t::TaggerHits:       return "TaggerHits";
+    case Collection_t::Candidates:       return "Candidates";
+    }
+    throw runtime_error("Not implemented");
+}
+
+TEventData::collections_t TEventData::GetCollections(const string& names)
+{
+    collections_t collections;
+    for(const auto& name : std_ext::tokenize_string(names, ",")) {
+        bool found = false;
+        for(unsigned i=0;i<NCollections;i++) {
+            const auto c = static_cast<Collection_t>(i);
+            if(name == GetCollectionName(c)) {
+                collections.set(c);
+                found = true;
+            }
+        }
+        if(!found)
+            throw runtime_error("Unknown TEventData collection '"+name+"'");
+    }
+    return collections;
+}
+
+namespace {
+
+// each collection is (de)serialized by its own archive, so shared pointers
+// must not cross collections, the particles refer to the candidates
+template<class Archive, class Data>
+void serialize_collection(Archive& archive, TEventData::Collection_t c, Data& d) {
+    using C = TEventData::Collection_t;
+    switch(c) {
+    case C::DetectorReadHits: archive(d.DetectorReadHits); return;
+    case C::SlowControls:     archive(d.SlowControls); return;
+    case C::UnpackerMessages: archive(d.UnpackerMessages); return;
+    case C::TaggerHits:       archive(d.TaggerHits); return;
+    case C::Candidates:       archive(d.Clusters, d.Candidates, d.ParticleTree); return;
+    }
+}
+
+}
+
+const string& TEventData::Encode(Collection_t c, string& blob) const
+{
+    blob.clear();
+    {
+        MemoryOutputArchive ar(blob);
+        serialize_collection(ar, c, *this);
+    }
+    return blob;
+}
+
+namespace {
+
+bool collection_empty(const TEventData& d, TEventData::Collection_t c) {
+    using C = TEventData::Collection_t;
+    switch(c) {
+    case C::DetectorReadHits: return d.DetectorReadHits.empty();
+    case C::SlowControls:     return d.SlowControls.empty();
+    case C::UnpackerMessages: return d.UnpackerMessages.empty();
+    case C::TaggerHits:       return d.TaggerHits.empty();
+    case C::Candidates:       return d.Clusters.empty() && d.Candidates.empty() && d.ParticleTree == nullptr;
+    }
+    return true;
+}
+
+}
+
+void TEventData::CheckUnmodified(Collection_t c) const
+{
+    if(!collection_empty(*this, c))
+        throw ExceptionUndecoded(std_ext::formatter() << "TEventData collection " << GetCollectionName(c)
+                                 << " was filled before it was decoded, call Decode() before accessing it");
+}
+
+void TEventData::Decode(Collection_t c)
+{
+    if(IsDecoded(c))
+        return;
+    CheckUnmodified(c);
+    auto& blob = blobs[static_cast<unsigned>(c)];
+    {
+        MemoryInputArchive ar(blob.data(), blob.data()+blob.size());
+        serialize_collection(ar, c, *this);
+    }
+    undecoded.unset(c);
+    blob.clear();
+}
+
+void TEventData::save(MemoryOutputArchive& archive) const
+{
+    archive(ID, Trigger, Target);
+    for(unsigned i=0;i<NCollections;i++) {
+        const auto c = static_cast<Collection_t>(i);
+        if(!IsDecoded(c)) {
+            CheckUnmodified(c);
+            const auto& b = blobs[i];
+            const std::uint64_t size = b.size();
+            archive(size, cereal::binary_data(b.data(), size));
+            continue;
+        }
+        // encode directly behind the size, which is filled in afterwards
+        std::uint64_t size = 0;
+        archive(size);
+        const auto start = archive.Position();
+        {
+            MemoryOutputArchive ar(archive);
+            serialize_collection(ar, c, *this);
+        }
+        size = archive.Position() - start;
+        archive.Overwrite(start - sizeof(size), addressof(size), sizeof(size));
+    }
+}
+
+void TEventData::load(MemoryInputArchive& archive)
+{
+    archive(ID, Trigger, Target);
+    for(unsigned i=0;i<NCollections;i++) {
+        const auto c = static_cast<Collection_t>(i);
+        auto& b = blobs[i];
+        std::uint64_t size;
+        archive(size);
+        const char* data = archive.Skip(size);
+        if(LazyCollections.test(c)) {
+            b.assign(data, size);
+            undecoded.set(c);
+            continue;
+        }
+        b.clear();
+        {
+            MemoryInputArchive ar(data, data+size);
+            serialize_collection(ar, c, *this);
+        }
+        undecoded.unset(c);
+    }
+}
+
+void TEventData::load_v5(MemoryInputArchive& archive)
+{
+    // shared pointers cross collections here, so use one archive
+    archive(ID,
+            DetectorReadHits, SlowControls, UnpackerMessages,
+            TaggerHits, Trigger, Target,
+            Clusters, Candidates, ParticleTree);
+    for(auto& b : blobs)
+        b.clear();
+    undecoded = {};
+}
+
+void TEventData::Decode(const collections_t& collections)
+{
+    for(unsigned i=0;i<NCollections;i++) {
+        const auto c = static_cast<Collection_t>(i);
+        if(collections.test(c))
+            Decode(c);
+    }
+}
+
+void TEventData::Decode()
+{
+    for(unsigned i=0;i<NCollections;i++)
+        Decode(static_cast<Collection_t>(i));
+}
+
 
 string _GetDecayString(const TParticleTree_t& particletree)
 {
@@ -81,4 +267,6 @@ ostream& operator<<(ostream& s, const TEventData& o) {
 void TEventData::ClearDetectorReadHits()
 {
     DetectorReadHits.resize(0);
+    blobs[static_cast<unsigned>(Collection_t::DetectorReadHits)].clear();
+    undecoded.unset(Collection_t::DetectorReadHits);
 }
@@ -13,8 +13,20 @@
 #include "TCandidate.h"
 #include "TParticle.h"
 
+#include "base/bitflag.h"
+
+#include "cereal/cereal.hpp"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
 namespace ant {
 
+class MemoryOutputArchive;
+class MemoryInputArchive;
+
 struct TEventData
 {
     TEventData(const TID& id);
@@ -33,18 +45,87 @@ struct TEventData
     TCandidateList   Candidates;
     TParticleTree_t  ParticleTree; // only on MC
 
+    /**
+     * @brief The Collection_t enum lists the parts of the event, which are stored as length-prefixed blobs
+     * @note Candidates includes the Clusters and the ParticleTree, as they refer to each other
+     */
+    enum class Collection_t : std::uint8_t {
+        DetectorReadHits, SlowControls, UnpackerMessages, TaggerHits, Candidates
+    };
+    static constexpr unsigned NCollections = 5;
+    using collections_t = bitflag<Collection_t>;
+
+    static const char* GetCollectionName(Collection_t c);
+    static collections_t GetCollections(const std::string& names);
+
+    /**
+     * @brief LazyCollections are not decoded when loading, but only on the first call of Decode()
+     * @note thread_local, as ROOT calls the streamer without any further context.
+     * Undecoded collections are empty, but written back unchanged when saving.
+     * Filling an undecoded collection makes Decode() and saving throw, as the changes would be lost.
+     * The PhysicsManager decodes the collections any physics class declares to read, see Physics::GetCollections.
+     */
+    static thread_local collections_t LazyCollections;
+
+    bool IsDecoded(Collection_t c) const { return !undecoded.test(c); }
+    void Decode(Collection_t c);
+    void Decode(const collections_t& collections);
+    void Decode();
+
+    struct ExceptionUndecoded : std::runtime_error {
+        using std::runtime_error::runtime_error;
+    };
+
+    template<class Archive>
+    void save(Archive& archive) const {
+        archive(ID, Trigger, Target);
+        std::string blob;
+        for(unsigned i=0;i<NCollections;i++) {
+            const auto c = static_cast<Collection_t>(i);
+            if(!IsDecoded(c))
+                CheckUnmodified(c);
+            const std::string& b = IsDecoded(c) ? Encode(c, blob) : blobs[i];
+            const std::uint64_t size = b.size();
+            archive(size, cereal::binary_data(b.data(), size));
+        }
+    }
+
     template<class Archive>
-    void serialize(Archive& archive) {
-        archive(ID,
-                DetectorReadHits, SlowControls, UnpackerMessages,
-                TaggerHits, Trigger, Target,
-                Clusters, Candidates, ParticleTree);
+    void load(Archive& archive) {
+        archive(ID, Trigger, Target);
+        for(unsigned i=0;i<NCollections;i++) {
+            const auto c = static_cast<Collection_t>(i);
+            auto& b = blobs[i];
+            std::uint64_t size;
+            archive(size);
+            b.resize(size);
+            archive(cereal::binary_data(&b[0], size));
+            undecoded.set(c);
+            if(!LazyCollections.test(c))
+                Decode(c);
+        }
     }
 
+    // the memory archives encode the collections in place, without intermediate blobs
+    void save(MemoryOutputArchive& archive) const;
+    void load(MemoryInputArchive& archive);
+
+    // all collections in one archive, as in TEvent version 5
+    void load_v5(MemoryInputArchive& archive);
+
     friend std::ostream& operator<<(std::ostream& s, const TEventData& o);
 
     void ClearDetectorReadHits();
 
+protected:
+    // raw blobs of undecoded collections, indexed by Collection_t
+    std::array<std::string, NCollections> blobs;
+    collections_t undecoded;
+
+    const std::string& Encode(Collection_t c, std::string& blob) const;
+
+    // throws ExceptionUndecoded if the undecoded collection was filled
+    void CheckUnmodified(Collection_t c) const;
 };
 
 }
\ No newline at end of file
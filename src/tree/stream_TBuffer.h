@@ -9,65 +9,37 @@
 #include "cereal/types/string.hpp"
 #include "cereal/types/vector.hpp"
 #include "cereal/types/list.hpp"
-#include "cereal/archives/binary.hpp"
 #include "cereal/types/bitset.hpp"
 #pragma GCC diagnostic pop
 
+#include "MemoryArchive.h"
+
 #include "TBuffer.h"
-#include <streambuf>
 
 namespace ant {
 
-class stream_TBuffer : public std::streambuf {
-public:
-    explicit stream_TBuffer(TBuffer& tbuffer) :
-        tbuffer_(tbuffer)
-    {
-        if(tbuffer_.IsReading()) {
-            // reading uses the default std::streambuf behaviour
-            const auto begin = tbuffer_.Buffer()+tbuffer_.Length();
-            const auto end = tbuffer_.Buffer()+tbuffer_.BufferSize();
-            setg(begin, begin, end);
-        }
-    }
+struct stream_TBuffer {
 
     // little helper function to call the binary archiver
-    // on some class
+    // on some class, directly on the memory of the TBuffer
     template<class T>
     static void DoBinary(TBuffer& tbuffer, T& theClass) {
-        stream_TBuffer buf(tbuffer);
-        std::iostream inoutstream(addressof(buf));
-
         if (tbuffer.IsReading()) {
-            cereal::BinaryInputArchive ar(inoutstream);
+            MemoryInputArchive ar(tbuffer);
             ar(theClass);
         }
         else {
-            cereal::BinaryOutputArchive ar(inoutstream);
-            ar(theClass);
-        }
-    }
-
-private:
-    // the streambuf interface for writing
-    std::streamsize xsputn(const char_type* s, std::streamsize n) override {
-        tbuffer_.WriteFastArray(s, n);
-        return n;
-    }
-
-    int_type overflow(int_type ch) override {
-        if(ch != traits_type::eof()) {
-            tbuffer_.WriteChar(ch);
+            // reserve a bit more than the last object needed,
+            // so that the buffer is rarely grown while writing
+            static thread_local std::size_t sizeHint = 0;
+            const std::size_t start = tbuffer.Length();
+            {
+                MemoryOutputArchive ar(tbuffer, sizeHint + sizeHint/4);
+                ar(theClass);
+            }
+            sizeHint = tbuffer.Length() - start;
         }
-        return ch;
     }
-
-    // forbid copy
-    stream_TBuffer(const stream_TBuffer&) = delete;
-    stream_TBuffer& operator=(const stream_TBuffer&) = delete;
-
-    // hold a reference to the buffer for writing business
-    TBuffer& tbuffer_;
 };
 
-}
\ No newline at end of file
+}
@@ -11,7 +11,7 @@
 using namespace std;
 using namespace ant;
 
-std::unique_ptr<Unpacker::Module> Unpacker::Get(const string& filename)
+std::unique_ptr<Unpacker::Module> Unpacker::Get(const string& filename, Module::setup_t setup)
 {
     // make a list of available unpackers
     std::list< std::unique_ptr<Module> > modules;
@@ -19,7 +19,8 @@ std::unique_ptr<Unpacker::Module> Unpacker::Get(const string& filename)
     modules.push_back(std_ext::make_unique<UnpackerA2Geant>());
 
     // remove the unpacker if it says that it could not open the file
-    modules.remove_if([&filename] (const unique_ptr<Module>& m) {
+    modules.remove_if([&filename, &setup] (const unique_ptr<Module>& m) {
+        m->setup = setup;
         return !m->OpenFile(filename);
     });
 
@@ -23,11 +23,16 @@
 
 #include <string>
 #include <memory>
+#include <stdexcept>
 
 namespace ant {
 
 struct TEvent;
 
+namespace expconfig {
+class Setup_traits;
+}
+
 /**
  * @brief The Unpacker class encapsulates the interface for unpacking raw data
  */
@@ -43,21 +48,35 @@ public:
      */
     class Module {
     public:
+        using setup_t = std::shared_ptr<const expconfig::Setup_traits>;
+
         virtual ~Module() = default;
         virtual TEvent NextEvent() = 0;
         virtual double PercentDone() const = 0;
+
+        /**
+         * @brief GetSetup returns the setup the file is unpacked with
+         * @return the setup given to Unpacker::Get, or the one found for the file
+         */
+        const setup_t& GetSetup() const { return setup; }
     protected:
         friend class Unpacker;
+        /**
+         * @brief OpenFile uses the setup if given, otherwise the current one of ExpConfig
+         * @note implementations should set the setup they found
+         */
         virtual bool OpenFile(const std::string& filename) = 0;
+        setup_t setup;
     };
 
     /**
      * @brief Get a unique unpacker instance for the given filename
      * @param filename the file to be examined for unpacking
+     * @param setup to unpack with, independent of the current one of ExpConfig, which is used if nullptr
      * @return pointer to the unpacker instance
      * @throw Exception if no or more than one unpacker for filename found
      */
-    static std::unique_ptr<Module> Get(const std::string &filename);
+    static std::unique_ptr<Module> Get(const std::string &filename, Module::setup_t setup = nullptr);
 
     /**
      * @brief The Exception class is thrown if an unexpected error during unpacking occurs
@@ -130,12 +130,14 @@ bool UnpackerA2Geant::OpenFile(const string& filename)
         }
     }
 
-    // try to get a config
-    auto& setup = ExpConfig::Setup::GetByType<UnpackerA2GeantConfig>();
+    // try to get a config, if not given
+    if(!setup)
+        setup = ExpConfig::Setup::GetShared();
+    auto& config = ExpConfig::Setup::GetByType<UnpackerA2GeantConfig>(*setup);
 
     // find some taggerdetectors
     // needed to create proper tagger hits from incoming photons
-    for(const shared_ptr<Detector_t>& detector : setup.GetDetectors()) {
+    for(const shared_ptr<Detector_t>& detector : config.GetDetectors()) {
         /// \todo check for multiply defined detectors...
         if(auto tagger = dynamic_pointer_cast<TaggerDetector_t, Detector_t>(detector))
             taggerdetector = tagger;
@@ -155,7 +157,7 @@ bool UnpackerA2Geant::OpenFile(const string& filename)
         // initialize randomness
         promptrandom = std_ext::make_unique<unpacker::geant::promptrandom_t>(
                            taggerdetector,
-                           setup.GetPromptRandomConfig()
+                           config.GetPromptRandomConfig()
                            );
     }
 
@@ -184,11 +186,11 @@ TEvent UnpackerA2Geant::NextEvent()
     if(current_entry>=t.Tree->GetEntriesFast()-1)
         return {};
 
-    t.Tree->GetEntry(++current_entry);
+    t.GetEntry(++current_entry);
 
     // read TIDs in sync
     if(tidTree)
-        tidTree.Tree->GetEntry(current_entry);
+        tidTree.GetEntry(current_entry);
 
     // start with an empty event with reconstructed ID set
     // MCTrue ID will be set by MCTrue reader, but this unpacker
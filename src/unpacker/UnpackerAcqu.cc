@@ -9,6 +9,8 @@
 using namespace std;
 using namespace ant;
 
+unsigned UnpackerAcqu::DecoderThreads = 0;
+
 UnpackerAcqu::UnpackerAcqu() {}
 UnpackerAcqu::~UnpackerAcqu() {}
 
@@ -21,10 +23,11 @@ bool UnpackerAcqu::OpenFile(const std::string &filename)
 {
     // this might also throw an exception if something
     // is strange with the file
-    file = UnpackerAcquFileFormat::Get(filename);
+    file = UnpackerAcquFileFormat::Get(filename, setup);
     // check if we were successful in finding a file
     if(file == nullptr)
         return false;
+    setup = file->GetSetup();
 
     LOG(INFO) << "Successfully opened " << filename;
     return true;
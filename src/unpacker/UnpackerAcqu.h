@@ -31,6 +31,14 @@ public:
 
     virtual double PercentDone() const override;
 
+    /**
+     * @brief DecoderThreads sets the number of threads decoding the data buffers of one file in parallel
+     *
+     * A reader thread slices the file into records, and the sequencer in NextEvent
+     * restores the file order. Zero (default) unpacks sequentially in the calling thread.
+     */
+    static unsigned DecoderThreads;
+
 private:
     std::list<TEvent> queue; // std::list supports splice
     std::unique_ptr<UnpackerAcquFileFormat> file;
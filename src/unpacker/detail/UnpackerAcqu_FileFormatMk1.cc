@@ -10,6 +10,7 @@
 #include "tree/TEventData.h"
 
 #include "base/Logger.h"
+#include "base/std_ext/memory.h"
 
 #include <numeric>
 
@@ -159,6 +160,11 @@ void acqu::FileFormatMk1::FillFirstDataBuffer(reader_t& reader, buffer_t& buffer
     throw UnpackerAcqu::Exception("Did not find first data buffer with Mk1 signature");
 }
 
+unique_ptr<acqu::FileFormatBase> acqu::FileFormatMk1::MakeDecoder() const
+{
+    return std_ext::make_unique<FileFormatMk1>(*this);
+}
+
 void acqu::FileFormatMk1::UnpackEvent(TEventData& eventdata, it_t& it, const it_t& it_endbuffer, bool& good) noexcept
 {
     assert(std::distance(it, it_endbuffer)>0);
@@ -10,6 +10,7 @@
 #include "RawFileReader.h"
 
 #include "base/Logger.h"
+#include "base/std_ext/memory.h"
 
 using namespace std;
 using namespace ant;
@@ -122,6 +123,11 @@ void acqu::FileFormatMk2::FillFirstDataBuffer(reader_t& reader, buffer_t& buffer
 
 
 
+unique_ptr<acqu::FileFormatBase> acqu::FileFormatMk2::MakeDecoder() const
+{
+    return std_ext::make_unique<FileFormatMk2>(*this);
+}
+
 void acqu::FileFormatMk2::UnpackEvent(
         TEventData& eventdata,
         it_t& it, const it_t& it_endbuffer,
@@ -513,7 +519,7 @@ void acqu::FileFormatMk2::HandleEPICSBuffer(
                 break;
             }
             default:
-                LOG(ERROR) << "Not implemented";
+                LogError("Not implemented");
 
             } // end switch
 
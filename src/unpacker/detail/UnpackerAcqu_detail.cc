@@ -16,8 +16,13 @@
 #include "RawFileReader.h"
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
 #include <exception>
 #include <list>
+#include <mutex>
+#include <thread>
 #include <ctime>
 #include <iterator> // for std::next
 #include <cstdlib>
@@ -28,7 +33,7 @@ using namespace ant::unpacker;
 
 
 unique_ptr<UnpackerAcquFileFormat>
-UnpackerAcquFileFormat::Get(const string& filename)
+UnpackerAcquFileFormat::Get(const string& filename, setup_t setup)
 {
     // make a list of all available acqu file format classes
     using format_t = unique_ptr<UnpackerAcquFileFormat>;
@@ -73,6 +78,7 @@ UnpackerAcquFileFormat::Get(const string& filename)
     // give him the reader and the buffer for further processing
     // also fill some header-like events into the queue
     const format_t& format = formats.back();
+    format->setup = move(setup);
     format->Setup(move(reader), move(buffer));
 
     // return the UnpackerAcquFormat instance
@@ -81,6 +87,59 @@ UnpackerAcquFileFormat::Get(const string& filename)
 
 UnpackerAcquFileFormat::~UnpackerAcquFileFormat() {}
 
+// one record of the file, travelling from the reader over some decoder to the sequencer
+struct acqu::FileFormatBase::record_t {
+    unsigned Index;
+    buffer_t Buffer;
+
+    // filled by the reader, Last indicates that reading the following record failed
+    bool Last = false;
+    vector<TUnpackerMessage> ReadMessages;
+
+    // filled by the decoder, the events have provisional IDs
+    bool Decoded = false;
+    bool Good = false;
+    queue_t Events;
+    unsigned nIDs = 0;
+    // AcquIDs seen in the record, also if it turned out bad
+    bool HasAcquIDs = false;
+    unsigned AcquID_first = 0;
+    unsigned AcquID_last = 0;
+    vector<TUnpackerMessage> Messages;
+    vector<deferred_log_t> Logs;
+};
+
+struct acqu::FileFormatBase::pipeline_t {
+    mutex Mutex;
+    condition_variable Changed;
+    bool Stop = false;
+    size_t MaxInFlight = 0;
+
+    unique_ptr<record_t> First;
+    deque<unique_ptr<record_t>> InOrder; // owns all records until sequenced
+    deque<record_t*> ToDecode;
+
+    atomic<double> PercentDone{0};
+
+    vector<unique_ptr<FileFormatBase>> Decoders;
+    vector<thread> Threads;
+};
+
+acqu::FileFormatBase::FileFormatBase() {}
+
+acqu::FileFormatBase::FileFormatBase(const FileFormatBase& other) :
+    UnpackerAcquFileFormat(),
+    trueRecordLength(other.trueRecordLength),
+    nUnpackedBuffers(0),
+    nEventsInBuffer(0),
+    deferLogs(true),
+    info(other.info),
+    id(other.id),
+    // the hit mappings stay owned by other, which outlives its decoders
+    hit_mappings_ptr(other.hit_mappings_ptr),
+    scaler_mappings(other.scaler_mappings)
+{}
+
 void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
     reader = move(reader_);
     buffer = move(buffer_);
@@ -108,9 +167,12 @@ void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
     // construct the unique ID
     id = TID(timestamp, 0u);
 
-    // try to find some config with the id
-    ExpConfig::Setup::SetByTID(id);
-    auto& setup = ExpConfig::Setup::GetByType<UnpackerAcquConfig>();
+    // try to find some config with the id, if not given
+    if(!setup) {
+        ExpConfig::Setup::SetByTID(id);
+        setup = ExpConfig::Setup::GetShared();
+    }
+    auto& config = ExpConfig::Setup::GetByType<UnpackerAcquConfig>(*setup);
 
     // now try to fill the first data buffer
     FillFirstDataBuffer(reader, buffer);
@@ -120,7 +182,7 @@ void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
     trueRecordLength = buffer.size();
 
     // get the mappings once
-    setup.BuildMappings(hit_mappings, scaler_mappings);
+    config.BuildMappings(hit_mappings, scaler_mappings);
 
     // and prepare the member variables for fast unpacking of hits
     for(const UnpackerAcquConfig::hit_mapping_t& hit_mapping : hit_mappings) {
@@ -136,11 +198,14 @@ void acqu::FileFormatBase::Setup(reader_t &&reader_, buffer_t &&buffer_) {
 
 acqu::FileFormatBase::~FileFormatBase()
 {
-
+    StopPipeline();
 }
 
 double acqu::FileFormatBase::PercentDone() const
 {
+    // the reader belongs to the reader thread while decoding in parallel
+    if(pipeline)
+        return pipeline->PercentDone;
     return reader->PercentDone();
 }
 
@@ -223,10 +288,36 @@ void acqu::FileFormatBase::LogMessage(
     const string& msg_ = std_ext::formatter()
                          << "(nUnpackedBuffers=" << nUnpackedBuffers << ", nEventsInBuffer=" << nEventsInBuffer << ")"
                          << " [TUnpackerMessage] " << messages.back().Message;
-    if(emit_warning)
-        LOG(WARNING) << msg_;
+    using Type_t = deferred_log_t::Type_t;
+    Log({emit_warning ? Type_t::Warning : Type_t::Verbose, levelnum, msg_});
+}
+
+void acqu::FileFormatBase::LogError(const string& msg) const
+{
+    Log({deferred_log_t::Type_t::Error, 0, msg});
+}
+
+void acqu::FileFormatBase::Log(deferred_log_t log) const
+{
+    if(deferLogs)
+        deferredLogs.emplace_back(move(log));
     else
-        VLOG(levelnum) << msg_;
+        EmitLog(log);
+}
+
+void acqu::FileFormatBase::EmitLog(const deferred_log_t& log)
+{
+    switch(log.Type) {
+    case deferred_log_t::Type_t::Verbose:
+        VLOG(log.Level) << log.Message;
+        break;
+    case deferred_log_t::Type_t::Warning:
+        LOG(WARNING) << log.Message;
+        break;
+    case deferred_log_t::Type_t::Error:
+        LOG(ERROR) << log.Message;
+        break;
+    }
 }
 
 void acqu::FileFormatBase::AppendMessagesToEvent(TEvent& event) const
@@ -248,6 +339,11 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
     // this method never throws exceptions, but just adds TUnpackerMessage to event
     // if something strange while unpacking is encountered
 
+    if(pipeline) {
+        FillEventsParallel(queue);
+        return;
+    }
+
     // we use the buffer as some state-variable
     // if the buffer is already empty now, there is nothing more to read
     if(buffer.empty()) {
@@ -262,6 +358,19 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
         return;
     }
 
+    // decoding in parallel starts with the first data buffer,
+    // but verbose logging is only safe from this thread
+    if(UnpackerAcqu::DecoderThreads>0 && nUnpackedBuffers == 0) {
+        if(VLOG_IS_ON(2)) {
+            LOG(WARNING) << "Verbose logging enabled, unpacking Acqu buffers sequentially";
+        }
+        else {
+            StartPipeline(UnpackerAcqu::DecoderThreads);
+            FillEventsParallel(queue);
+            return;
+        }
+    }
+
     // start parsing the filled buffer
     // however, we fill a temporary queue first
     auto it = buffer.cbegin();
@@ -292,38 +401,250 @@ void acqu::FileFormatBase::FillEvents(queue_t& queue) noexcept
     nUnpackedBuffers++;
 
 
-    // refill the buffer
+    // refill the buffer, clear it if there was a problem when reading
+    vector<TUnpackerMessage> readMessages;
+    if(!ReadRecord(buffer, readMessages))
+        buffer.clear();
+    for(const auto& m : readMessages)
+        LogMessage(m.Level, m.Message);
+
+    // the above refill might have created messages,
+    // and to suppress empty events with messages only,
+    // we simply append them to the last event if any present
+    if(!queue.empty())
+        AppendMessagesToEvent(queue.back());
+}
+
+bool acqu::FileFormatBase::ReadRecord(buffer_t& buffer, vector<TUnpackerMessage>& readMessages) noexcept
+{
+    bool good = true;
     try {
         reader->read(buffer.data(), trueRecordLength);
     }
     catch(ant::RawFileReader::Exception e) {
-        // clear buffer if there was a problem when reading
-        LogMessage(TUnpackerMessage::Level_t::DataError,
-                   std_ext::formatter()
-                   << "Error while reading input: " << e.what());
-        buffer.clear();
+        readMessages.emplace_back(TUnpackerMessage::Level_t::DataError,
+                                  std_ext::formatter()
+                                  << "Error while reading input: " << e.what());
+        good = false;
     }
 
     // check if actually enough bytes were read
     if(reader->gcount() != 4*trueRecordLength) {
         // reached the end of file properly?
         if(reader->gcount() == 0 && reader->eof()) {
-            LogMessage(TUnpackerMessage::Level_t::Info,
-                       std_ext::formatter()
-                       << "Found proper end of file");
+            readMessages.emplace_back(TUnpackerMessage::Level_t::Info,
+                                      std_ext::formatter()
+                                      << "Found proper end of file");
         }
         else {
+            readMessages.emplace_back(TUnpackerMessage::Level_t::DataError,
+                                      std_ext::formatter()
+                                      << "Read only " << reader->gcount()
+                                      << " bytes, not enough for record length " << 4*trueRecordLength);
+        }
+        good = false;
+    }
+    return good;
+}
+
+void acqu::FileFormatBase::StartPipeline(unsigned nThreads)
+{
+    pipeline = std_ext::make_unique<pipeline_t>();
+    auto& p = *pipeline;
+    // limit the records in memory, but keep all decoders busy
+    p.MaxInFlight = 4*nThreads;
+    p.PercentDone = reader->PercentDone();
+
+    p.First = std_ext::make_unique<record_t>();
+    p.First->Index = nUnpackedBuffers;
+    p.First->Buffer = move(buffer);
+
+    for(unsigned i=0;i<nThreads;i++)
+        p.Decoders.emplace_back(MakeDecoder());
+    for(auto& decoder : p.Decoders) {
+        auto d = decoder.get();
+        p.Threads.emplace_back([this, d] () { DecodeRecords(*d); });
+    }
+    p.Threads.emplace_back([this] () { ReadRecords(); });
+
+    VLOG(5) << "Started unpacking Acqu buffers with " << nThreads << " decoder threads";
+}
+
+void acqu::FileFormatBase::StopPipeline() noexcept
+{
+    if(!pipeline)
+        return;
+    {
+        lock_guard<mutex> lock(pipeline->Mutex);
+        pipeline->Stop = true;
+    }
+    pipeline->Changed.notify_all();
+    for(auto& t : pipeline->Threads)
+        t.join();
+    pipeline = nullptr;
+}
+
+void acqu::FileFormatBase::ReadRecords() noexcept
+{
+    auto& p = *pipeline;
+    auto record = move(p.First);
+    while(record) {
+        // a record can only be handed over once it's known if it's the last one
+        auto next = std_ext::make_unique<record_t>();
+        next->Index = record->Index+1;
+        next->Buffer.resize(trueRecordLength);
+        if(!ReadRecord(next->Buffer, record->ReadMessages)) {
+            record->Last = true;
+            next = nullptr;
+        }
+        p.PercentDone = reader->PercentDone();
+
+        {
+            unique_lock<mutex> lock(p.Mutex);
+            p.Changed.wait(lock, [&p] () { return p.Stop || p.InOrder.size() < p.MaxInFlight; });
+            if(p.Stop)
+                return;
+            p.ToDecode.push_back(record.get());
+            p.InOrder.emplace_back(move(record));
+        }
+        p.Changed.notify_all();
+        record = move(next);
+    }
+}
+
+void acqu::FileFormatBase::DecodeRecords(FileFormatBase& decoder) noexcept
+{
+    auto& p = *pipeline;
+    while(true) {
+        record_t* record = nullptr;
+        {
+            unique_lock<mutex> lock(p.Mutex);
+            p.Changed.wait(lock, [&p] () { return p.Stop || !p.ToDecode.empty(); });
+            if(p.Stop)
+                return;
+            record = p.ToDecode.front();
+            p.ToDecode.pop_front();
+        }
+
+        decoder.DecodeRecord(*record);
+
+        {
+            lock_guard<mutex> lock(p.Mutex);
+            record->Decoded = true;
+        }
+        p.Changed.notify_all();
+    }
+}
+
+void acqu::FileFormatBase::DecodeRecord(record_t& record) noexcept
+{
+    // the first event of the record has no predecessor to check the AcquID against,
+    // this is done by the sequencer
+    id.Lower = 0;
+    AcquID_last = 0;
+    nUnpackedBuffers = record.Index;
+
+    auto it = record.Buffer.cbegin();
+    record.Good = UnpackDataBuffer(record.Events, it, record.Buffer.cend());
+    record.nIDs = id.Lower;
+
+    // every AcquID read got an event, even if unpacking it failed afterwards
+    record.HasAcquIDs = !record.Events.empty();
+    if(record.HasAcquIDs) {
+        record.AcquID_first = record.Events.front().Reconstructed().Trigger.DAQEventID;
+        record.AcquID_last = AcquID_last;
+    }
+
+    record.Messages = move(messages);
+    messages.clear();
+    record.Logs = move(deferredLogs);
+    deferredLogs.clear();
+}
+
+void acqu::FileFormatBase::FillEventsParallel(queue_t& queue) noexcept
+{
+    auto& p = *pipeline;
+
+    // the sequencer takes the records in file order
+    unique_ptr<record_t> record;
+    {
+        unique_lock<mutex> lock(p.Mutex);
+        p.Changed.wait(lock, [&p] () { return !p.InOrder.empty() && p.InOrder.front()->Decoded; });
+        record = move(p.InOrder.front());
+        p.InOrder.pop_front();
+    }
+    p.Changed.notify_all();
+
+    for(const auto& log : record->Logs)
+        EmitLog(log);
+
+    nEventsInBuffer = 0;
+
+    // the decoder could not check the first AcquID of the record,
+    // so do it here as UnpackDataBuffer would have done, also for discarded records
+    if(record->HasAcquIDs) {
+        if(id.Lower>0 && record->AcquID_first != AcquID_last+1) {
             LogMessage(TUnpackerMessage::Level_t::DataError,
                        std_ext::formatter()
-                       << "Read only " << reader->gcount()
-                       << " bytes, not enough for record length " << 4*trueRecordLength);
+                       << "AcquID=" << record->AcquID_first << " not consecutive from last AcquID=" << AcquID_last,
+                       true // emit warning
+                       );
         }
-        buffer.clear();
+        AcquID_last = record->AcquID_last;
     }
 
-    // the above refill might have created messages,
-    // and to suppress empty events with messages only,
-    // we simply append them to the last event if any present
+    if(!record->Good) {
+        LOG(WARNING) << "Error while unpacking buffer n=" << nUnpackedBuffers
+                     << ", discarding all unpacked data from buffer.";
+
+        // when sequentially unpacking, the pending messages went
+        // to the first unpacked event and were discarded with it
+        if(record->nIDs>0)
+            messages.clear();
+        messages.insert(messages.end(), record->Messages.begin(), record->Messages.end());
+
+        // the unique IDs of the discarded events are skipped,
+        // as in sequential unpacking
+        for(unsigned i=0;i<record->nIDs;i++)
+            ++id;
+
+        messages.emplace_back(
+                    TUnpackerMessage::Level_t::DataDiscard,
+                    "Discarded buffer number {}"
+                    );
+        messages.back().Payload.push_back(nUnpackedBuffers);
+
+        queue.emplace_back(id);
+        AppendMessagesToEvent(queue.back());
+    }
+    else if(!record->Events.empty()) {
+        // pending messages belong in front of the first event's messages
+        auto& u_messages = record->Events.front().Reconstructed().UnpackerMessages;
+        u_messages.insert(u_messages.begin(), messages.begin(), messages.end());
+        messages.clear();
+
+        // replace the provisional IDs
+        for(TEvent& event : record->Events) {
+            event.Reconstructed().ID = id;
+            ++id;
+        }
+
+        queue.splice(queue.end(), move(record->Events));
+        messages = move(record->Messages);
+    }
+    else {
+        messages.insert(messages.end(), record->Messages.begin(), record->Messages.end());
+    }
+
+    nUnpackedBuffers++;
+
+    for(const auto& m : record->ReadMessages)
+        LogMessage(m.Level, m.Message);
+
+    // all records read, so we're done
+    if(record->Last)
+        StopPipeline();
+
     if(!queue.empty())
         AppendMessagesToEvent(queue.back());
 }
@@ -497,7 +818,7 @@ bool acqu::FileFormatBase::UnpackDataBuffer(UnpackerAcquFileFormat::queue_t& que
 
 void acqu::FileFormatBase::FillDetectorReadHits(const hit_storage_t& hit_storage,
                                                 const hit_mappings_ptr_t& hit_mappings_ptr,
-                                                vector<TDetectorReadHit>& hits) noexcept
+                                                vector<TDetectorReadHit>& hits) const noexcept
 {
     // the order of hits corresponds to the given mappings
     hits.reserve(2*hit_storage.size());
@@ -515,11 +836,11 @@ void acqu::FileFormatBase::FillDetectorReadHits(const hit_storage_t& hit_storage
         for(const UnpackerAcquConfig::hit_mapping_t* mapping : hit_mappings_ptr[ch]) {
             using RawChannel_t = UnpackerAcquConfig::RawChannel_t<uint16_t>;
             if(mapping->RawChannels.size() != 1) {
-                LOG(ERROR) << "Not implemented";
+                LogError("Not implemented");
                 continue;
             }
             if(mapping->RawChannels[0].Mask != RawChannel_t::NoMask()) {
-                LOG(ERROR) << "Not implemented";
+                LogError("Not implemented");
                 continue;
             }
             std::vector<std::uint8_t> rawData(sizeof(uint16_t)*values.size());
@@ -29,14 +29,17 @@ public:
 
     using queue_t = std::list<TEvent>; // std::list supports splice
 
+    using setup_t = Unpacker::Module::setup_t;
+
     /**
       * @brief Get a suitable instance for the given filename
       * @param filename the file to read
+      * @param setup to unpack with, found by the TID of the file if nullptr
       * @return the instance, or nullptr if nothing found
       *
       * Throws exception if something unusual is encountered.
       */
-    static std::unique_ptr<UnpackerAcquFileFormat> Get(const std::string& filename);
+    static std::unique_ptr<UnpackerAcquFileFormat> Get(const std::string& filename, setup_t setup);
 
     /**
       * @brief FillEvents fills the given queue with more TEvent items (if any left)
@@ -48,7 +51,11 @@ public:
 
     virtual double PercentDone() const =0;
 
+    const setup_t& GetSetup() const { return setup; }
+
 protected:
+    setup_t setup;
+
     virtual size_t SizeOfHeader() const = 0;
     virtual bool InspectHeader(const std::vector<uint32_t>& buffer) const = 0;
     virtual void Setup(std::unique_ptr<RawFileReader>&& reader_,
@@ -63,6 +70,7 @@ namespace acqu {
 // FileFormatBase provides a common class for Mk1/Mk2 formats
 class FileFormatBase : public UnpackerAcquFileFormat {
 public:
+    FileFormatBase();
     virtual ~FileFormatBase();
 
     virtual double PercentDone() const override;
@@ -78,6 +86,32 @@ private:
     unsigned nUnpackedBuffers;
     unsigned nEventsInBuffer;
     time_t GetTimeStamp();
+
+    // decoders run in their own thread and
+    // leave the log output to the sequencer (easylogging is not thread-safe)
+    struct deferred_log_t {
+        enum class Type_t { Verbose, Warning, Error };
+        Type_t Type;
+        unsigned Level; // verbosity of Type_t::Verbose
+        std::string Message;
+    };
+    bool deferLogs = false;
+    mutable std::vector<deferred_log_t> deferredLogs;
+    void Log(deferred_log_t log) const;
+    static void EmitLog(const deferred_log_t& log);
+
+    // parallel decoding of records, see FillEventsParallel
+    struct record_t;
+    struct pipeline_t;
+    std::unique_ptr<pipeline_t> pipeline;
+
+    bool ReadRecord(std::vector<std::uint32_t>& buffer, std::vector<TUnpackerMessage>& readMessages) noexcept;
+    void StartPipeline(unsigned nThreads);
+    void StopPipeline() noexcept;
+    void ReadRecords() noexcept;
+    void DecodeRecords(FileFormatBase& decoder) noexcept;
+    void DecodeRecord(record_t& record) noexcept;
+    void FillEventsParallel(queue_t& queue) noexcept;
 protected:
 
     using reader_t = decltype(reader);
@@ -130,6 +164,9 @@ protected:
     scaler_mappings_t scaler_mappings;
 
 
+    // copies only what is needed to decode data buffers, see MakeDecoder
+    FileFormatBase(const FileFormatBase& other);
+
     // this class already implements some stuff
     void Setup(reader_t&& reader_, buffer_t&& buffer_) override;
     void FillEvents(queue_t& queue) noexcept override;
@@ -137,20 +174,24 @@ protected:
     // unpacker messages handling
     void LogMessage(TUnpackerMessage::Level_t level,
                     const std::string& msg, bool emit_warning = false) const;
+    // logs an error without adding an unpacker message, deferred like LogMessage
+    void LogError(const std::string& msg) const;
     void AppendMessagesToEvent(TEvent& event) const;
 
     // Mk1/Mk2 specific methods
     virtual void FillInfo(reader_t& reader, buffer_t& buffer, Info& info) = 0;
     virtual void FillFirstDataBuffer(reader_t& reader, buffer_t& buffer) const = 0;
     virtual void UnpackEvent(TEventData& eventdata, it_t& it, const it_t& it_endbuffer, bool& good) noexcept = 0;
+    // copy of this instance able to run UnpackDataBuffer in another thread
+    virtual std::unique_ptr<FileFormatBase> MakeDecoder() const = 0;
 
     // things shared by Mk1/Mk2
     bool UnpackDataBuffer(queue_t& queue, it_t& it, const it_t& it_endbuffer) noexcept;
 
     std::uint32_t GetDataBufferMarker() const;
     bool SearchFirstDataBuffer(reader_t& reader, buffer_t& buffer, size_t offset) const;
-    static void FillDetectorReadHits(const hit_storage_t& hit_storage, const hit_mappings_ptr_t& hit_mappings_ptr,
-                                     std::vector<TDetectorReadHit>& hits) noexcept;
+    void FillDetectorReadHits(const hit_storage_t& hit_storage, const hit_mappings_ptr_t& hit_mappings_ptr,
+                              std::vector<TDetectorReadHit>& hits) const noexcept;
     static void FillSlowControls(const scalers_t& scalers, const scaler_mappings_t& scaler_mappings,
                                  std::vector<TSlowControl>& slowcontrols) noexcept;
 
@@ -9,6 +9,8 @@
 
 #include "unpacker/Unpacker.h"
 #include "reconstruct/Reconstruct.h"
+#include "reconstruct/ReconstructReplay.h"
+#include "calibration/Calibration.h"
 
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
@@ -17,6 +19,7 @@
 
 #include <string>
 #include <iostream>
+#include <cmath>
 
 using namespace std;
 using namespace ant;
@@ -24,12 +27,24 @@ using namespace ant::analysis;
 using namespace ant::analysis::input;
 
 void dotest_read_unpacker();
+void dotest_readhitscache();
+void dotest_readhitscache_dirty();
 
 TEST_CASE("AntReader: Read from unpacker", "[analysis]") {
     test::EnsureSetup();
     dotest_read_unpacker();
 }
 
+TEST_CASE("AntReader: Write and replay read hits cache", "[analysis]") {
+    test::EnsureSetup();
+    dotest_readhitscache();
+}
+
+TEST_CASE("AntReader: Replay read hits cache with changed module", "[analysis]") {
+    test::EnsureSetup();
+    dotest_readhitscache_dirty();
+}
+
 
 void dotest_read_unpacker() {
     auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
@@ -58,3 +73,148 @@ void dotest_read_unpacker() {
     REQUIRE(nCandidates == 864);
 
 }
+
+void dotest_readhitscache() {
+    tmpfile_t tmpfile;
+
+    unsigned nCandidates_written = 0;
+    {
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        AntReader reader(nullptr, move(unpacker), std_ext::make_unique<Reconstruct>());
+        reader.WriteReadHitsCache(tmpfile.filename);
+        event_t event;
+        while(reader.ReadNextEvent(event))
+            nCandidates_written += event.Reconstructed().Candidates.size();
+    }
+    REQUIRE(nCandidates_written == 864);
+
+    // nothing changed in calibration, so nothing needs to be re-applied
+    auto rootfiles = make_shared<WrapTFileInput>(tmpfile.filename);
+    AntReader reader(rootfiles, nullptr, std_ext::make_unique<Reconstruct>());
+    REQUIRE(reader.IsSource());
+
+    unsigned nEvents = 0;
+    unsigned nCandidates = 0;
+    unsigned nSlowControls = 0;
+    event_t event;
+    while(reader.ReadNextEvent(event)) {
+        nEvents++;
+        nCandidates += event.Reconstructed().Candidates.size();
+        nSlowControls += event.Reconstructed().SlowControls.size();
+    }
+
+    CHECK(nEvents == 221);
+    CHECK(nSlowControls == 8);
+    CHECK(nCandidates == nCandidates_written);
+}
+
+namespace {
+// NaN for not calibrated values
+bool same_value(double a, double b) {
+    return (std::isnan(a) && std::isnan(b)) || a == b;
+}
+// read hits cannot be copied
+struct written_readhit_t {
+    LogicalChannel_t Element;
+    vector<TDetectorReadHit::Value_t> Values;
+    written_readhit_t(const TDetectorReadHit& readhit) :
+        Element{readhit.DetectorType, readhit.ChannelType, readhit.Channel},
+        Values(readhit.Values)
+    {}
+};
+}
+
+void dotest_readhitscache_dirty() {
+    tmpfile_t tmpfile;
+
+    // remember the calibrated values of all read hits
+    vector<vector<written_readhit_t>> written;
+    {
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        AntReader reader(nullptr, move(unpacker), std_ext::make_unique<Reconstruct>());
+        reader.WriteReadHitsCache(tmpfile.filename);
+        event_t event;
+        while(reader.ReadNextEvent(event)) {
+            const auto& readhits = event.Reconstructed().DetectorReadHits;
+            written.emplace_back(readhits.begin(), readhits.end());
+        }
+    }
+    REQUIRE(written.size() == 221);
+
+    // pretend the CB energy calibration has changed
+    reconstruct::ReconstructReplay replay([] (const ReconstructHook::DetectorReadHits& hook) {
+        auto module = dynamic_cast<const Calibration::BaseModule*>(addressof(hook));
+        return module != nullptr && module->GetName() == "CB_Energy";
+    });
+    REQUIRE(replay.IsDirty(Detector_t::Type_t::CB, Channel_t::Type_t::Integral));
+    REQUIRE_FALSE(replay.IsDirty(Detector_t::Type_t::TAPS, Channel_t::Type_t::Integral));
+    REQUIRE_FALSE(replay.IsDirty(Detector_t::Type_t::CB, Channel_t::Type_t::Timing));
+
+    WrapTFileInput rootfiles(tmpfile.filename);
+    ReadHitsCache::Reader cache(rootfiles);
+    REQUIRE(cache);
+
+    unsigned nDirty = 0;
+    unsigned nRecalibrated = 0;
+    unsigned nClean = 0;
+    for(const auto& written_readhits : written) {
+        auto event = cache.NextEvent([&replay] (Detector_t::Type_t d, Channel_t::Type_t c) {
+            return replay.IsDirty(d, c);
+        });
+        REQUIRE(event);
+        auto& readhits = event.Reconstructed().DetectorReadHits;
+        REQUIRE(readhits.size() == written_readhits.size());
+
+        // the dirty read hits come uncalibrated from the cache
+        vector<bool> calibrated_before;
+        for(size_t i=0;i<readhits.size();i++) {
+            const auto& readhit = readhits[i];
+            const auto& expected = written_readhits[i];
+            bool same = readhit.Values.size() == expected.Values.size();
+            for(size_t j=0;same && j<readhit.Values.size();j++)
+                same = same_value(readhit.Values[j].Calibrated, expected.Values[j].Calibrated);
+            calibrated_before.push_back(same);
+        }
+
+        replay.DoReconstruct(event.Reconstructed());
+
+        for(size_t i=0;i<readhits.size();i++) {
+            const auto& readhit = readhits[i];
+            const auto& expected = written_readhits[i];
+            REQUIRE(readhit.DetectorType == expected.Element.DetectorType);
+            REQUIRE(readhit.ChannelType == expected.Element.ChannelType);
+            REQUIRE(readhit.Channel == expected.Element.Channel);
+            // dirty ones are calibrated again, the clean ones keep the cached values,
+            // both end up as before since the calibration data did not change
+            REQUIRE(readhit.Values.size() == expected.Values.size());
+            for(size_t j=0;j<readhit.Values.size();j++) {
+                CHECK(same_value(readhit.Values[j].Uncalibrated, expected.Values[j].Uncalibrated));
+                CHECK(same_value(readhit.Values[j].Calibrated, expected.Values[j].Calibrated));
+            }
+            if(replay.IsDirty(readhit.DetectorType, readhit.ChannelType)) {
+                nDirty++;
+                if(!calibrated_before[i])
+                    nRecalibrated++;
+            }
+            else {
+                REQUIRE(calibrated_before[i]);
+                nClean++;
+            }
+        }
+    }
+    REQUIRE_FALSE(cache.NextEvent({}));
+
+    CHECK(nDirty > 0);
+    CHECK(nClean > 0);
+    // not all dirty read hits have values which change by calibration
+    CHECK(nRecalibrated > 0);
+
+    // the replay cannot take over reconstructs of derived classes
+    auto make_reader = [&tmpfile] () {
+        auto rootfiles = make_shared<WrapTFileInput>(tmpfile.filename);
+        auto derived = std_ext::make_unique<reconstruct::ReconstructReplay>(
+                           [] (const ReconstructHook::DetectorReadHits&) { return false; });
+        AntReader reader(rootfiles, nullptr, move(derived));
+    };
+    REQUIRE_THROWS_AS(make_reader(), AntReader::Exception);
+}
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+
+#include "analysis/plot/CutTree.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+using namespace ant::analysis::plot;
+
+void dotest_compiled();
+void dotest_compiled_block();
+
+TEST_CASE("CutTree: Compiled", "[analysis]") {
+    dotest_compiled();
+}
+
+TEST_CASE("CutTree: Compiled blocks", "[analysis]") {
+    dotest_compiled_block();
+}
+
+unsigned nEvaluated = 0;
+
+struct TestHist_t {
+    using Fill_t = int;
+
+    vector<int> Filled;
+
+    TestHist_t(const HistogramFactory&, const cuttree::TreeInfo_t&) {}
+
+    void Fill(const Fill_t& f) {
+        Filled.push_back(f);
+    }
+
+    static cuttree::Cuts_t<Fill_t> GetCuts() {
+        auto counted = [] (function<bool(int)> passes) {
+            return [passes] (const Fill_t& f) { ++nEvaluated; return passes(f); };
+        };
+        cuttree::Cuts_t<Fill_t> cuts;
+        cuts.emplace_back(cuttree::MultiCut_t<Fill_t>{
+                              {"All",      counted([] (int)   { return true; })},
+                              {"Even",     counted([] (int f) { return f % 2 == 0; })},
+                              {"Positive", counted([] (int f) { return f > 0; })},
+                          });
+        cuts.emplace_back(cuttree::MultiCut_t<Fill_t>{
+                              {"Small",    counted([] (int f) { return f < 10; })},
+                              {"Div3",     counted([] (int f) { return f % 3 == 0; })},
+                          });
+        cuts.emplace_back(cuttree::MultiCut_t<Fill_t>{
+                              {"Large",    counted([] (int f) { return f > 50; })},
+                          });
+        return cuts;
+    }
+};
+
+void collect(const cuttree::Tree_t<TestHist_t>& node, vector<vector<int>>& filled) {
+    filled.push_back(node->Get().Hist.Filled);
+    for(const auto& d : node->Daughters())
+        collect(d, filled);
+}
+
+vector<vector<int>> fill_recursive(const vector<int>& entries) {
+    auto cuttree = cuttree::Make<TestHist_t>(HistogramFactory("Recursive"));
+    for(auto entry : entries)
+        cuttree::Fill<TestHist_t>(cuttree, entry);
+    vector<vector<int>> filled;
+    collect(cuttree, filled);
+    return filled;
+}
+
+void dotest_compiled() {
+    gDirectory->Clear();
+
+    vector<int> entries;
+    for(int entry=-20;entry<=80;entry++)
+        entries.push_back(entry);
+
+    const auto expected = fill_recursive(entries);
+    // root, 3 + 3*2 + 3*2*1 nodes
+    REQUIRE(expected.size() == 16);
+    REQUIRE(expected.front().size() == entries.size());
+
+    cuttree::Compiled_t<TestHist_t> compiled;
+    REQUIRE_FALSE(compiled);
+    compiled = cuttree::Make<TestHist_t>(HistogramFactory("Compiled"));
+    REQUIRE(compiled);
+
+    nEvaluated = 0;
+    for(auto entry : entries)
+        cuttree::Fill<TestHist_t>(compiled, entry);
+    // each distinct cut at most once per entry
+    REQUIRE(nEvaluated <= entries.size()*6);
+
+    vector<vector<int>> filled;
+    collect(compiled.GetTree(), filled);
+    REQUIRE(filled == expected);
+
+    // nothing below a failed level is evaluated
+    nEvaluated = 0;
+    compiled.Fill(11); // fails Small, Div3 and thus Large
+    REQUIRE(nEvaluated == 5);
+}
+
+void dotest_compiled_block() {
+    gDirectory->Clear();
+
+    vector<int> entries;
+    for(int entry=-20;entry<=80;entry++)
+        entries.push_back(entry);
+
+    const auto expected = fill_recursive(entries);
+
+    cuttree::Compiled_t<TestHist_t> compiled(cuttree::Make<TestHist_t>(HistogramFactory("Compiled")));
+    nEvaluated = 0;
+    compiled.Fill(entries.begin(), entries.end());
+    REQUIRE(nEvaluated <= entries.size()*6);
+
+    vector<vector<int>> filled;
+    collect(compiled.GetTree(), filled);
+    REQUIRE(filled == expected);
+}
@@ -1,14 +1,22 @@
 #include "catch.hpp"
 
 #include "analysis/plot/HistogramFactory.h"
+#include "analysis/plot/FastHistogram.h"
+#include "root-addons/analysis_codes/hstack.h"
 #include "base/WrapTFile.h"
 #include "base/tmpfile_t.h"
+#include "base/std_ext/math.h"
+#include "base/std_ext/string.h"
 
 #include "TH1D.h"
 #include "TH2D.h"
 #include "TH3D.h"
 #include "TGraph.h"
 #include "TTree.h"
+#include "TRandom3.h"
+
+#include <sstream>
+#include <thread>
 
 using namespace std;
 using namespace ant;
@@ -17,6 +25,9 @@ using namespace ant::analysis;
 void dotest_make();
 void dotest_nameclash();
 void dotest_numdir();
+void dotest_fast();
+void dotest_fast_threads();
+void dotest_merge();
 
 
 TEST_CASE("HistogramFactory: Make", "[analysis]") {
@@ -32,6 +43,18 @@ TEST_CASE("HistogramFactory: Numbered directories", "[analysis]") {
     dotest_numdir();
 }
 
+TEST_CASE("HistogramFactory: Fast histograms", "[analysis]") {
+    dotest_fast();
+}
+
+TEST_CASE("HistogramFactory: Fast histograms from threads", "[analysis]") {
+    dotest_fast_threads();
+}
+
+TEST_CASE("HistogramFactory: Merge objects", "[analysis]") {
+    dotest_merge();
+}
+
 
 void dotest_make() {
     gDirectory->Clear();
@@ -88,3 +111,214 @@ void dotest_numdir() {
     // back in old dir
     REQUIRE(dynamic_cast<TDirectory*>(gDirectory->FindObject("Test_2")));
 }
+
+void compare_hists(const TH1* fast, const TH1* ref) {
+    REQUIRE(fast->GetNcells() == ref->GetNcells());
+    for(int bin=0;bin<ref->GetNcells();bin++) {
+        REQUIRE(fast->GetBinContent(bin) == ref->GetBinContent(bin));
+        REQUIRE(fast->GetBinError(bin) == Approx(ref->GetBinError(bin)));
+    }
+    CHECK(fast->GetEntries() == ref->GetEntries());
+    CHECK(fast->GetMean(1) == Approx(ref->GetMean(1)));
+    CHECK(fast->GetRMS(1) == Approx(ref->GetRMS(1)));
+    CHECK(fast->GetMean(2) == Approx(ref->GetMean(2)));
+    CHECK(fast->GetMean(3) == Approx(ref->GetMean(3)));
+}
+
+void dotest_fast() {
+    gDirectory->Clear();
+
+    HistogramFactory h("Test");
+    HistogramFactory h_sub("SubTest", h);
+
+    const AxisSettings x_axis("x", {100, -2, 2});
+    const AxisSettings y_axis("y", {10, -1, 1});
+    const AxisSettings z_axis("z", {5});
+
+    auto fast1 = h.makeFastTH1D("fast1", x_axis);
+    auto ref1  = h.makeTH1D("ref1", x_axis);
+    auto fast2 = h_sub.makeFastTH2D("fast2", x_axis, y_axis);
+    auto ref2  = h_sub.makeTH2D("ref2", x_axis, y_axis);
+    auto fast3 = h.makeFastTH3D("fast3", x_axis, y_axis, z_axis, "", true);
+    auto ref3  = h.makeTH3D("ref3", x_axis, y_axis, z_axis, "", true);
+
+    REQUIRE(fast1->Get()->GetEntries() == 0);
+
+    TRandom3 rng(42);
+    std::vector<double> xs, ys;
+    for(int i=0;i<10000;i++) {
+        const double x = rng.Gaus(0, 1);
+        const double y = rng.Uniform(-1.1, 1.1);
+        const double z = rng.Uniform(-0.5, 5.5);
+        const double w = rng.Uniform(0.5, 1.5);
+        fast1->Fill(x);
+        ref1->Fill(x);
+        xs.push_back(x);
+        ys.push_back(y);
+        fast3->Fill(x, y, z, w);
+        ref3->Fill(x, y, z, w);
+    }
+    // also NaN goes to overflow
+    fast1->Fill(std_ext::NaN);
+    ref1->Fill(std_ext::NaN);
+
+    fast2->Fill(xs, ys);
+    for(size_t i=0;i<xs.size();i++)
+        ref2->Fill(xs[i], ys[i]);
+
+    h.MaterializeFastHistograms();
+
+    compare_hists(fast1->Get(), ref1);
+    compare_hists(fast2->Get(), ref2);
+    compare_hists(fast3->Get(), ref3);
+
+    // materializing again does not change anything
+    h_sub.MaterializeFastHistograms();
+    compare_hists(fast2->Get(), ref2);
+
+    // but filling afterwards adds up
+    fast2->Fill(0.5, 0.5, 2.0);
+    ref2->Fill(0.5, 0.5, 2.0);
+    h.MaterializeFastHistograms();
+    compare_hists(fast2->Get(), ref2);
+}
+
+void dotest_fast_threads() {
+    gDirectory->Clear();
+
+    HistogramFactory h("Test");
+    const AxisSettings x_axis("x", {50, 0, 50});
+    auto fast = h.makeFastTH1D("fast", x_axis);
+    auto ref  = h.makeTH1D("ref", x_axis);
+
+    const unsigned nThreads = 4;
+    const int nFills = 1000;
+    std::vector<std::thread> threads;
+    for(unsigned t=0;t<nThreads;t++) {
+        threads.emplace_back([fast] () {
+            for(int i=0;i<nFills;i++)
+                fast->Fill(i % 60);
+        });
+        for(int i=0;i<nFills;i++)
+            ref->Fill(i % 60);
+    }
+    for(auto& t : threads)
+        t.join();
+
+    h.MaterializeFastHistograms();
+    compare_hists(fast->Get(), ref);
+
+    // finished threads give back their shard, so more threads in total
+    // than FastTH1D::MaxThreads can fill
+    for(unsigned t=0;t<2*FastTH1D::MaxThreads;t++) {
+        thread([fast] () { fast->Fill(1.5); }).join();
+        ref->Fill(1.5);
+    }
+    h.MaterializeFastHistograms();
+    compare_hists(fast->Get(), ref);
+}
+
+void dotest_merge() {
+    gDirectory->Clear();
+
+    struct objects_t {
+        HistogramFactory h;
+        HistogramFactory h_sub;
+        TH1D* h1;
+        FastTH1D* fast;
+        TGraph* graph;
+        TTree* tree;
+        double x = 0;
+        objects_t(TDirectory* root) :
+            h("Test", root), h_sub("SubTest", h),
+            h1(h.makeTH1D("h1", {"x", {10, 0, 10}})),
+            fast(h_sub.makeFastTH1D("fast", {"x", {10, 0, 10}})),
+            graph(h_sub.makeGraph("graph")),
+            tree(h.makeTTree("tree"))
+        {
+            tree->Branch("x", addressof(x));
+        }
+        void fill(double x_) {
+            x = x_;
+            h1->Fill(x);
+            fast->Fill(x);
+            graph->SetPoint(graph->GetN(), x, x);
+            tree->Fill();
+        }
+    };
+
+    objects_t merged(gDirectory->mkdir("merged"));
+    objects_t shard(gDirectory->mkdir("shard"));
+
+    merged.fill(1);
+    shard.fill(2);
+    // the shard only contributes what's filled after reset
+    shard.h.ResetObjects();
+    REQUIRE(shard.h1->GetEntries() == 0);
+    REQUIRE(shard.fast->Get()->GetEntries() == 0);
+    REQUIRE(shard.graph->GetN() == 0);
+    REQUIRE(shard.tree->GetEntries() == 0);
+
+    shard.fill(3);
+    shard.fill(4);
+    merged.h.MergeObjects(shard.h);
+    merged.h.MaterializeFastHistograms();
+
+    REQUIRE(merged.h1->GetEntries() == 3);
+    REQUIRE(merged.h1->GetBinContent(merged.h1->FindBin(2)) == 0);
+    REQUIRE(merged.h1->GetBinContent(merged.h1->FindBin(4)) == 1);
+    REQUIRE(merged.fast->Get()->GetEntries() == 3);
+    REQUIRE(merged.graph->GetN() == 3);
+    REQUIRE(merged.tree->GetEntries() == 3);
+
+    // objects only made by the shard, like lazily created ones, are copied
+    objects_t shard_lazy(gDirectory->mkdir("shard_lazy"));
+    shard_lazy.h.ResetObjects();
+    shard_lazy.fill(5);
+    HistogramFactory lazy("Lazy", shard_lazy.h);
+    auto h_lazy = lazy.makeTH1D("lazy", {"x", {10, 0, 10}});
+    h_lazy->Fill(5);
+    lazy.makeGraph("graph_lazy", "graph_lazy")->SetPoint(0, 5, 5);
+
+    // stacks are merged after the histograms they refer to
+    *merged.h.make<hstack>("stack") << merged.h1;
+    *shard_lazy.h.make<hstack>("stack") << shard_lazy.h1 << h_lazy;
+    *shard_lazy.h.make<hstack>("stack_lazy") << h_lazy;
+
+    merged.h.MergeObjects(shard_lazy.h);
+
+    auto merged_dir = merged.h1->GetDirectory();
+    REQUIRE(merged.h1->GetEntries() == 4);
+    auto merged_lazy = dynamic_cast<TH1D*>(merged_dir->Get("Lazy/lazy"));
+    REQUIRE(merged_lazy);
+    REQUIRE(merged_lazy != h_lazy);
+    REQUIRE(merged_lazy->GetEntries() == 1);
+    auto merged_graph_lazy = dynamic_cast<TGraph*>(merged_dir->Get("Lazy/graph_lazy"));
+    REQUIRE(merged_graph_lazy);
+    REQUIRE(merged_graph_lazy->GetN() == 1);
+
+    auto print_stack = [] (TObject* obj) {
+        auto s = dynamic_cast<hstack*>(obj);
+        REQUIRE(s);
+        stringstream ss;
+        ss << *s;
+        return ss.str();
+    };
+    for(auto stackname : {"stack", "stack_lazy"}) {
+        INFO("stack=" << stackname);
+        const auto stack = print_stack(merged_dir->Get(stackname));
+        REQUIRE(std_ext::contains(stack, "/merged/Test/Lazy/lazy"));
+        REQUIRE_FALSE(std_ext::contains(stack, "shard_lazy"));
+    }
+    REQUIRE(std_ext::contains(print_stack(merged_dir->Get("stack")), "/merged/Test/h1"));
+
+    // objects are matched by name
+    HistogramFactory other("Test", gDirectory->mkdir("other"));
+    other.makeTH1D("other", {"x", {10, 0, 10}});
+    REQUIRE_NOTHROW(merged.h.MergeObjects(other));
+    REQUIRE(dynamic_cast<TH1D*>(merged_dir->Get("other")));
+
+    HistogramFactory mismatch("Test", gDirectory->mkdir("mismatch"));
+    mismatch.makeGraph("h1", "h1");
+    REQUIRE_THROWS_AS(merged.h.MergeObjects(mismatch), HistogramFactory::Exception);
+}
@@ -0,0 +1,99 @@
+#include "catch.hpp"
+
+#include "analysis/utils/MCSmear.h"
+
+#include "base/std_ext/math.h"
+#include "base/std_ext/memory.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+void dotest_batch();
+void dotest_eventnumber();
+
+TEST_CASE("MCSmear: Batch", "[analysis]") {
+    dotest_batch();
+}
+
+TEST_CASE("MCSmear: Event number", "[analysis]") {
+    dotest_eventnumber();
+}
+
+struct ConstantUncertaintyModel : utils::UncertaintyModel {
+    virtual utils::Uncertainties_t GetSigmas(const TParticle&) const override {
+        return {10.0, 0.01, 0.02};
+    }
+    virtual double GetBeamEnergySigma(double) const override {
+        return 5.0;
+    }
+};
+
+void dotest_batch() {
+    const size_t n = 100000;
+    utils::MCSmear::particles_t particles;
+    particles.resize(n);
+    for(size_t i=0;i<n;i++) {
+        particles.Ek[i] = 100;
+        particles.Theta[i] = 1;
+        particles.Phi[i] = 2;
+        particles.sigmaEk[i] = 10;
+        particles.sigmaTheta[i] = 0.5;
+        particles.sigmaPhi[i] = 0; // zero sigma leaves the value untouched
+    }
+
+    CounterRNG rng(42, 7);
+    utils::MCSmear::Smear(particles, rng);
+
+    std_ext::RMS Ek;
+    std_ext::RMS Theta;
+    for(size_t i=0;i<n;i++) {
+        Ek.Add(particles.Ek[i]);
+        Theta.Add(particles.Theta[i]);
+        REQUIRE(particles.Phi[i] == 2);
+    }
+    CHECK(Ek.GetMean() == Approx(100).epsilon(1e-3));
+    CHECK(Ek.GetRMS() == Approx(10).epsilon(1e-2));
+    CHECK(Theta.GetMean() == Approx(1).epsilon(1e-3));
+    CHECK(Theta.GetRMS() == Approx(0.5).epsilon(1e-2));
+
+    // Ek and Theta got independent deviates
+    double cov = 0;
+    for(size_t i=0;i<n;i++)
+        cov += (particles.Ek[i]-Ek.GetMean())*(particles.Theta[i]-Theta.GetMean());
+    CHECK(cov/n/(Ek.GetRMS()*Theta.GetRMS()) == Approx(0).margin(0.02));
+}
+
+void dotest_eventnumber() {
+    auto model = make_shared<ConstantUncertaintyModel>();
+    utils::MCSmear smear(model, 42);
+
+    const TParticleList particles{
+        make_shared<TParticle>(ParticleTypeDatabase::BeamProton,
+                               LorentzVec::EPThetaPhi(1000+ParticleTypeDatabase::Proton.Mass(), 1000, 0, 0)),
+        make_shared<TParticle>(ParticleTypeDatabase::Photon, 200, 1, 2),
+        make_shared<TParticle>(ParticleTypeDatabase::Proton, 300, 0.5, -1)
+    };
+
+    // reproducible per event number, independent of the order of processing
+    const auto event1 = smear.Smear(particles, 1);
+    const auto event2 = smear.Smear(particles, 2);
+    const auto event1_again = smear.Smear(particles, 1);
+    REQUIRE(event1.size() == particles.size());
+    for(size_t i=0;i<particles.size();i++) {
+        REQUIRE(event1[i]->Type() == particles[i]->Type());
+        CHECK(event1[i]->Ek() == event1_again[i]->Ek());
+        CHECK(event1[i]->Theta() == event1_again[i]->Theta());
+        CHECK(event1[i]->Ek() != event2[i]->Ek());
+        CHECK(event1[i]->Ek() != particles[i]->Ek());
+    }
+
+    // another key gives other numbers
+    utils::MCSmear smear_other(model, 43);
+    CHECK(smear_other.Smear(particles, 1).back()->Ek() != event1.back()->Ek());
+
+    // only the photon energy of the beam is smeared
+    const auto& beam = event1.front();
+    CHECK(beam->Theta() == particles.front()->Theta());
+    CHECK(beam->E == Approx(beam->Ek() + ParticleTypeDatabase::BeamProton.Mass()));
+}
@@ -2,12 +2,16 @@
 
 #include "base/ParticleType.h"
 #include "analysis/utils/ParticleID.h"
+#include "analysis/utils/ParticleTools.h"
+#include "analysis/utils/PolygonCut.h"
 #include "analysis/utils/RootAddons.h"
 
 #include "TCutG.h"
 
 #include <cassert>
 #include <iostream>
+#include <random>
+#include <limits>
 
 
 using namespace std;
@@ -35,6 +39,9 @@ void test_electoncut();
 void test_electonantprotoncut();
 void test_tof();
 void test_tofdee();
+void test_polygoncut();
+void test_compiled();
+void test_typelist_process();
 
 
 struct testdata {
@@ -75,6 +82,18 @@ TEST_CASE("ParticleID: tof + dEE cut", "[analysis]") {
     test_tofdee();
 }
 
+TEST_CASE("ParticleID: PolygonCut", "[analysis]") {
+    test_polygoncut();
+}
+
+TEST_CASE("ParticleID: compiled cuts", "[analysis]") {
+    test_compiled();
+}
+
+TEST_CASE("ParticleID: ParticleTypeList uses Process", "[analysis]") {
+    test_typelist_process();
+}
+
 void test_makeTCutG() {
     auto cut = root::makeTCutG("a", {{1,1},{3,1},{3,3},{1,3}});
     REQUIRE(cut->IsInside(2,2));
@@ -155,6 +174,107 @@ void test_tofdee() {
 }
 
 
+void test_polygoncut() {
+    // compare with TCutG on random points, some of them on vertices
+    auto cutg = root::makeTCutG("polygon", {{50,4},{300,4},{120,8},{51,16},{20,10}});
+    const PolygonCut cut(*cutg);
+    REQUIRE(cut.GetNPoints() == static_cast<size_t>(cutg->GetN()));
+
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<double> x_dist(0, 350);
+    std::uniform_real_distribution<double> y_dist(0, 20);
+    for(int i=0;i<100000;i++) {
+        double x = x_dist(rng);
+        double y = y_dist(rng);
+        if(i % 10 == 0)
+            y = cutg->GetY()[i % cutg->GetN()];
+        INFO("x=" << x << " y=" << y);
+        REQUIRE(cut.IsInside(x, y) == static_cast<bool>(cutg->IsInside(x, y)));
+    }
+
+    REQUIRE_FALSE(cut.IsInside(std::numeric_limits<double>::quiet_NaN(), 5));
+
+    std::vector<double> xs{100, 100, 400};
+    std::vector<double> ys{5, 15, 5};
+    std::vector<std::uint8_t> result;
+    cut.IsInside(xs, ys, result);
+    REQUIRE(result.size() == 3);
+    for(size_t i=0;i<xs.size();i++)
+        REQUIRE(static_cast<bool>(result[i]) == static_cast<bool>(cutg->IsInside(xs[i], ys[i])));
+}
+
+void test_compiled() {
+    BasicParticleID pid;
+    pid.dEE_electron = data.dEE_electron;
+    pid.dEE_proton = data.dEE_proton;
+    pid.tof = data.tofcut;
+    pid.Compile();
+
+    REQUIRE(pid.Identify(data.gamma)   == &ParticleTypeDatabase::Photon);
+    REQUIRE(pid.Identify(data.proton)  == &ParticleTypeDatabase::Proton);
+    REQUIRE(pid.Identify(data.neutron) == &ParticleTypeDatabase::Neutron);
+    REQUIRE(pid.Identify(data.electron)== &ParticleTypeDatabase::eCharged);
+
+    const TCandidatePtrList cands{data.gamma, data.proton, data.neutron, data.electron};
+    ParticleID::types_t types;
+    pid.IdentifyAll(cands, types);
+    REQUIRE(types.size() == cands.size());
+    for(size_t i=0;i<cands.size();i++)
+        REQUIRE(types[i] == pid.Identify(cands[i]));
+
+    // changing a cut after compiling falls back to the TCutG
+    pid.tof = nullptr;
+    REQUIRE(pid.Identify(data.neutron) == &ParticleTypeDatabase::Photon);
+    pid.IdentifyAll(cands, types);
+    REQUIRE(types[2] == &ParticleTypeDatabase::Photon);
+}
+
+// drops everything but photons in Process, and thus in ProcessAll
+struct PhotonsOnlyParticleID : SimpleParticleID {
+    virtual TParticlePtr Process(const TCandidatePtr& cand) const override {
+        auto particle = SimpleParticleID::Process(cand);
+        if(particle && particle->Type() == ParticleTypeDatabase::Photon)
+            return particle;
+        return nullptr;
+    }
+    virtual void ProcessAll(const TCandidatePtrList& cands, particles_t& particles) const override {
+        particles.clear();
+        for(const auto& cand : cands)
+            particles.emplace_back(Process(cand));
+    }
+};
+
+// counts the batch identifications
+struct CountingParticleID : SimpleParticleID {
+    mutable unsigned nIdentifyAll = 0;
+    virtual void IdentifyAll(const TCandidatePtrList& cands, types_t& types) const override {
+        nIdentifyAll++;
+        SimpleParticleID::IdentifyAll(cands, types);
+    }
+};
+
+void test_typelist_process() {
+    TCandidateList cands;
+    cands.emplace_back(Detector_t::Type_t::CB, 100, 0, 0, 0, 1, 0.0, 0, TClusterList{});
+    cands.emplace_back(Detector_t::Type_t::CB, 200, 0, 0, 0, 1, 1.0, 0, TClusterList{});
+
+    const auto simple = ParticleTypeList::Make(cands, SimpleParticleID());
+    REQUIRE(simple.GetAll().size() == 2);
+    REQUIRE(simple.Get(ParticleTypeDatabase::Proton).size() == 1);
+
+    // all candidates are identified in one batch
+    CountingParticleID counting;
+    const auto counted = ParticleTypeList::Make(cands, counting);
+    REQUIRE(counting.nIdentifyAll == 1);
+    REQUIRE(counted.GetAll().size() == 2);
+    REQUIRE(counted.Get(ParticleTypeDatabase::Proton).size() == 1);
+
+    // overriding ProcessAll changes the result of ParticleTypeList::Make
+    const auto photons = ParticleTypeList::Make(cands, PhotonsOnlyParticleID());
+    REQUIRE(photons.GetAll().size() == 1);
+    REQUIRE(photons.Get(ParticleTypeDatabase::Photon).size() == 1);
+    REQUIRE(photons.Get(ParticleTypeDatabase::Proton).empty());
+}
 
 
 testdata::testdata()
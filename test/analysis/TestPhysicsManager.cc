@@ -6,6 +6,8 @@
 #include "analysis/input/ant/AntReader.h"
 #include "analysis/input/pluto/PlutoReader.h"
 #include "analysis/input/goat/GoatReader.h"
+#include "analysis/input/ant/EventIndex.h"
+#include "analysis/input/event_t.h"
 
 #include "analysis/utils/Uncertainties.h"
 #include "analysis/utils/ParticleTools.h"
@@ -28,7 +30,7 @@ using namespace std;
 using namespace ant;
 using namespace ant::analysis;
 
-void dotest_raw();
+void dotest_raw(unsigned writerThreads);
 void dotest_raw_nowrite();
 void dotest_plutogeant(bool insertGoat, bool checktaggerhits = false);
 void dotest_pluto(bool insertGoat);
@@ -36,7 +38,12 @@ void dotest_runall();
 
 TEST_CASE("PhysicsManager: Raw Input", "[analysis]") {
     test::EnsureSetup();
-    dotest_raw();
+    dotest_raw(0);
+}
+
+TEST_CASE("PhysicsManager: Raw Input with background writer", "[analysis]") {
+    test::EnsureSetup();
+    dotest_raw(2);
 }
 
 TEST_CASE("PhysicsManager: Raw Input without TEvent writing", "[analysis]") {
@@ -86,13 +93,16 @@ struct TestPhysics : Physics
     unsigned seenMCTrue = 0;
     unsigned seenTrueTargetPos = 0;
     unsigned seenReconTargetPosNaN = 0;
+    const TEventData::collections_t collections;
 
 
 
-    TestPhysics(bool nowrite_ = false, bool checktaggerhits_ = false) :
+    TestPhysics(bool nowrite_ = false, bool checktaggerhits_ = false,
+                TEventData::collections_t collections_ = ~TEventData::collections_t()) :
         Physics("TestPhysics", nullptr),
         nowrite(nowrite_),
-        checktaggerhits(checktaggerhits_)
+        checktaggerhits(checktaggerhits_),
+        collections(collections_)
     {
         HistFac.makeTH1D("test","test","test",BinSettings(10));
     }
@@ -124,6 +134,10 @@ struct TestPhysics : Physics
             }
         }
     }
+    virtual TEventData::collections_t GetCollections() const override
+    {
+        return collections;
+    }
     virtual void Finish() override
     {
         finishCalled = true;
@@ -147,7 +161,7 @@ struct PhysicsManagerTester : PhysicsManager
     }
 };
 
-void dotest_raw()
+void dotest_raw(unsigned writerThreads)
 {
     const unsigned expectedEvents = 221;
 
@@ -156,6 +170,10 @@ void dotest_raw()
     // write out some file
     {
         WrapTFileOutput outfile(tmpfile.filename, true);
+        PhysicsManager::WriterThreads = writerThreads;
+        std_ext::execute_on_destroy reset_writerthreads([] () {
+            PhysicsManager::WriterThreads = 0;
+        });
         PhysicsManagerTester pm;
         pm.AddPhysics<TestPhysics>();
 
@@ -183,6 +201,38 @@ void dotest_raw()
         auto tree = outfile.GetSharedClone<TTree>("treeEvents");
         REQUIRE(tree != nullptr);
         REQUIRE(tree->GetEntries() == expectedEvents/3);
+
+        auto index = outfile.GetSharedClone<TTree>(input::EventIndex::TreeName);
+        REQUIRE(index != nullptr);
+        REQUIRE(index->GetEntries() == tree->GetEntries());
+    }
+
+    // read with selection on index
+    {
+        auto inputfiles = make_shared<WrapTFileInput>(tmpfile.filename);
+
+        unsigned nExpected = 0;
+        {
+            input::AntReader reader(inputfiles, nullptr, nullptr);
+            input::event_t event;
+            while(reader.ReadNextEvent(event))
+                nExpected += event.Reconstructed().Candidates.size() >= 5;
+        }
+        REQUIRE(nExpected > 0);
+        REQUIRE(nExpected < expectedEvents/3);
+
+        input::AntReader reader(inputfiles, nullptr, nullptr);
+        reader.SetSelection("nCandidates>=5");
+        unsigned nSelected = 0;
+        input::event_t event;
+        while(reader.ReadNextEvent(event)) {
+            REQUIRE(event.Reconstructed().Candidates.size() >= 5);
+            nSelected++;
+        }
+        REQUIRE(nSelected == nExpected);
+
+        input::AntReader reader_invalid(inputfiles, nullptr, nullptr);
+        REQUIRE_THROWS_AS(reader_invalid.SetSelection("nonExistingBranch>1"), input::AntReader::Exception);
     }
 
     // read in file with AntReader
@@ -236,6 +286,29 @@ void dotest_raw()
 
     }
 
+    // lazily read collections are decoded if any physics class reads them
+    for(auto readCandidates : {true, false}) {
+        auto inputfiles = make_shared<WrapTFileInput>(tmpfile.filename);
+
+        PhysicsManagerTester pm;
+        using C = TEventData::Collection_t;
+        pm.AddPhysics<TestPhysics>(false, false, readCandidates ?
+                                       ~TEventData::collections_t() :
+                                       TEventData::collections_t(C::TaggerHits));
+
+        auto reader = std_ext::make_unique<input::AntReader>(inputfiles, nullptr, nullptr);
+        reader->SetLazyCollections(C::Candidates | TEventData::collections_t(C::DetectorReadHits));
+        list< unique_ptr<analysis::input::DataReader> > readers;
+        readers.emplace_back(move(reader));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+
+        std::shared_ptr<TestPhysics> physics = pm.GetTestPhysicsModule();
+
+        INFO("readCandidates=" << readCandidates);
+        REQUIRE(physics->seenEvents == expectedEvents/3);
+        REQUIRE(physics->seenCandidates == (readCandidates ? 286 : 0));
+    }
+
 }
 
 void dotest_raw_nowrite()
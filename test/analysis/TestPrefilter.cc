@@ -0,0 +1,36 @@
+#include "catch.hpp"
+
+#include "analysis/input/Prefilter.h"
+
+#include "tree/TEventData.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis::input;
+
+void dotest_multiplicity();
+
+TEST_CASE("Prefilter: Multiplicity", "[analysis]") {
+    dotest_multiplicity();
+}
+
+void dotest_multiplicity() {
+    TEventData recon(TID(0, 0, {TID::Flags_t::MC}));
+    auto add_hit = [&recon] (Detector_t::Type_t d, Channel_t::Type_t c, unsigned ch) {
+        recon.DetectorReadHits.emplace_back(LogicalChannel_t{d, c, ch}, TDetectorReadHit::Value_t{1.0});
+    };
+    add_hit(Detector_t::Type_t::CB,   Channel_t::Type_t::Integral, 1);
+    add_hit(Detector_t::Type_t::CB,   Channel_t::Type_t::Integral, 2);
+    add_hit(Detector_t::Type_t::CB,   Channel_t::Type_t::Timing,   2);
+    add_hit(Detector_t::Type_t::TAPS, Channel_t::Type_t::Integral, 3);
+    add_hit(Detector_t::Type_t::EPT,  Channel_t::Type_t::Timing,   4);
+
+    const PrefilterEvent event(recon);
+    CHECK(event.IsMC());
+    CHECK(event.GetReadHits().size() == 5);
+    CHECK(event.GetMultiplicity(Detector_t::Type_t::CB, Channel_t::Type_t::Integral) == 2);
+    CHECK(event.GetMultiplicity(Detector_t::Type_t::CB, Channel_t::Type_t::Timing) == 1);
+    CHECK(event.GetMultiplicity(Detector_t::Any_t::Calo, Channel_t::Type_t::Integral) == 3);
+    CHECK(event.GetMultiplicity(Detector_t::Type_t::EPT, Channel_t::Type_t::Timing) == 1);
+    CHECK(event.GetMultiplicity(Detector_t::Type_t::PID, Channel_t::Type_t::Integral) == 0);
+}
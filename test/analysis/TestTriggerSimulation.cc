@@ -0,0 +1,89 @@
+#include "catch.hpp"
+
+#include "analysis/utils/TriggerSimulation.h"
+
+#include "tree/TEventData.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+using config_t = expconfig::Setup_traits::triggersimu_config_t;
+
+void dotest_esum();
+void dotest_multiplicity();
+
+TEST_CASE("TriggerSimulation: Energy sum", "[analysis]") {
+    dotest_esum();
+}
+
+TEST_CASE("TriggerSimulation: Multiplicity", "[analysis]") {
+    dotest_multiplicity();
+}
+
+void add_hit(TEventData& recon, Detector_t::Type_t det, Channel_t::Type_t type, unsigned ch, double value) {
+    recon.DetectorReadHits.emplace_back(LogicalChannel_t{det, type, ch},
+                                        TDetectorReadHit::Value_t{value});
+}
+
+void dotest_esum() {
+    config_t config;
+    config.CBESum_MissingElements = {3};
+    utils::TriggerSimulation triggersimu(config);
+
+    TEventData recon(TID(0, 0));
+    add_hit(recon, Detector_t::Type_t::CB,   Channel_t::Type_t::Integral, 1, 100.0);
+    add_hit(recon, Detector_t::Type_t::CB,   Channel_t::Type_t::Integral, 1,  20.0);
+    add_hit(recon, Detector_t::Type_t::CB,   Channel_t::Type_t::Timing,   2, 500.0);
+    add_hit(recon, Detector_t::Type_t::CB,   Channel_t::Type_t::Integral, 3, 300.0); // missing in sum
+    add_hit(recon, Detector_t::Type_t::TAPS, Channel_t::Type_t::Integral, 4, 400.0);
+    add_hit(recon, Detector_t::Type_t::CB,   Channel_t::Type_t::Integral, 700, 5.0);
+
+    REQUIRE(triggersimu.ProcessReadHits(recon));
+    CHECK(triggersimu.GetCBEnergySum() == Approx(125.0));
+    CHECK(triggersimu.HasTriggered()); // data always triggered
+    CHECK(triggersimu.GetCBMultiplicity() == 0); // not configured
+
+    // dense energies must be reset for next event
+    TEventData empty(TID(0, 1));
+    REQUIRE(triggersimu.ProcessReadHits(empty));
+    CHECK(triggersimu.GetCBEnergySum() == 0.0);
+
+    // the partial sums add in a different order than a plain loop,
+    // so compare only approximately
+    TEventData many(TID(0, 2));
+    double expected = 0;
+    for(unsigned ch=0;ch<100;ch++) {
+        add_hit(many, Detector_t::Type_t::CB, Channel_t::Type_t::Integral, ch, 0.1*ch);
+        if(ch != 3)
+            expected += 0.1*ch;
+    }
+    REQUIRE(triggersimu.ProcessReadHits(many));
+    CHECK(triggersimu.GetCBEnergySum() == Approx(expected));
+}
+
+void dotest_multiplicity() {
+    config_t config;
+    config.Type = config_t::Type_t::CBESum;
+    config.CBESum_Edge = 0;
+    config.CBESum_Width = 0.1;
+    config.CB_SectorSize = 16;
+    config.CB_SectorThreshold = 30;
+    config.CB_MinMultiplicity = 2;
+    utils::TriggerSimulation triggersimu(config);
+
+    TEventData recon(TID(0, 0, {TID::Flags_t::MC}));
+    add_hit(recon, Detector_t::Type_t::CB, Channel_t::Type_t::Integral,  0, 20.0);
+    add_hit(recon, Detector_t::Type_t::CB, Channel_t::Type_t::Integral, 15, 20.0); // same sector as 0
+    add_hit(recon, Detector_t::Type_t::CB, Channel_t::Type_t::Integral, 16, 20.0); // below threshold
+
+    REQUIRE(triggersimu.ProcessReadHits(recon));
+    CHECK(triggersimu.GetCBMultiplicity() == 1);
+    CHECK_FALSE(triggersimu.HasTriggered());
+
+    add_hit(recon, Detector_t::Type_t::CB, Channel_t::Type_t::Integral, 719, 50.0);
+    REQUIRE(triggersimu.ProcessReadHits(recon));
+    CHECK(triggersimu.GetCBMultiplicity() == 2);
+    CHECK(triggersimu.GetCBEnergySum() == Approx(110.0));
+    CHECK(triggersimu.HasTriggered());
+}
@@ -0,0 +1,78 @@
+#include "catch.hpp"
+
+#include "base/CounterRNG.h"
+
+#include <vector>
+#include <numeric>
+#include <cmath>
+
+using namespace std;
+using namespace ant;
+
+void dotest_knownanswer();
+void dotest_streams();
+void dotest_gaus();
+
+TEST_CASE("CounterRNG: Known answer", "[base]") {
+    dotest_knownanswer();
+}
+
+TEST_CASE("CounterRNG: Streams", "[base]") {
+    dotest_streams();
+}
+
+TEST_CASE("CounterRNG: Gaus", "[base]") {
+    dotest_gaus();
+}
+
+void dotest_knownanswer() {
+    // Philox4x32-10 with zero key and counter gives 6627e8d5 e169c58d bc57ac4c 9b00dbd8
+    CounterRNG rng(0);
+    CHECK(rng.Next() == 0xbc57ac4c9b00dbd8ULL);
+    CHECK(rng.Next() == 0x6627e8d5e169c58dULL);
+}
+
+void dotest_streams() {
+    CounterRNG rng1(42, 7);
+    CounterRNG rng2(42, 7);
+    vector<uint64_t> numbers;
+    for(int i=0;i<100;i++) {
+        numbers.push_back(rng1.Next());
+        REQUIRE(numbers.back() == rng2.Next());
+    }
+
+    // restarting the stream gives the same numbers again
+    rng1.SetStream(7);
+    for(auto n : numbers)
+        REQUIRE(rng1.Next() == n);
+
+    CounterRNG rng3(42, 8);
+    CounterRNG rng4(43, 7);
+    CHECK(rng3.Next() != numbers.front());
+    CHECK(rng4.Next() != numbers.front());
+
+    for(int i=0;i<1000;i++) {
+        const auto u = rng1.Uniform();
+        REQUIRE(u > 0.0);
+        REQUIRE(u <= 1.0);
+    }
+}
+
+void dotest_gaus() {
+    CounterRNG rng(12345);
+    vector<double> x(100001); // odd size also tests the remainder
+    rng.Gaus(x);
+
+    const double mean = accumulate(x.begin(), x.end(), 0.0)/x.size();
+    double var = 0;
+    for(auto v : x)
+        var += (v-mean)*(v-mean);
+    var /= x.size()-1;
+
+    CHECK(std::fabs(mean) < 0.01);
+    CHECK(var == Approx(1.0).epsilon(0.01));
+
+    rng.SetStream(1);
+    const double y = rng.Gaus(10.0, 0.0);
+    CHECK(y == Approx(10.0));
+}
@@ -0,0 +1,153 @@
+#include "catch.hpp"
+
+#include "base/Instrumentation.h"
+
+#include <atomic>
+#include <thread>
+#include <sstream>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+
+void dotest_basic();
+void dotest_threads();
+void dotest_concurrent_reset();
+
+TEST_CASE("Instrumentation: Basic", "[base]") {
+    dotest_basic();
+}
+
+TEST_CASE("Instrumentation: Threads", "[base]") {
+    dotest_threads();
+}
+
+TEST_CASE("Instrumentation: Concurrent reset", "[base]") {
+    dotest_concurrent_reset();
+}
+
+const Instrumentation::result_t& find_result(const vector<Instrumentation::result_t>& results,
+                                             const string& name) {
+    auto it = find_if(results.begin(), results.end(), [&name] (const Instrumentation::result_t& r) {
+        return r.Name == name;
+    });
+    REQUIRE(it != results.end());
+    return *it;
+}
+
+void dotest_basic() {
+    Instrumentation::Reset();
+
+    const auto stage = Instrumentation::GetStage("Test/Basic");
+    REQUIRE(Instrumentation::GetStage("Test/Basic") == stage);
+    REQUIRE(Instrumentation::GetStage("Test/Other") != stage);
+
+    for(int i=0;i<10;i++) {
+        Instrumentation::ScopedTimer t(stage);
+        Instrumentation::Count(stage, 2);
+    }
+
+    // disabled instrumentation does not account anything
+    Instrumentation::Enabled = false;
+    {
+        Instrumentation::ScopedTimer t(stage);
+        Instrumentation::Count(stage);
+    }
+    Instrumentation::Enabled = true;
+
+    auto results = Instrumentation::GetResults();
+    const auto& r = find_result(results, "Test/Basic");
+    REQUIRE(r.Calls == 10);
+    REQUIRE(r.Counts == 20);
+    REQUIRE(r.Threads == 1);
+    REQUIRE(r.TotalSecs >= 0);
+
+    // unused stages are not reported
+    REQUIRE(none_of(results.begin(), results.end(), [] (const Instrumentation::result_t& r) {
+        return r.Name == "Test/Other";
+    }));
+
+    stringstream ss;
+    Instrumentation::PrintTable(ss);
+    REQUIRE(ss.str().find("Test/Basic") != string::npos);
+
+    Instrumentation::Reset();
+    results = Instrumentation::GetResults();
+    REQUIRE(none_of(results.begin(), results.end(), [] (const Instrumentation::result_t& r) {
+        return r.Name == "Test/Basic";
+    }));
+}
+
+void dotest_threads() {
+    Instrumentation::Reset();
+
+    const auto stage = Instrumentation::GetStage("Test/Threads");
+    const unsigned nThreads = 4;
+    const unsigned nCalls = 1000;
+
+    vector<thread> threads;
+    for(unsigned i=0;i<nThreads;i++) {
+        threads.emplace_back([stage, nCalls] () {
+            for(unsigned j=0;j<nCalls;j++) {
+                Instrumentation::ScopedTimer t(stage);
+                Instrumentation::Count(stage);
+            }
+        });
+    }
+    for(auto& t : threads)
+        t.join();
+
+    const auto results = Instrumentation::GetResults();
+    const auto& r = find_result(results, "Test/Threads");
+    REQUIRE(r.Calls == nThreads*nCalls);
+    REQUIRE(r.Counts == nThreads*nCalls);
+    REQUIRE(r.Threads == nThreads);
+}
+
+void dotest_concurrent_reset() {
+    Instrumentation::Reset();
+
+    const auto stage = Instrumentation::GetStage("Test/ConcurrentReset");
+    const unsigned nThreads = 4;
+
+    atomic<bool> stop{false};
+    atomic<unsigned> nStarted{0};
+    vector<thread> threads;
+    for(unsigned i=0;i<nThreads;i++) {
+        threads.emplace_back([stage, &stop, &nStarted] () {
+            Instrumentation::Count(stage);
+            nStarted++;
+            while(!stop) {
+                Instrumentation::ScopedTimer t(stage);
+                Instrumentation::Count(stage);
+            }
+        });
+    }
+
+    // reset and toggle while the threads account
+    while(nStarted < nThreads)
+        this_thread::yield();
+    for(unsigned i=0;i<100;i++) {
+        Instrumentation::Reset();
+        Instrumentation::Enabled = i % 2 == 0;
+    }
+    Instrumentation::Enabled = true;
+    stop = true;
+    for(auto& t : threads)
+        t.join();
+
+    // nothing accounted after the last reset by now finished threads
+    Instrumentation::Reset();
+    const auto results = Instrumentation::GetResults();
+    REQUIRE(none_of(results.begin(), results.end(), [] (const Instrumentation::result_t& r) {
+        return r.Name == "Test/ConcurrentReset";
+    }));
+
+    // accounting starts from zero again
+    for(unsigned i=0;i<3;i++)
+        Instrumentation::Count(stage);
+    const auto results_after = Instrumentation::GetResults();
+    const auto& r = find_result(results_after, "Test/ConcurrentReset");
+    REQUIRE(r.Counts == 3);
+    REQUIRE(r.Calls == 0);
+}
@@ -6,6 +6,7 @@
 #include "base/std_ext/container.h"
 #include "base/std_ext/system.h"
 #include "base/std_ext/shared_ptr_container.h"
+#include "base/std_ext/array_map.h"
 #include "base/std_ext/math.h"
 
 #include "base/tmpfile_t.h"
@@ -30,8 +31,10 @@ void TestMakeUnique();
 void TestString();
 void TestVector();
 void TestLsFiles();
+void TestMakeDirectories();
 void TestSharedPtrContainer();
 void TestRMSIQR();
+void TestArrayMap();
 
 TEST_CASE("make_unique", "[base/std_ext]") {
     TestMakeUnique();
@@ -49,6 +52,10 @@ TEST_CASE("system lsFiles", "[base/std_ext]") {
     TestLsFiles();
 }
 
+TEST_CASE("system makeDirectories", "[base/std_ext]") {
+    TestMakeDirectories();
+}
+
 TEST_CASE("shared_ptr_container", "[base/std_ext]") {
     TestSharedPtrContainer();
 }
@@ -57,6 +64,10 @@ TEST_CASE("RMS_t and IQR_t", "[base/std_ext]") {
     TestRMSIQR();
 }
 
+TEST_CASE("array_map", "[base/std_ext]") {
+    TestArrayMap();
+}
+
 void TestMakeUnique() {
     std::unique_ptr<MemtestDummy> d;
 
@@ -126,6 +137,22 @@ void TestLsFiles() {
     REQUIRE(files.size()==2);
 }
 
+void TestMakeDirectories() {
+    tmpfolder_t folder;
+
+    // spaces and quotes must not be interpreted by some shell
+    const string path = folder.foldername + "/a b/c'd/e";
+    REQUIRE(std_ext::system::makeDirectories(path));
+    REQUIRE(std_ext::system::path_exists(path));
+    // existing directories are fine, also with trailing slash
+    REQUIRE(std_ext::system::makeDirectories(path+"/"));
+
+    tmpfile_t a(folder, ".tst");
+    a.write_testdata();
+    REQUIRE_FALSE(std_ext::system::makeDirectories(a.filename));
+    REQUIRE_FALSE(std_ext::system::makeDirectories(a.filename+"/sub"));
+}
+
 struct int_t {
     static size_t n_constructed;
     int val;
@@ -269,3 +296,50 @@ void TestRMSIQR() {
         CHECK(iqr.GetMedian()==Approx(2).epsilon(0.01));
     }
 }
+
+void TestArrayMap() {
+    enum class key_t { A, B, C, D };
+    using map_t = std_ext::array_map<key_t, vector<int>, 4>;
+    static_assert(std::is_const<map_t::value_type::first_type>::value, "keys must not be modifiable");
+    map_t m;
+    REQUIRE(m.empty());
+    REQUIRE(m.begin() == m.end());
+
+    m[key_t::C].push_back(3);
+    m.insert(make_pair(key_t::A, vector<int>{1, 2}));
+    REQUIRE(m.size() == 2);
+    REQUIRE(m.count(key_t::B) == 0);
+    REQUIRE(m.find(key_t::B) == m.end());
+    REQUIRE(m.find(key_t::C)->second.front() == 3);
+
+    // inserting present key does not overwrite
+    REQUIRE_FALSE(m.insert(make_pair(key_t::C, vector<int>{4})).second);
+    REQUIRE(m[key_t::C].size() == 1);
+
+    // iterates in key order like std::map
+    vector<key_t> keys;
+    for(const auto& item : m)
+        keys.push_back(item.first);
+    REQUIRE((keys == vector<key_t>{key_t::A, key_t::C}));
+
+    // clearing keeps the capacity
+    const auto capacity = m[key_t::A].capacity();
+    m.clear();
+    REQUIRE(m.empty());
+    REQUIRE(m[key_t::A].empty());
+    REQUIRE(m[key_t::A].capacity() == capacity);
+
+    REQUIRE(m.erase(key_t::A) == 1);
+    REQUIRE(m.erase(key_t::A) == 0);
+    REQUIRE(m.empty());
+
+    // assignment copies the values and keeps the keys
+    m[key_t::D].push_back(4);
+    map_t m2;
+    m2[key_t::B].push_back(2);
+    m2 = m;
+    REQUIRE(m2.size() == 1);
+    REQUIRE(m2.count(key_t::B) == 0);
+    REQUIRE(m2.begin()->first == key_t::D);
+    REQUIRE(m2[key_t::D] == vector<int>{4});
+}
@@ -6,12 +6,14 @@
 #include "base/std_ext/memory.h"
 
 #include "TH1D.h"
+#include "Compression.h"
 
 using namespace std;
 using namespace ant;
 
 void dotest_rw();
 void dotest_r();
+void dotest_compression();
 
 TEST_CASE("WrapTFileInput", "[base]") {
     dotest_r();
@@ -21,6 +23,10 @@ TEST_CASE("WrapTFileOutput", "[base]") {
     dotest_rw();
 }
 
+TEST_CASE("WrapTFileOutput: Compression", "[base]") {
+    dotest_compression();
+}
+
 void dotest_r() {
     WrapTFileInput input;
     REQUIRE_THROWS_AS(input.OpenFile(string(TEST_BLOBS_DIRECTORY)+"/Acqu_headeronly-small.dat.xz"), WrapTFile::ENotARootFile);
@@ -45,3 +51,21 @@ void dotest_rw() {
 }
 
 
+
+void dotest_compression() {
+    REQUIRE(WrapTFileOutput::ParseCompression("zlib") == ROOT::CompressionSettings(ROOT::kZLIB, 1));
+    REQUIRE(WrapTFileOutput::ParseCompression("lzma:8") == ROOT::CompressionSettings(ROOT::kLZMA, 8));
+    REQUIRE_THROWS_AS(WrapTFileOutput::ParseCompression("lzma:0"), std::runtime_error);
+    REQUIRE_THROWS_AS(WrapTFileOutput::ParseCompression("lzma:fast"), std::runtime_error);
+    REQUIRE_THROWS_AS(WrapTFileOutput::ParseCompression("zip"), std::runtime_error);
+
+    tmpfile_t tmp;
+    {
+        WrapTFileOutput outfile(tmp.filename);
+        outfile.SetCompression("lzma:5");
+        auto h = outfile.CreateInside<TH1D>("a","A",10,0,10);
+        h->Fill(3);
+    }
+    WrapTFileInput infile(tmp.filename);
+    REQUIRE(infile.GetListOf<TH1D>().size() == 1);
+}
@@ -22,6 +22,7 @@ void dotest_chain();
 void dotest_opt_branches();
 void dotest_stdarray();
 void dotest_templating();
+void dotest_pruning();
 
 
 TEST_CASE("WrapTTree: Basics", "[base]") {
@@ -56,6 +57,10 @@ TEST_CASE("WrapTTree: templating", "[base]") {
     dotest_templating();
 }
 
+TEST_CASE("WrapTTree: Pruning", "[base]") {
+    dotest_pruning();
+}
+
 
 struct MyTree : WrapTTree {
     ADD_BRANCH_T(bool,           Flag1)        // simple type
@@ -480,3 +485,61 @@ class MyClass {
 void dotest_templating() {
     MyClass<> test;
 }
+
+void dotest_pruning() {
+    tmpfile_t tmpfile;
+
+    const int nEntries = 20;
+    {
+        WrapTFileOutput outputfile(tmpfile.filename);
+
+        MyTree t;
+        t.CreateBranches(outputfile.CreateInside<TTree>("test","test"));
+        for(int entry=0;entry<nEntries;entry++) {
+            t.N1 = entry;
+            t.N2 = 2*entry;
+            t.LV = TLorentzVector(1,2,3,entry);
+            t.Tree->Fill();
+        }
+    }
+
+    // pruning is opt-in, as the TTree may be shared with other readers
+    {
+        WrapTFileInput inputfile(tmpfile.filename);
+        MyTree t;
+        REQUIRE(inputfile.GetObject("test",t.Tree));
+        t.LinkBranches();
+        for(int entry=0;entry<nEntries;entry++)
+            REQUIRE(t.GetEntry(entry) > 0);
+        REQUIRE_FALSE(t.IsPruned());
+        REQUIRE(t.Tree->GetBranchStatus("SomeArray"));
+    }
+
+    const auto prevWarmup = WrapTTree::PruningWarmup;
+    WrapTTree::PruningWarmup = 5;
+
+    WrapTFileInput inputfile(tmpfile.filename);
+    MyTree t;
+    REQUIRE(inputfile.GetObject("test",t.Tree));
+    t.LinkBranches();
+
+    for(int entry=0;entry<nEntries;entry++) {
+        INFO("entry=" << entry);
+        REQUIRE(t.GetEntry(entry) > 0);
+        REQUIRE(t.IsPruned() == (entry >= 5));
+        REQUIRE(t.N1 == unsigned(entry));
+        // access N2 only at the beginning, and LV only late
+        if(entry < 3)
+            REQUIRE(t.N2 == 2*entry);
+        if(entry >= 10)
+            REQUIRE(t.LV().E() == Approx(entry));
+        if(entry == 5)
+            REQUIRE_FALSE(t.Tree->GetBranchStatus("LV"));
+    }
+    REQUIRE(t.Tree->GetBranchStatus("N1"));
+    REQUIRE(t.Tree->GetBranchStatus("N2"));
+    REQUIRE(t.Tree->GetBranchStatus("LV"));
+    REQUIRE_FALSE(t.Tree->GetBranchStatus("SomeArray"));
+
+    WrapTTree::PruningWarmup = prevWarmup;
+}
@@ -0,0 +1,73 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+#include "Benchmark.h"
+
+#include "analysis/physics/PhysicsManager.h"
+#include "analysis/input/ant/AntReader.h"
+
+#include "unpacker/Unpacker.h"
+#include "reconstruct/Reconstruct.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+#include "tree/TCandidate.h"
+
+#include "TH1D.h"
+
+#include <limits>
+#include <list>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+void dobench_ant();
+
+TEST_CASE("Benchmark: Ant raw input", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_ant();
+}
+
+namespace {
+
+struct BenchmarkPhysics : Physics {
+    unsigned& nEvents;
+    TH1D* h_CandidateEnergy;
+
+    BenchmarkPhysics(unsigned& nEvents_) :
+        Physics("BenchmarkPhysics", nullptr),
+        nEvents(nEvents_)
+    {
+        h_CandidateEnergy = HistFac.makeTH1D("CaloEnergy","E / MeV","",BinSettings(100,0,1000));
+    }
+
+    virtual void ProcessEvent(const TEvent& event, physics::manager_t&) override
+    {
+        nEvents++;
+        for(const auto& cand : event.Reconstructed().Candidates)
+            h_CandidateEnergy->Fill(cand.CaloEnergy);
+    }
+};
+
+}
+
+void dobench_ant() {
+    // the full chain as in Ant: unpacker, reconstruct and physics manager
+    unsigned nEvents = 0;
+    benchmark::Measure("Ant/RawInput", "events", [&nEvents] () {
+        const auto nEvents_before = nEvents;
+
+        PhysicsManager pm;
+        pm.AddPhysics<BenchmarkPhysics>(nEvents);
+
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        auto reconstruct = std_ext::make_unique<Reconstruct>();
+        list< unique_ptr<input::DataReader> > readers;
+        readers.emplace_back(std_ext::make_unique<input::AntReader>(nullptr, move(unpacker), move(reconstruct)));
+        pm.ReadFrom(move(readers), numeric_limits<long long>::max());
+
+        return nEvents - nEvents_before;
+    });
+    REQUIRE(nEvents > 0);
+}
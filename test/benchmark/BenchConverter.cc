@@ -0,0 +1,118 @@
+#include "catch.hpp"
+#include "Benchmark.h"
+
+#include "calibration/converters/MultiHit.h"
+#include "calibration/converters/GeSiCa_SADC.h"
+
+#include "tree/TDetectorReadHit.h"
+
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <vector>
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration;
+
+void dobench_converter(const string& name, const Calibration::Converter& converter,
+                       const vector<vector<uint8_t>>& rawDatas);
+
+namespace {
+
+const unsigned nHits = 720;
+const unsigned nEvents = 1000;
+
+// some random 16bit words per hit, with fixed seed
+vector<vector<uint8_t>> make_rawdatas(unsigned nWords) {
+    std::mt19937 rng(42);
+    uniform_int_distribution<uint16_t> d_word(0, 4000);
+    vector<vector<uint8_t>> rawDatas(nHits);
+    for(auto& rawData : rawDatas) {
+        rawData.resize(nWords*sizeof(uint16_t));
+        for(unsigned i=0;i<nWords;i++)
+            reinterpret_cast<uint16_t*>(rawData.data())[i] = d_word(rng);
+    }
+    return rawDatas;
+}
+
+}
+
+TEST_CASE("Benchmark: Converter MultiHit", "[.][benchmark]") {
+    dobench_converter("Converter/MultiHit", converter::MultiHit<uint16_t>(), make_rawdatas(2));
+}
+
+TEST_CASE("Benchmark: Converter GeSiCa_SADC", "[.][benchmark]") {
+    dobench_converter("Converter/GeSiCa_SADC", converter::GeSiCa_SADC(), make_rawdatas(3));
+}
+
+void dobench_converter(const string& name, const Calibration::Converter& converter,
+                       const vector<vector<uint8_t>>& rawDatas)
+{
+    vector<TDetectorReadHit> hits;
+    for(unsigned ch=0;ch<rawDatas.size();ch++)
+        hits.emplace_back(LogicalChannel_t{Detector_t::Type_t::CB, Channel_t::Type_t::Integral, ch},
+                          rawDatas[ch]);
+    Calibration::Converter::hits_t hitrefs(hits.begin(), hits.end());
+
+    // returning a new vector for each hit allocates every time
+    double sum_convert = 0;
+    benchmark::Measure(name+"/Convert", "hits", [&] () {
+        sum_convert = 0;
+        for(unsigned i=0;i<nEvents;i++) {
+            for(const TDetectorReadHit& hit : hits) {
+                for(double v : converter.Convert(hit.RawData))
+                    sum_convert += v;
+            }
+        }
+        return double(nEvents)*hits.size();
+    });
+
+    // reusing the output allocates only until the capacity suffices,
+    // so it must not move between repetitions
+    unsigned nReallocs = 0;
+    const double* last_data = nullptr;
+    auto count_reallocs = [&nReallocs, &last_data] (const vector<double>& v) {
+        if(last_data != nullptr && last_data != v.data())
+            nReallocs++;
+        last_data = v.data();
+    };
+
+    vector<double> values;
+    double sum_convertto = 0;
+    benchmark::Measure(name+"/ConvertTo", "hits", [&] () {
+        sum_convertto = 0;
+        for(unsigned i=0;i<nEvents;i++) {
+            for(const TDetectorReadHit& hit : hits) {
+                values.resize(0);
+                converter.ConvertTo(hit.RawData, values);
+                for(double v : values)
+                    sum_convertto += v;
+            }
+        }
+        count_reallocs(values);
+        return double(nEvents)*hits.size();
+    });
+    REQUIRE(nReallocs == 0);
+
+    Calibration::Converter::batch_t batch;
+    last_data = nullptr;
+    double sum_convertall = 0;
+    benchmark::Measure(name+"/ConvertAll", "hits", [&] () {
+        sum_convertall = 0;
+        for(unsigned i=0;i<nEvents;i++) {
+            converter.ConvertAll(hitrefs, Channel_t::Type_t::Integral, batch);
+            for(double v : batch.Values)
+                sum_convertall += v;
+        }
+        count_reallocs(batch.Values);
+        return double(nEvents)*hits.size();
+    });
+    REQUIRE(nReallocs == 0);
+    REQUIRE(batch.Offsets.size() == hits.size()+1);
+
+    // all variants convert the same values
+    REQUIRE(sum_convert > 0);
+    REQUIRE(sum_convertto/sum_convert == Approx(1.0));
+    REQUIRE(sum_convertall/sum_convert == Approx(1.0));
+}
@@ -0,0 +1,173 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+#include "Benchmark.h"
+
+#include "analysis/input/pluto/PlutoReader.h"
+#include "analysis/utils/fitter/KinFitter.h"
+#include "analysis/utils/fitter/TreeFitter.h"
+#include "analysis/utils/uncertainties/FitterSergey.h"
+#include "analysis/utils/uncertainties/Interpolated.h"
+#include "analysis/utils/MCFakeReconstructed.h"
+#include "analysis/utils/ParticleTools.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+#include "tree/TCandidate.h"
+
+#include "base/WrapTFile.h"
+#include "base/tmpfile_t.h"
+#include "base/std_ext/container.h"
+
+#include "TDirectory.h"
+#include "TH2D.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::analysis;
+
+void dobench_kinfitter();
+void dobench_treefitter();
+void dobench_interpolated();
+
+TEST_CASE("Benchmark: KinFitter", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_kinfitter();
+}
+
+TEST_CASE("Benchmark: TreeFitter", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_treefitter();
+}
+
+TEST_CASE("Benchmark: Interpolated::GetSigmas", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_interpolated();
+}
+
+namespace {
+
+struct fitevent_t {
+    double EBeam;
+    TParticlePtr Proton;
+    TParticleList Photons;
+};
+
+// read the Pluto events and fake the reconstructed particles once,
+// such that only the fitting is measured
+vector<fitevent_t> getFitEvents(const string& blob, unsigned nPhotons) {
+    auto rootfile = make_shared<WrapTFileInput>(string(TEST_BLOBS_DIRECTORY)+"/"+blob);
+    input::PlutoReader reader(rootfile);
+
+    // use mc_fake with complete 4pi (no lost photons)
+    utils::MCFakeReconstructed mc_fake(true);
+
+    vector<fitevent_t> events;
+    while(true) {
+        input::event_t event;
+        if(!reader.ReadNextEvent(event))
+            break;
+        auto particles = mc_fake.Get(event.MCTrue());
+        auto protons = particles.Get(ParticleTypeDatabase::Proton);
+        auto photons = particles.Get(ParticleTypeDatabase::Photon);
+        if(protons.size() != 1 || photons.size() != nPhotons)
+            continue;
+        events.emplace_back(fitevent_t{event.MCTrue().ParticleTree->Get()->Ek(),
+                                       protons.front(), photons});
+    }
+    REQUIRE_FALSE(events.empty());
+    return events;
+}
+
+}
+
+void dobench_kinfitter() {
+    const auto events = getFitEvents("Pluto_Etap2g.root", 2);
+
+    auto model = make_shared<utils::UncertaintyModels::FitterSergey>();
+    utils::KinFitter kinfitter(model, true);
+    kinfitter.SetZVertexSigma(3.0);
+
+    unsigned nFitOk = 0;
+    benchmark::Measure("KinFitter", "fits", [&] () {
+        for(const auto& e : events) {
+            const auto res = kinfitter.DoFit(e.EBeam, e.Proton, e.Photons);
+            nFitOk += res.Status == APLCON::Result_Status_t::Success;
+        }
+        return events.size();
+    });
+    REQUIRE(nFitOk > 0);
+}
+
+void dobench_treefitter() {
+    const auto events = getFitEvents("Pluto_EtapOmegaG.root", 4);
+
+    auto model = make_shared<utils::UncertaintyModels::FitterSergey>();
+    utils::TreeFitter treefitter(
+                ParticleTypeTreeDatabase::Get(ParticleTypeTreeDatabase::Channel::EtaPrime_gOmega_ggPi0_4g),
+                model, true);
+    treefitter.SetZVertexSigma(3.0);
+
+    unsigned nFitOk = 0;
+    benchmark::Measure("TreeFitter", "fits", [&] () {
+        unsigned nFits = 0;
+        for(const auto& e : events) {
+            treefitter.PrepareFits(e.EBeam, e.Proton, e.Photons);
+            APLCON::Result_t res;
+            while(treefitter.NextFit(res)) {
+                nFits++;
+                nFitOk += res.Status == APLCON::Result_Status_t::Success;
+            }
+        }
+        return nFits;
+    });
+    REQUIRE(nFitOk > 0);
+}
+
+void dobench_interpolated() {
+    // write some smooth sigma surfaces, the content does not matter for the timing
+    tmpfile_t tmpfile;
+    {
+        WrapTFileOutput outfile(tmpfile.filename, true);
+        const vector<string> prefixes{"sigma_photon_cb", "sigma_proton_cb", "sigma_photon_taps", "sigma_proton_taps"};
+        const vector<string> names{"sigma_Ek", "sigma_Theta", "sigma_Phi", "sigma_R",
+                                   "sigma_Rxy", "sigma_L", "h_NewShowerDepth"};
+        for(const auto& prefix : prefixes) {
+            auto dir = gDirectory->mkdir(prefix.c_str());
+            dir->cd();
+            for(const auto& name : names) {
+                auto h = new TH2D(name.c_str(), "", 20, -1, 1, 20, 0, 1600);
+                for(int x=1;x<=20;x++)
+                    for(int y=1;y<=20;y++)
+                        h->SetBinContent(x, y, 0.01*(1+x+y));
+            }
+            outfile.cd();
+        }
+    }
+
+    auto model = make_shared<utils::UncertaintyModels::Interpolated>(
+                     make_shared<utils::UncertaintyModels::FitterSergey>());
+    model->LoadSigmas(tmpfile.filename);
+    REQUIRE(model->HasLoadedSigmas());
+
+    // use all particles from the fit events
+    TParticleList particles;
+    for(const auto& e : getFitEvents("Pluto_Etap2g.root", 2)) {
+        particles.push_back(e.Proton);
+        std_ext::concatenate(particles, e.Photons);
+    }
+    particles.erase(remove_if(particles.begin(), particles.end(), [] (const TParticlePtr& p) {
+        return !p->Candidate || !(p->Candidate->Detector & Detector_t::Any_t::Calo);
+    }), particles.end());
+    REQUIRE_FALSE(particles.empty());
+
+    double sum = 0;
+    benchmark::Measure("Interpolated::GetSigmas", "particles", [&] () {
+        for(const auto& p : particles)
+            sum += model->GetSigmas(*p).sigmaEk;
+        return particles.size();
+    });
+    REQUIRE(sum > 0);
+}
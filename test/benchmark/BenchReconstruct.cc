@@ -0,0 +1,195 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+#include "Benchmark.h"
+
+#include "reconstruct/Clustering.h"
+#include "reconstruct/CandidateBuilder.h"
+#include "reconstruct/Reconstruct.h"
+
+#include "expconfig/ExpConfig.h"
+
+#include "tree/TCandidate.h"
+#include "tree/TCluster.h"
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace std;
+using namespace ant;
+using namespace ant::reconstruct;
+
+void dobench_clustering();
+void dobench_candidatebuilder();
+
+TEST_CASE("Benchmark: Clustering_NextGen", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_clustering();
+}
+
+TEST_CASE("Benchmark: CandidateBuilder", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_candidatebuilder();
+}
+
+namespace {
+
+const unsigned nEvents = 1000;
+
+/**
+ * @brief The generator_t struct makes synthetic high-multiplicity events
+ *
+ * Each shower deposits its energy in the central element and
+ * shares some fraction with the neighbours. A fixed seed keeps
+ * the events identical across runs.
+ */
+struct generator_t {
+    std::mt19937 rng{42};
+
+    TClusterHitList MakeHits(const ClusterDetector_t& det, unsigned nShowers) {
+        map<unsigned, TClusterHit> hits;
+        uniform_int_distribution<unsigned> d_channel(0, det.GetNChannels()-1);
+        uniform_real_distribution<double> d_energy(20, 800);
+        uniform_real_distribution<double> d_fraction(0.02, 0.2);
+        normal_distribution<double> d_time(0, 2);
+        for(unsigned i=0;i<nShowers;i++) {
+            const auto central = d_channel(rng);
+            if(det.IsIgnored(central))
+                continue;
+            const auto E = d_energy(rng);
+            const auto t = d_time(rng);
+            auto add_hit = [&hits] (unsigned ch, double e, double t) {
+                auto it = hits.find(ch);
+                if(it == hits.end())
+                    hits.emplace(ch, TClusterHit(ch, e, t));
+                else
+                    it->second.Energy += e;
+            };
+            double E_shared = 0;
+            for(auto neighbour : det.GetClusterElement(central)->Neighbours) {
+                if(det.IsIgnored(neighbour))
+                    continue;
+                const auto e = d_fraction(rng)*E;
+                E_shared += e;
+                add_hit(neighbour, e, t + d_time(rng));
+            }
+            add_hit(central, max(E - E_shared, 0.5*E), t);
+        }
+        TClusterHitList list;
+        list.reserve(hits.size());
+        for(auto& hit : hits)
+            list.emplace_back(move(hit.second));
+        return list;
+    }
+
+    TClusterList MakeVetoClusters(const Detector_t& det, unsigned nHits) {
+        TClusterList clusters;
+        uniform_int_distribution<unsigned> d_channel(0, det.GetNChannels()-1);
+        uniform_real_distribution<double> d_energy(0.5, 5);
+        normal_distribution<double> d_time(0, 2);
+        for(unsigned i=0;i<nHits;i++) {
+            const auto ch = d_channel(rng);
+            if(det.IsIgnored(ch))
+                continue;
+            TClusterHit hit(ch, d_energy(rng), d_time(rng));
+            clusters.emplace_back(det.GetPosition(ch), hit.Energy, hit.Time,
+                                  det.Type, ch, vector<TClusterHit>{hit});
+        }
+        return clusters;
+    }
+};
+
+shared_ptr<ClusterDetector_t> getClusterDetector(Detector_t::Type_t type) {
+    auto det = dynamic_pointer_cast<ClusterDetector_t>(ExpConfig::Setup::GetDetector(type));
+    REQUIRE(det != nullptr);
+    return det;
+}
+
+}
+
+void dobench_clustering() {
+    auto cb = getClusterDetector(Detector_t::Type_t::CB);
+    auto taps = getClusterDetector(Detector_t::Type_t::TAPS);
+
+    generator_t gen;
+    vector<TClusterHitList> hits_cb;
+    vector<TClusterHitList> hits_taps;
+    for(unsigned i=0;i<nEvents;i++) {
+        hits_cb.emplace_back(gen.MakeHits(*cb, 12));
+        hits_taps.emplace_back(gen.MakeHits(*taps, 6));
+    }
+
+    Clustering_NextGen clustering;
+    unsigned nClusters = 0;
+
+    benchmark::Measure("Clustering_NextGen/CB", "events", [&] () {
+        for(const auto& hits : hits_cb) {
+            TClusterList clusters;
+            clustering.Build(*cb, hits, clusters);
+            nClusters += clusters.size();
+        }
+        return nEvents;
+    });
+
+    benchmark::Measure("Clustering_NextGen/TAPS", "events", [&] () {
+        for(const auto& hits : hits_taps) {
+            TClusterList clusters;
+            clustering.Build(*taps, hits, clusters);
+            nClusters += clusters.size();
+        }
+        return nEvents;
+    });
+
+    REQUIRE(nClusters > 0);
+}
+
+void dobench_candidatebuilder() {
+    auto cb = getClusterDetector(Detector_t::Type_t::CB);
+    auto taps = getClusterDetector(Detector_t::Type_t::TAPS);
+    auto pid = ExpConfig::Setup::GetDetector(Detector_t::Type_t::PID);
+    auto tapsveto = ExpConfig::Setup::GetDetector(Detector_t::Type_t::TAPSVeto);
+
+    generator_t gen;
+    vector<TClusterHitList> hits_cb;
+    vector<TClusterHitList> hits_taps;
+    for(unsigned i=0;i<nEvents;i++) {
+        hits_cb.emplace_back(gen.MakeHits(*cb, 12));
+        hits_taps.emplace_back(gen.MakeHits(*taps, 6));
+    }
+
+    Clustering_NextGen clustering;
+    CandidateBuilder candidatebuilder;
+
+    // the candidate builder consumes the clusters,
+    // so they need to be prepared for each repetition
+    vector<CandidateBuilder::sorted_clusters_t> events;
+    auto prepare = [&] () {
+        events.clear();
+        events.resize(nEvents);
+        for(unsigned i=0;i<nEvents;i++) {
+            auto& sorted_clusters = events[i];
+            TClusterList clusters_cb;
+            clustering.Build(*cb, hits_cb[i], clusters_cb);
+            TClusterList clusters_taps;
+            clustering.Build(*taps, hits_taps[i], clusters_taps);
+            sorted_clusters.insert(make_pair(Detector_t::Type_t::CB, move(clusters_cb)));
+            sorted_clusters.insert(make_pair(Detector_t::Type_t::TAPS, move(clusters_taps)));
+            sorted_clusters.insert(make_pair(Detector_t::Type_t::PID, gen.MakeVetoClusters(*pid, 4)));
+            sorted_clusters.insert(make_pair(Detector_t::Type_t::TAPSVeto, gen.MakeVetoClusters(*tapsveto, 3)));
+        }
+    };
+
+    unsigned nCandidates = 0;
+    benchmark::Measure("CandidateBuilder", "events", prepare, [&] () {
+        for(auto& sorted_clusters : events) {
+            TCandidateList candidates;
+            TClusterList all_clusters;
+            candidatebuilder.Build(move(sorted_clusters), candidates, all_clusters);
+            nCandidates += candidates.size();
+        }
+        return nEvents;
+    });
+
+    REQUIRE(nCandidates > 0);
+}
@@ -0,0 +1,91 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+#include "Benchmark.h"
+
+#include "unpacker/Unpacker.h"
+#include "reconstruct/Reconstruct.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include "base/std_ext/memory.h"
+
+#include "TBufferFile.h"
+
+#include <vector>
+#include <memory>
+
+using namespace std;
+using namespace ant;
+
+void dobench_cereal();
+
+TEST_CASE("Benchmark: TEvent cereal round-trip", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_cereal();
+}
+
+void dobench_cereal() {
+    // reconstructed events from the raw blob, including read hits
+    vector<TEvent> events;
+    {
+        auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz");
+        Reconstruct reconstruct;
+        while(auto event = unpacker->NextEvent()) {
+            reconstruct.DoReconstruct(event.Reconstructed());
+            events.emplace_back(move(event));
+        }
+    }
+    REQUIRE_FALSE(events.empty());
+
+    TBufferFile buffer(TBuffer::kWrite);
+    double MB = 0;
+    unsigned nCandidates = 0;
+
+    benchmark::Measure("TEvent/Cereal_RoundTrip", "events", [&] () {
+        for(auto& event : events) {
+            buffer.Reset();
+            buffer.SetWriteMode();
+            event.Streamer(buffer);
+            MB += double(buffer.Length())/(1 << 20);
+
+            buffer.SetReadMode();
+            buffer.SetBufferOffset(0);
+            TEvent event_read;
+            event_read.Streamer(buffer);
+            nCandidates += event_read.Reconstructed().Candidates.size();
+        }
+        return events.size();
+    });
+
+    REQUIRE(nCandidates > 0);
+    REQUIRE(MB > 0);
+
+    // candidate-level reading, everything else stays undecoded
+    vector<unique_ptr<TBufferFile>> buffers;
+    for(auto& event : events) {
+        buffers.emplace_back(std_ext::make_unique<TBufferFile>(TBuffer::kWrite));
+        event.Streamer(*buffers.back());
+        buffers.back()->SetReadMode();
+    }
+
+    for(auto lazy : {false, true}) {
+        using C = TEventData::Collection_t;
+        TEventData::LazyCollections = lazy ?
+                                          ~(C::Candidates | TEventData::collections_t(C::TaggerHits)) :
+                                          TEventData::collections_t();
+        unsigned nCandidates_read = 0;
+        benchmark::Measure(lazy ? "TEvent/Cereal_Read_Lazy" : "TEvent/Cereal_Read", "events", [&] () {
+            for(auto& buffer : buffers) {
+                buffer->SetBufferOffset(0);
+                TEvent event_read;
+                event_read.Streamer(*buffer);
+                nCandidates_read += event_read.Reconstructed().Candidates.size();
+            }
+            return buffers.size();
+        });
+        TEventData::LazyCollections = {};
+        REQUIRE(nCandidates_read > 0);
+    }
+}
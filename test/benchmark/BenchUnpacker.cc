@@ -0,0 +1,63 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+#include "Benchmark.h"
+
+#include "unpacker/Unpacker.h"
+#include "unpacker/RawFileReader.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ant;
+
+void dobench_unpacker(const string& name, const string& filename);
+
+TEST_CASE("Benchmark: Unpacker AcquMk2", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_unpacker("Unpacker/AcquMk2", "Acqu_oneevent-big.dat.xz");
+}
+
+TEST_CASE("Benchmark: Unpacker AcquMk2 scalers", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_unpacker("Unpacker/AcquMk2_Scalers", "Acqu_scalerblock.dat.xz");
+}
+
+TEST_CASE("Benchmark: Unpacker AcquMk1", "[.][benchmark]") {
+    test::EnsureSetup();
+    dobench_unpacker("Unpacker/AcquMk1", "AcquMk1_scalerblock.dat.xz");
+}
+
+double getUncompressedMB(const string& filename) {
+    RawFileReader reader;
+    reader.open(filename);
+    vector<char> buffer(1 << 16);
+    double bytes = 0;
+    while(reader) {
+        reader.read(buffer.data(), buffer.size());
+        bytes += reader.gcount();
+    }
+    return bytes/(1 << 20);
+}
+
+void dobench_unpacker(const string& name, const string& blob) {
+    const auto filename = string(TEST_BLOBS_DIRECTORY)+"/"+blob;
+
+    // the rate refers to the uncompressed size,
+    // but it includes the decompression of the blob
+    const auto MB = getUncompressedMB(filename);
+    REQUIRE(MB > 0);
+
+    unsigned nHits = 0;
+    benchmark::Measure(name, "MB", [filename, MB, &nHits] () {
+        auto unpacker = Unpacker::Get(filename);
+        while(auto event = unpacker->NextEvent())
+            nHits += event.Reconstructed().DetectorReadHits.size();
+        return MB;
+    });
+    REQUIRE(nHits > 0);
+}
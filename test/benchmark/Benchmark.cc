@@ -0,0 +1,108 @@
+#include "Benchmark.h"
+
+#include "base/GitInfo.h"
+#include "base/Logger.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+using namespace ant;
+using namespace ant::benchmark;
+
+namespace {
+
+double getMinTime() {
+    const char* env = getenv("ANT_BENCHMARK_MINTIME");
+    if(env != nullptr) {
+        const double t = atof(env);
+        if(t>0)
+            return t;
+    }
+    return 2.0;
+}
+
+string getOutputFile() {
+    const char* env = getenv("ANT_BENCHMARK_OUTPUT");
+    return env != nullptr ? env : "benchmark_results.jsonl";
+}
+
+const string& getGitDescription() {
+    static const string description = GitInfo().GetDescription();
+    return description;
+}
+
+// benchmark names and units are plain identifiers,
+// but be safe anyway
+string escape_json(const string& s) {
+    string r;
+    for(auto c : s) {
+        if(c == '"' || c == '\\')
+            r += '\\';
+        r += c;
+    }
+    return r;
+}
+
+}
+
+result_t benchmark::Measure(const string& name, const string& unit,
+                            const function<void()>& prepare,
+                            const function<double()>& run)
+{
+    using clock_t = chrono::steady_clock;
+
+    const double min_time = getMinTime();
+    const unsigned min_repetitions = 3;
+
+    // warm-up, fills caches and lazy initializations
+    if(prepare)
+        prepare();
+    run();
+
+    result_t result;
+    result.Name = name;
+    result.Unit = unit;
+
+    while(result.Seconds < min_time || result.Repetitions < min_repetitions) {
+        if(prepare)
+            prepare();
+        const auto start = clock_t::now();
+        result.Items += run();
+        result.Seconds += chrono::duration<double>(clock_t::now() - start).count();
+        result.Repetitions++;
+    }
+
+    Report(result);
+    return result;
+}
+
+void benchmark::Report(const result_t& result)
+{
+    cout << left << setw(40) << result.Name << right
+         << setw(14) << fixed << setprecision(2) << result.Rate()
+         << " " << result.Unit << "/s"
+         << "  (" << result.Repetitions << " repetitions, "
+         << setprecision(3) << result.Seconds << " s)" << endl;
+
+    const auto filename = getOutputFile();
+    ofstream out(filename, ios::app);
+    if(!out) {
+        LOG(WARNING) << "Cannot write benchmark results to " << filename;
+        return;
+    }
+    out << setprecision(9)
+        << "{\"benchmark\":\"" << escape_json(result.Name) << "\""
+        << ",\"unit\":\"" << escape_json(result.Unit) << "\""
+        << ",\"rate\":" << result.Rate()
+        << ",\"items\":" << result.Items
+        << ",\"seconds\":" << result.Seconds
+        << ",\"repetitions\":" << result.Repetitions
+        << ",\"timestamp\":" << time(nullptr)
+        << ",\"git\":\"" << escape_json(getGitDescription()) << "\""
+        << "}\n";
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <functional>
+#include <string>
+
+namespace ant {
+namespace benchmark {
+
+/**
+ * @brief The result_t struct holds the outcome of one benchmark
+ *
+ * Items are counted in the given unit (events, MB, fits, ...),
+ * the rate is items per second of timed execution.
+ */
+struct result_t {
+    std::string Name;
+    std::string Unit;
+    double   Items = 0;
+    double   Seconds = 0;
+    unsigned Repetitions = 0;
+
+    double Rate() const { return Seconds>0 ? Items/Seconds : 0; }
+};
+
+/**
+ * @brief Measure runs the benchmark until a minimum time is reached
+ * @param name unique name of the benchmark, used to compare across commits
+ * @param unit what the returned items count
+ * @param prepare called before each repetition, not timed (may be empty)
+ * @param run timed part, returns number of processed items
+ * @return the result, which is also reported by Report()
+ *
+ * One additional warm-up repetition is run before timing.
+ * The minimum time in seconds can be set with the environment variable ANT_BENCHMARK_MINTIME.
+ */
+result_t Measure(const std::string& name, const std::string& unit,
+                 const std::function<void()>& prepare,
+                 const std::function<double()>& run);
+
+inline result_t Measure(const std::string& name, const std::string& unit,
+                        const std::function<double()>& run) {
+    return Measure(name, unit, nullptr, run);
+}
+
+/**
+ * @brief Report prints the result and appends it as one JSON object per line
+ *
+ * The file is given by environment variable ANT_BENCHMARK_OUTPUT,
+ * defaulting to benchmark_results.jsonl in the working directory.
+ * Each line also contains the git description of the source tree.
+ */
+void Report(const result_t& result);
+
+}} // namespace ant::benchmark
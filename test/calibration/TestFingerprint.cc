@@ -0,0 +1,91 @@
+#include "catch.hpp"
+
+#include "Fingerprint.h"
+#include "DataManager.h"
+
+#include "tree/TCalibrationData.h"
+
+#include "base/tmpfile_t.h"
+
+using namespace std;
+using namespace ant;
+using namespace ant::calibration;
+
+void dotest_values();
+void dotest_calibrationdata();
+
+TEST_CASE("Fingerprint: Values", "[calibration]") {
+    dotest_values();
+}
+
+TEST_CASE("Fingerprint: Calibration data", "[calibration]") {
+    dotest_calibrationdata();
+}
+
+Fingerprint::value_t hash_strings(const string& a, const string& b) {
+    Fingerprint hash;
+    hash.add(a);
+    hash.add(b);
+    return hash.Value;
+}
+
+void dotest_values() {
+    REQUIRE(hash_strings("ab", "c") == hash_strings("ab", "c"));
+    REQUIRE(hash_strings("ab", "c") != hash_strings("c", "ab"));
+    // strings are prefixed with their size
+    REQUIRE(hash_strings("ab", "c") != hash_strings("a", "bc"));
+
+    Fingerprint hash1;
+    hash1.add(TID(0, 1u));
+    Fingerprint hash2;
+    hash2.add(TID(0, 2u));
+    REQUIRE(hash1.Value != hash2.Value);
+    hash2.Value = Fingerprint().Value;
+    hash2.add(TID(0, 1u));
+    REQUIRE(hash1.Value == hash2.Value);
+}
+
+TCalibrationData make_cdata(unsigned first, unsigned last, double value) {
+    TCalibrationData cdata("1", TID(0, first), TID(0, last));
+    cdata.TimeStamp = 0;
+    cdata.Data.emplace_back(0, value);
+    return cdata;
+}
+
+Fingerprint::value_t hash_range(const DataManager& calmgr, unsigned first, unsigned last) {
+    Fingerprint hash;
+    hash.add(calmgr, "1", TID(0, first), TID(0, last));
+    return hash.Value;
+}
+
+void dotest_calibrationdata() {
+    tmpfolder_t tmp;
+    DataManager calmgr(tmp.foldername);
+
+    const auto empty = hash_range(calmgr, 0, 20);
+
+    calmgr.Add(make_cdata(5, 7, 1.0));
+    const auto fingerprint = hash_range(calmgr, 0, 20);
+    REQUIRE(fingerprint != empty);
+    // same data, same fingerprint
+    REQUIRE(hash_range(calmgr, 0, 20) == fingerprint);
+
+    // data after the range does not change it
+    calmgr.Add(make_cdata(100, 110, 1.0));
+    REQUIRE(hash_range(calmgr, 0, 20) == fingerprint);
+    REQUIRE(hash_range(calmgr, 0, 200) != hash_range(calmgr, 0, 20));
+
+    // data within the range does
+    calmgr.Add(make_cdata(10, 12, 1.0));
+    REQUIRE(hash_range(calmgr, 0, 20) != fingerprint);
+    // but not a range ending before that data
+    REQUIRE(hash_range(calmgr, 0, 8) == hash_range(calmgr, 0, 9));
+
+    // also the values are covered
+    tmpfolder_t tmp_other;
+    DataManager calmgr_other(tmp_other.foldername);
+    calmgr_other.Add(make_cdata(5, 7, 2.0));
+    calmgr_other.Add(make_cdata(100, 110, 1.0));
+    calmgr_other.Add(make_cdata(10, 12, 1.0));
+    REQUIRE(hash_range(calmgr_other, 0, 20) != hash_range(calmgr, 0, 20));
+}
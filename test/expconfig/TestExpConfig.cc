@@ -3,10 +3,16 @@
 #include "expconfig_helpers.h"
 
 #include "unpacker/Unpacker.h"
+#include "reconstruct/Reconstruct.h"
 #include "expconfig/ExpConfig.h"
 
 #include "expconfig/detectors/CB.h"
 
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include "base/interval.h"
+
 #include <iostream>
 
 using namespace ant;
@@ -15,6 +21,9 @@ using namespace std;
 void getdetector();
 void getlastfound();
 void getall();
+void taggerchanneltable();
+void setupcontext();
+void createsetup();
 
 TEST_CASE("ExpConfig Get (all)", "[expconfig]") {
     getall();
@@ -25,6 +34,18 @@ TEST_CASE("ExpConfig GetDetector", "[expconfig]") {
     getdetector();
 }
 
+TEST_CASE("ExpConfig tagger channel table", "[expconfig]") {
+    taggerchanneltable();
+}
+
+TEST_CASE("ExpConfig explicit setup context", "[expconfig]") {
+    setupcontext();
+}
+
+TEST_CASE("ExpConfig create setup", "[expconfig]") {
+    createsetup();
+}
+
 void getall() {
     auto setupnames = ExpConfig::Setup::GetNames();
     for(auto setupname : setupnames) {
@@ -48,3 +69,104 @@ void getdetector() {
     REQUIRE_THROWS_AS(ExpConfig::Setup::GetDetector(Detector_t::Type_t::Tagger), ExpConfig::Exception);
 }
 
+
+void taggerchanneltable() {
+    for(auto setupname : ExpConfig::Setup::GetNames()) {
+        ExpConfig::Setup::SetByName(setupname);
+        shared_ptr<TaggerDetector_t> tagger;
+        try {
+            tagger = ExpConfig::Setup::GetDetector<TaggerDetector_t>();
+        }
+        catch(ExpConfig::ExceptionNoDetector) {
+            continue;
+        }
+        INFO(setupname);
+
+        const auto& table = tagger->GetChannelTable();
+        REQUIRE(table.PhotonEnergies.size() == tagger->GetNChannels());
+        REQUIRE(table.SortedChannels.size() == tagger->GetNChannels());
+        for(unsigned ch=0;ch<tagger->GetNChannels();ch++) {
+            REQUIRE(table.PhotonEnergies[ch] == tagger->GetPhotonEnergy(ch));
+            REQUIRE(table.PhotonEnergyWidths[ch] == tagger->GetPhotonEnergyWidth(ch));
+        }
+
+        // compare binary search with plain linear search
+        auto linear = [tagger] (double photonEnergy, unsigned& channel) {
+            for(channel=0;channel<tagger->GetNChannels();++channel) {
+                if(interval<double>::CenterWidth(tagger->GetPhotonEnergy(channel),
+                                                 tagger->GetPhotonEnergyWidth(channel)).Contains(photonEnergy))
+                    return true;
+            }
+            return false;
+        };
+
+        const auto& low = table.SortedLowEdges;
+        const double start = low.front() - 10;
+        const double stop  = low.back() + table.MaxWidth + 10;
+        for(double e=start; e<stop; e += 0.173) {
+            unsigned ch_linear = 0, ch_search = 0;
+            const bool found = linear(e, ch_linear);
+            REQUIRE(tagger->TryGetChannelFromPhoton(e, ch_search) == found);
+            if(found)
+                REQUIRE(ch_search == ch_linear);
+        }
+        // channel centers must be found
+        for(unsigned ch=0;ch<tagger->GetNChannels();ch++) {
+            unsigned ch_search = 0;
+            REQUIRE(tagger->TryGetChannelFromPhoton(table.PhotonEnergies[ch], ch_search));
+        }
+    }
+}
+
+void setupcontext() {
+    test::EnsureSetup();
+    const auto setup = ExpConfig::Setup::GetShared();
+    REQUIRE(setup.get() == addressof(ExpConfig::Setup::Get()));
+
+    // nothing is set anymore, but the context keeps the setup
+    ExpConfig::Setup::Cleanup();
+    REQUIRE_THROWS_AS(ExpConfig::Setup::Get(), ExpConfig::ExceptionNoSetup);
+
+    auto cb = ExpConfig::Setup::GetDetector<expconfig::detector::CB>(*setup);
+    REQUIRE(cb->GetNChannels() == 720);
+    REQUIRE(ExpConfig::Setup::GetDetector(*setup, Detector_t::Type_t::CB) == cb);
+
+    auto unpacker = Unpacker::Get(string(TEST_BLOBS_DIRECTORY)+"/Acqu_oneevent-big.dat.xz", setup);
+    REQUIRE(unpacker->GetSetup() == setup);
+
+    Reconstruct reconstruct(setup);
+    unsigned nReadHits = 0;
+    while(auto event = unpacker->NextEvent()) {
+        auto& recon = event.Reconstructed();
+        nReadHits += recon.DetectorReadHits.size();
+        REQUIRE_NOTHROW(reconstruct.DoReconstruct(recon));
+    }
+    REQUIRE(nReadHits > 0);
+
+    // still no setup set by the unpacker or reconstruct
+    REQUIRE_THROWS_AS(ExpConfig::Setup::Get(), ExpConfig::ExceptionNoSetup);
+}
+
+void createsetup() {
+    const auto setupnames = ExpConfig::Setup::GetNames();
+    REQUIRE_FALSE(setupnames.empty());
+    const auto& setupname = setupnames.front();
+
+    ExpConfig::Setup::SetByName(setupname);
+    const auto registered = ExpConfig::Setup::GetShared();
+    REQUIRE(registered == ExpConfig::Setup::FindByName(setupname));
+
+    // a created setup is a new instance each time, not the one of the registry
+    const auto created = ExpConfig::Setup::Create(setupname, make_shared<OptionsList>());
+    REQUIRE(created != nullptr);
+    REQUIRE(created != registered);
+    REQUIRE(created->GetName() == registered->GetName());
+    REQUIRE(ExpConfig::Setup::Create(setupname, make_shared<OptionsList>()) != created);
+    REQUIRE(ExpConfig::Setup::GetShared() == registered);
+
+    // reconstruct refuses to work without setup
+    const Reconstruct::setup_t nosetup;
+    REQUIRE_THROWS_AS(Reconstruct{nosetup}, ExpConfig::ExceptionNoSetup);
+
+    ExpConfig::Setup::Cleanup();
+}
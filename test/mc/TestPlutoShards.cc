@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include "mc/pluto/utils/PlutoShards.h"
+
+#include "base/tmpfile_t.h"
+#include "base/std_ext/system.h"
+
+#include <fstream>
+#include <set>
+#include <algorithm>
+
+using namespace std;
+using namespace ant;
+using namespace ant::mc::pluto::utils;
+
+void dotest_seeds();
+void dotest_makeshards();
+void dotest_cleanup();
+
+TEST_CASE("PlutoShards: Seeds", "[mc]") {
+    dotest_seeds();
+}
+
+TEST_CASE("PlutoShards: MakeShards", "[mc]") {
+    dotest_makeshards();
+}
+
+TEST_CASE("PlutoShards: Cleanup on failure", "[mc]") {
+    dotest_cleanup();
+}
+
+void dotest_seeds() {
+    // reproducible for the same master seed
+    CHECK(PlutoShards::GetSeed(42, 3) == PlutoShards::GetSeed(42, 3));
+    CHECK(PlutoShards::GetSeed(42, 3, 1) == PlutoShards::GetSeed(42, 3, 1));
+
+    // unique and never zero over shards, streams and neighbouring master seeds
+    set<unsigned> seeds;
+    unsigned n = 0;
+    for(uint64_t masterSeed : {0ULL, 1ULL, 2ULL, 42ULL}) {
+        for(unsigned shard=0;shard<64;shard++) {
+            for(unsigned stream=0;stream<3;stream++) {
+                const auto seed = PlutoShards::GetSeed(masterSeed, shard, stream);
+                REQUIRE(seed != 0);
+                seeds.insert(seed);
+                n++;
+            }
+        }
+    }
+    CHECK(seeds.size() == n);
+}
+
+void dotest_makeshards() {
+    REQUIRE_THROWS_AS(PlutoShards::MakeShards(0, 42, 100, "out.root"), PlutoShards::Exception);
+
+    for(unsigned long nEvents : {0UL, 5UL, 100UL, 1001UL}) {
+        const unsigned nShards = 7;
+        const auto shards = PlutoShards::MakeShards(nShards, 42, nEvents, "out.root");
+        REQUIRE(shards.size() == nShards);
+
+        unsigned long sum = 0;
+        set<unsigned> seeds;
+        set<string> filenames;
+        for(unsigned i=0;i<nShards;i++) {
+            const auto& shard = shards[i];
+            CHECK(shard.Index == i);
+            CHECK(shard.Seed == PlutoShards::GetSeed(42, i));
+            sum += shard.nEvents;
+            seeds.insert(shard.Seed);
+            filenames.insert(shard.Filename);
+        }
+        CHECK(sum == nEvents);
+        CHECK(seeds.size() == nShards);
+        CHECK(filenames.size() == nShards);
+
+        // as evenly as possible
+        auto minmax = minmax_element(shards.begin(), shards.end(),
+                                     [] (const PlutoShards::shard_t& a, const PlutoShards::shard_t& b) {
+            return a.nEvents < b.nEvents;
+        });
+        CHECK(minmax.second->nEvents - minmax.first->nEvents <= 1);
+    }
+
+    CHECK(PlutoShards::MakeShards(2, 42, 10, "out.root").front().Filename == "out.shard000.root");
+}
+
+void dotest_cleanup() {
+    tmpfolder_t folder;
+    const string outfile = folder.foldername+"/out.root";
+    const auto shards = PlutoShards::MakeShards(3, 42, 30, outfile);
+
+    auto write_shard = [] (const PlutoShards::shard_t& shard) {
+        ofstream(shard.Filename) << "not a ROOT file";
+    };
+    auto all_removed = [&shards] () {
+        return none_of(shards.begin(), shards.end(), [] (const PlutoShards::shard_t& shard) {
+            return std_ext::system::testopen(shard.Filename);
+        });
+    };
+
+    // one failing worker removes all shard files
+    REQUIRE_THROWS_AS(PlutoShards::Run(shards, [write_shard] (const PlutoShards::shard_t& shard) {
+        write_shard(shard);
+        if(shard.Index == 1)
+            throw PlutoShards::Exception("Failing on purpose");
+    }), PlutoShards::Exception);
+    CHECK(all_removed());
+
+    // merging non-ROOT files fails, and neither the shards nor the output are left behind
+    PlutoShards::Run(shards, write_shard);
+    REQUIRE_FALSE(all_removed());
+    REQUIRE_THROWS_AS(PlutoShards::Merge(shards, outfile), PlutoShards::Exception);
+    CHECK(all_removed());
+    CHECK_FALSE(std_ext::system::testopen(outfile));
+}
@@ -0,0 +1,110 @@
+#include "catch.hpp"
+#include "expconfig_helpers.h"
+
+#include "detail/RunCache.h"
+
+#include "calibration/DataManager.h"
+#include "expconfig/ExpConfig.h"
+#include "tree/TAntHeader.h"
+#include "tree/TCalibrationData.h"
+
+#include "base/tmpfile_t.h"
+#include "base/WrapTFile.h"
+
+#include "TH1D.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace std;
+using namespace ant;
+using namespace ant::progs;
+
+void dotest_runcache();
+
+TEST_CASE("RunCache: Restore and invalidate", "[progs]") {
+    test::EnsureSetup();
+    dotest_runcache();
+}
+
+// the cache is disabled for a dirty working copy of Ant,
+// which is common while developing and does not matter here
+struct RunCache_test : RunCache {
+    using RunCache::RunCache;
+    void Enable() { enabled = true; }
+};
+
+void make_output(const string& filename, const interval<TID>& tidRange) {
+    WrapTFileOutput outputfile(filename);
+    TAntHeader header;
+    header.SetupName = ExpConfig::Setup::Get().GetName();
+    header.FirstID = tidRange.Start();
+    header.LastID = tidRange.Stop();
+    outputfile.WriteObject(addressof(header), "AntHeader");
+    outputfile.CreateInside<TH1D>("h", "", 10, 0, 1)->Fill(0.5);
+}
+
+string read_file(const string& filename) {
+    ifstream file(filename, ios::binary);
+    stringstream ss;
+    ss << file.rdbuf();
+    return ss.str();
+}
+
+void add_cdata(unsigned first, unsigned last) {
+    TCalibrationData cdata("RunCache_test", TID(0, first), TID(0, last));
+    cdata.Data.emplace_back(0, 1.0);
+    ExpConfig::Setup::Get().GetCalibrationDataManager()->Add(cdata);
+}
+
+void dotest_runcache() {
+    tmpfolder_t tmp;
+    // must not be interpreted by some shell when created
+    const string folder = tmp.foldername + "/run cache's";
+
+    tmpfile_t input(tmp, ".dat");
+    input.write_testdata();
+
+    const interval<TID> tidRange(TID(0, 0u), TID(0, 10u));
+    add_cdata(5, 7);
+
+    tmpfile_t output(tmp, ".root");
+    make_output(output.filename, tidRange);
+    tmpfile_t restored(tmp, ".root");
+
+    RunCache_test runcache(folder, {input.filename}, {"physics=Test"});
+    runcache.Enable();
+
+    // key miss
+    REQUIRE_FALSE(runcache.Restore(restored.filename));
+
+    REQUIRE_NOTHROW(runcache.Store(output.filename, tidRange));
+
+    // key hit
+    REQUIRE(runcache.Restore(restored.filename));
+    REQUIRE(read_file(restored.filename) == read_file(output.filename));
+
+    // other arguments give another key
+    RunCache_test runcache_other(folder, {input.filename}, {"physics=Other"});
+    runcache_other.Enable();
+    REQUIRE_FALSE(runcache_other.Restore(restored.filename));
+
+    // calibration data after the processed range does not matter
+    add_cdata(100, 110);
+    REQUIRE(runcache.Restore(restored.filename));
+
+    // but within the range it invalidates the cached output
+    add_cdata(8, 9);
+    REQUIRE_FALSE(runcache.Restore(restored.filename));
+
+    // until the run is processed again
+    REQUIRE_NOTHROW(runcache.Store(output.filename, tidRange));
+    REQUIRE(runcache.Restore(restored.filename));
+
+    // a changed input gives another key
+    input.testdata = {1, 2, 3};
+    input.write_testdata();
+    RunCache_test runcache_changed(folder, {input.filename}, {"physics=Test"});
+    runcache_changed.Enable();
+    REQUIRE_FALSE(runcache_changed.Restore(restored.filename));
+}
@@ -109,7 +109,7 @@ struct ReconstructTester : Reconstruct {
 
         // apply hooks which modify clusters
         for(const auto& hook : hooks_clusters) {
-            hook->ApplyTo(sorted_clusters);
+            hook->ApplyTo(sorted_clusters, reconstructed.ID);
         }
 
         // do the candidate building
@@ -0,0 +1,150 @@
+#include "catch.hpp"
+
+#include "tree/MemoryArchive.h"
+#include "tree/stream_TBuffer.h"
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include "TBufferFile.h"
+
+#include "cereal/archives/binary.hpp"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ant;
+
+void dotest_compatible();
+void dotest_tbuffer();
+void dotest_packed();
+
+TEST_CASE("MemoryArchive: Compatible with BinaryArchive", "[tree]") {
+    dotest_compatible();
+}
+
+TEST_CASE("MemoryArchive: Stream TBuffer", "[tree]") {
+    dotest_tbuffer();
+}
+
+TEST_CASE("MemoryArchive: Packed vectors", "[tree]") {
+    dotest_packed();
+}
+
+TEvent make_event(unsigned nHits) {
+    TEvent event(TID(10), TID(10));
+    auto& recon = event.Reconstructed();
+    for(unsigned ch=0;ch<nHits;ch++) {
+        recon.DetectorReadHits.emplace_back(
+                    LogicalChannel_t{Detector_t::Type_t::CB, Channel_t::Type_t::Integral, ch},
+                    vector<uint8_t>{1, 2, uint8_t(ch)});
+        recon.DetectorReadHits.back().Values.emplace_back(ch);
+    }
+    recon.TaggerHits.emplace_back(3, 1.5, 2.5);
+    recon.Clusters.emplace_back(vec3(1,2,3),
+                                100, 0.5,
+                                Detector_t::Type_t::CB,
+                                127, // central element
+                                vector<TClusterHit>{TClusterHit(), TClusterHit()}
+                                );
+    recon.Candidates.emplace_back(
+                Detector_t::Any_t::CB_Apparatus,
+                200,
+                0.0, 0.0, 0.0, // theta/phi/time
+                2, // cluster size
+                2.0, 0.0, // veto/tracker
+                TClusterList{recon.Clusters.begin()}
+                );
+    auto particle = make_shared<TParticle>(ParticleTypeDatabase::Pi0, LorentzVec({3,4,5},6));
+    event.MCTrue().ParticleTree = Tree<TParticlePtr>::MakeNode(particle);
+    return event;
+}
+
+void dotest_compatible() {
+    const auto event = make_event(20);
+
+    ostringstream s;
+    {
+        cereal::BinaryOutputArchive ar(s);
+        ar(event);
+    }
+
+    string blob;
+    {
+        MemoryOutputArchive ar(blob);
+        ar(event);
+    }
+    REQUIRE(blob == s.str());
+
+    // read back what the BinaryArchive wrote
+    TEvent readback;
+    {
+        const string expected = s.str();
+        MemoryInputArchive ar(expected.data(), expected.data()+expected.size());
+        ar(readback);
+    }
+    auto& recon = readback.Reconstructed();
+    REQUIRE(recon.ID == TID(10));
+    REQUIRE(recon.DetectorReadHits.size() == 20);
+    REQUIRE(recon.DetectorReadHits.back().Values.front().Calibrated == 19);
+    REQUIRE(recon.TaggerHits.size() == 1);
+    REQUIRE(recon.Candidates.size() == 1);
+    REQUIRE(recon.Candidates.front().Clusters.get_ptr_at(0) == recon.Clusters.get_ptr_at(0));
+    REQUIRE(readback.MCTrue().ParticleTree != nullptr);
+
+    // truncated input throws instead of reading beyond the end
+    {
+        MemoryInputArchive ar(blob.data(), blob.data()+blob.size()/2);
+        TEvent truncated;
+        REQUIRE_THROWS_AS(ar(truncated), cereal::Exception);
+    }
+}
+
+void dotest_tbuffer() {
+    // start small to make the archive grow the TBuffer
+    TBufferFile buffer(TBuffer::kWrite, 16);
+    for(unsigned nHits : {1, 500, 5}) {
+        auto event = make_event(nHits);
+        event.Streamer(buffer);
+    }
+
+    buffer.SetReadMode();
+    buffer.SetBufferOffset(0);
+    // events are read back one after another
+    for(unsigned nHits : {1, 500, 5}) {
+        TEvent event;
+        event.Streamer(buffer);
+        REQUIRE(event.Reconstructed().DetectorReadHits.size() == nHits);
+        REQUIRE(event.MCTrue().ParticleTree != nullptr);
+    }
+}
+
+void dotest_packed() {
+    vector<TDetectorReadHit::Value_t> values;
+    for(unsigned i=0;i<100;i++) {
+        values.emplace_back(i);
+        values.back().Calibrated = 2*i;
+    }
+
+    ostringstream s;
+    {
+        cereal::BinaryOutputArchive ar(s);
+        ar(values);
+    }
+    string blob;
+    {
+        MemoryOutputArchive ar(blob);
+        ar(values);
+    }
+    REQUIRE(blob == s.str());
+
+    vector<TDetectorReadHit::Value_t> readback;
+    {
+        MemoryInputArchive ar(blob.data(), blob.data()+blob.size());
+        ar(readback);
+    }
+    REQUIRE(readback.size() == values.size());
+    REQUIRE(readback.back().Uncalibrated == 99);
+    REQUIRE(readback.back().Calibrated == 198);
+}
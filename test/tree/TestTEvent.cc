@@ -2,6 +2,7 @@
 
 #include "tree/TEvent.h"
 #include "tree/TEventData.h"
+#include "tree/stream_TBuffer.h"
 
 #include "base/tmpfile_t.h"
 #include "base/std_ext/memory.h"
@@ -10,6 +11,7 @@
 
 #include "TFile.h"
 #include "TTree.h"
+#include "TBufferFile.h"
 
 #include <iostream>
 
@@ -17,11 +19,16 @@ using namespace std;
 using namespace ant;
 
 void dotest();
+void dotest_v5();
 
 TEST_CASE("TEvent: Write/Read TTree", "[tree]") {
     dotest();
 }
 
+TEST_CASE("TEvent: Read version 5", "[tree]") {
+    dotest_v5();
+}
+
 void dotest() {
     tmpfile_t tmpfile;
 
@@ -147,6 +154,8 @@ void dotest() {
         REQUIRE(readback.ParticleTree->Get()->Type() == particle2->Type());
         REQUIRE(readback.ParticleTree->Get()->Type() == ParticleTypeDatabase::Pi0);
         REQUIRE(readback.ParticleTree->Daughters().size() == 2);
+        // the particles refer to the read candidates, not to copies of them
+        REQUIRE(readback.ParticleTree->Daughters().back()->Get()->Candidate == readback.Candidates.get_ptr_at(0));
 
 
         // check some list capabilities
@@ -166,7 +175,127 @@ void dotest() {
                     [] (const TCandidate& c) { return c.Detector & Detector_t::Type_t::TAPS; } );
         REQUIRE(taps_cands.size() == 1);
 
+        // lazy collections are only decoded on request
+        using C = TEventData::Collection_t;
+        TEventData::LazyCollections = C::DetectorReadHits | TEventData::collections_t(C::SlowControls);
+        t.Tree->GetEntry(0);
+        TEventData::LazyCollections = {};
+
+        auto& lazy = t.Event().Reconstructed();
+        REQUIRE(lazy.ID == TID(10));
+        REQUIRE(lazy.Candidates.size() == 2);
+        REQUIRE(lazy.Clusters.get_ptr_at(0) == lazy.Candidates.at(0).Clusters.get_ptr_at(1));
+        REQUIRE_FALSE(lazy.IsDecoded(C::DetectorReadHits));
+        REQUIRE_FALSE(lazy.IsDecoded(C::SlowControls));
+        REQUIRE(lazy.DetectorReadHits.empty());
+        REQUIRE(lazy.ParticleTree != nullptr);
+
+        // undecoded collections are written back unchanged
+        TBufferFile buffer(TBuffer::kWrite);
+        t.Event().Streamer(buffer);
+        buffer.SetReadMode();
+        buffer.SetBufferOffset(0);
+        TEvent copy;
+        copy.Streamer(buffer);
+        REQUIRE(copy.Reconstructed().DetectorReadHits.size() == 3);
+
+        // filling an undecoded collection would lose the changes
+        lazy.DetectorReadHits.emplace_back();
+        TBufferFile buffer_modified(TBuffer::kWrite);
+        REQUIRE_THROWS_AS(t.Event().Streamer(buffer_modified), TEventData::ExceptionUndecoded);
+        REQUIRE_THROWS_AS(lazy.Decode(), TEventData::ExceptionUndecoded);
+        lazy.DetectorReadHits.clear();
+
+        lazy.Decode(C::DetectorReadHits);
+        REQUIRE(lazy.IsDecoded(C::DetectorReadHits));
+        REQUIRE_FALSE(lazy.IsDecoded(C::SlowControls));
+        REQUIRE(lazy.DetectorReadHits.size() == 3);
+        lazy.Decode();
+        REQUIRE(lazy.IsDecoded(C::SlowControls));
+
+        REQUIRE(TEventData::GetCollections("DetectorReadHits,Candidates") ==
+                (C::DetectorReadHits | TEventData::collections_t(C::Candidates)));
+        REQUIRE_THROWS_AS(TEventData::GetCollections("Nonsense"), std::runtime_error);
+    }
+
+}
+
+// tell cereal to use the correct TParticle load/save due to inheritance from LorentzVec
+namespace cereal
+{
+  template <class Archive>
+  struct specialize<Archive, TParticle, cereal::specialization::member_load_save> {};
+}
+
+namespace {
+// layout of TEvent version 5, which had all collections in one archive
+struct TEventData_v5 {
+    TEventData& d;
+    template<class Archive>
+    void serialize(Archive& archive) {
+        archive(d.ID,
+                d.DetectorReadHits, d.SlowControls, d.UnpackerMessages,
+                d.TaggerHits, d.Trigger, d.Target,
+                d.Clusters, d.Candidates, d.ParticleTree);
+    }
+};
+struct TEvent_v5 {
+    TEventData_v5 Reconstructed;
+    bool SavedForSlowControls;
+    template<class Archive>
+    void serialize(Archive& archive, const std::uint32_t) {
+        // unique_ptr's valid flag, no MCTrue
+        const std::uint8_t valid = 1;
+        const std::uint8_t invalid = 0;
+        archive(valid, Reconstructed, invalid, SavedForSlowControls);
+    }
+};
+}
+
+CEREAL_CLASS_VERSION(TEvent_v5, 5)
+
+void dotest_v5() {
+    TEventData data(TID(42));
+    data.DetectorReadHits.emplace_back();
+    data.DetectorReadHits.emplace_back();
+    data.Clusters.emplace_back(vec3(1,2,3),
+                               100, 0.5,
+                               Detector_t::Type_t::CB,
+                               127, // central element
+                               vector<TClusterHit>{TClusterHit()}
+                               );
+    data.Candidates.emplace_back(
+                Detector_t::Any_t::CB_Apparatus,
+                200,
+                0.0, 0.0, 0.0, // theta/phi/time
+                1, // cluster size
+                2.0, 0.0, // veto/tracker
+                TClusterList{data.Clusters.begin()}
+                );
+    auto particle = make_shared<TParticle>(ParticleTypeDatabase::Photon, data.Candidates.begin().get_ptr());
+    data.ParticleTree = Tree<TParticlePtr>::MakeNode(particle);
+
+    string blob;
+    {
+        MemoryOutputArchive ar(blob);
+        ar(TEvent_v5{TEventData_v5{data}, true});
+    }
 
+    TEvent event;
+    {
+        MemoryInputArchive ar(blob.data(), blob.data()+blob.size());
+        ar(event);
     }
 
+    REQUIRE(event.SavedForSlowControls);
+    const auto& readback = event.Reconstructed();
+    REQUIRE(readback.ID == TID(42));
+    REQUIRE(readback.DetectorReadHits.size() == 2);
+    REQUIRE(readback.Clusters.size() == 1);
+    REQUIRE(readback.Candidates.size() == 1);
+    REQUIRE(readback.Clusters.get_ptr_at(0) == readback.Candidates.at(0).Clusters.get_ptr_at(0));
+    REQUIRE(readback.ParticleTree != nullptr);
+    REQUIRE(readback.ParticleTree->Get()->Candidate == readback.Candidates.get_ptr_at(0));
+    for(unsigned i=0;i<TEventData::NCollections;i++)
+        REQUIRE(readback.IsDecoded(static_cast<TEventData::Collection_t>(i)));
 }
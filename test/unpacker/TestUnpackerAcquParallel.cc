@@ -0,0 +1,119 @@
+#include "catch.hpp"
+#include "catch_config.h"
+#include "expconfig_helpers.h"
+
+#include "Unpacker.h"
+#include "UnpackerAcqu.h"
+#include "RawFileReader.h"
+
+#include "tree/TEvent.h"
+#include "tree/TEventData.h"
+
+#include "base/tmpfile_t.h"
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace ant;
+
+void dotest(const string& filename);
+void dotest_discarded();
+
+TEST_CASE("Test UnpackerAcqu: Parallel Mk2", "[unpacker]") {
+    dotest(string(TEST_BLOBS_DIRECTORY)+"/Acqu_scalerblock.dat.xz");
+}
+
+TEST_CASE("Test UnpackerAcqu: Parallel Mk1", "[unpacker]") {
+    dotest(string(TEST_BLOBS_DIRECTORY)+"/AcquMk1_problematic.dat.gz");
+}
+
+TEST_CASE("Test UnpackerAcqu: Parallel with discarded buffers", "[unpacker]") {
+    dotest_discarded();
+}
+
+vector<TEvent> unpack(const string& filename, unsigned nThreads) {
+    UnpackerAcqu::DecoderThreads = nThreads;
+    auto unpacker = Unpacker::Get(filename);
+    vector<TEvent> events;
+    while(auto event = unpacker->NextEvent())
+        events.emplace_back(move(event));
+    UnpackerAcqu::DecoderThreads = 0;
+    return events;
+}
+
+void dotest(const string& filename) {
+    test::EnsureSetup();
+
+    const auto expected = unpack(filename, 0);
+    REQUIRE(!expected.empty());
+
+    for(unsigned nThreads : {1, 3}) {
+        const auto events = unpack(filename, nThreads);
+        REQUIRE(events.size() == expected.size());
+
+        for(size_t i=0;i<events.size();i++) {
+            auto& recon = events[i].Reconstructed();
+            auto& expected_recon = expected[i].Reconstructed();
+            REQUIRE(recon.ID == expected_recon.ID);
+            REQUIRE(recon.Trigger.DAQEventID == expected_recon.Trigger.DAQEventID);
+            REQUIRE(recon.DetectorReadHits.size() == expected_recon.DetectorReadHits.size());
+            REQUIRE(recon.SlowControls.size() == expected_recon.SlowControls.size());
+            REQUIRE(recon.UnpackerMessages.size() == expected_recon.UnpackerMessages.size());
+            for(size_t j=0;j<recon.UnpackerMessages.size();j++)
+                REQUIRE(recon.UnpackerMessages[j].Message == expected_recon.UnpackerMessages[j].Message);
+        }
+    }
+}
+
+unsigned count_discarded(const vector<TEvent>& events) {
+    unsigned n = 0;
+    for(const auto& event : events) {
+        for(const auto& m : event.Reconstructed().UnpackerMessages)
+            if(m.Level == TUnpackerMessage::Level_t::DataDiscard)
+                n++;
+    }
+    return n;
+}
+
+void dotest_discarded() {
+    test::EnsureSetup();
+
+    // the Mk1 file has a header and three data buffers,
+    // the second one is discarded
+    const string filename = string(TEST_BLOBS_DIRECTORY)+"/AcquMk1_problematic.dat.gz";
+    REQUIRE(count_discarded(unpack(filename, 0)) == 1);
+
+    const size_t recordLength = 0x8000/sizeof(uint32_t);
+    vector<uint32_t> words(4*recordLength);
+    {
+        RawFileReader reader;
+        REQUIRE_NOTHROW(reader.open(filename));
+        REQUIRE_NOTHROW(reader.read(words.data(), words.size()));
+    }
+
+    // let the last event of the first data buffer run into the end of the buffer,
+    // so that this buffer is discarded after some AcquIDs were read
+    const auto it_buffer = next(words.begin(), recordLength);
+    const auto it_buffer_end = next(it_buffer, recordLength);
+    REQUIRE(*it_buffer == 0x20202020); // Mk1 data buffer marker
+    const uint32_t endMarker = 0xffffffff; // end of event, directly followed by end of buffer
+    const auto it_end = adjacent_find(next(it_buffer), it_buffer_end, [endMarker] (uint32_t a, uint32_t b) {
+        return a == endMarker && b == endMarker;
+    });
+    REQUIRE(it_end != it_buffer_end);
+    fill(it_end, it_buffer_end, 0);
+
+    tmpfolder_t folder;
+    tmpfile_t tmpfile(folder, ".dat");
+    {
+        ofstream file(tmpfile.filename, ios::binary);
+        file.write(reinterpret_cast<const char*>(words.data()), words.size()*sizeof(uint32_t));
+        REQUIRE(file);
+    }
+
+    REQUIRE(count_discarded(unpack(tmpfile.filename, 0)) == 2);
+    dotest(tmpfile.filename);
+}